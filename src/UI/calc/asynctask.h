@@ -0,0 +1,69 @@
+#ifndef ASYNCTASK_H
+#define ASYNCTASK_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QtConcurrent>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Runs calculations on the global thread pool and delivers only the
+ * result of the latest request back to the GUI thread.
+ *
+ * Every request gets a generation number and a cancellation flag. Starting a
+ * new request cancels the previous one, and a result whose generation is not
+ * the current one is dropped, so a stale result never overwrites a newer one.
+ */
+class AsyncTask {
+ public:
+  using CancelToken = std::shared_ptr<std::atomic_bool>;
+
+  AsyncTask() = default;
+  AsyncTask(const AsyncTask &) = delete;
+  AsyncTask &operator=(const AsyncTask &) = delete;
+  ~AsyncTask() { Cancel(); }
+
+  /**
+   * Starts calc(token) on a worker thread and calls apply(result) in the
+   * context object's thread once it finishes, unless it became stale.
+   *
+   * @param context object owning the request, usually the window
+   * @param calc calculation, should check the token between heavy steps
+   * @param apply handler of the result, runs on the GUI thread
+   */
+  template <typename Calc, typename Apply>
+  void Run(QObject *context, Calc calc, Apply apply) {
+    Cancel();
+    CancelToken token = std::make_shared<std::atomic_bool>(false);
+    cancelToken = token;
+    const quint64 requestGeneration = generation;
+
+    using Result = decltype(calc(token));
+    auto *watcher = new QFutureWatcher<Result>(context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, context,
+                     [this, watcher, token, requestGeneration, apply]() {
+                       if (requestGeneration == generation && !token->load()) {
+                         apply(watcher->result());
+                       }
+                       watcher->deleteLater();
+                     });
+    watcher->setFuture(
+        QtConcurrent::run([calc, token]() { return calc(token); }));
+  }
+
+  /**
+   * Cancels the running request, its result will not be delivered.
+   */
+  void Cancel() {
+    if (cancelToken) cancelToken->store(true);
+    cancelToken.reset();
+    ++generation;
+  }
+
+ private:
+  quint64 generation = 0;
+  CancelToken cancelToken;
+};
+
+#endif  // ASYNCTASK_H
@@ -6,8 +6,7 @@
 
 #include "creditcalc.h"
 
-#include <QDate>
-#include <QStandardItemModel>
+#include <QHeaderView>
 
 #include "ui_creditcalc.h"
 
@@ -21,8 +20,12 @@
  * @throws N/A
  */
 CreditCalc::CreditCalc(QWidget *parent)
-    : QWidget(parent), ui(new Ui::CreditCalc) {
+    : QWidget(parent, Qt::Window),
+      ui(new Ui::CreditCalc),
+      scheduleModel(new ScheduleModel(this)) {
   ui->setupUi(this);
+  ui->tableView->setModel(scheduleModel);
+  ui->tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
   connect(ui->execButton, SIGNAL(released()), this, SLOT(ExecPressed()));
 }
 
@@ -48,34 +51,23 @@ bool CreditCalc::ValidateParam(QString param) {
  * various payment fields.
  */
 void CreditCalc::CleanFields() {
-  ui->tableWidget->clear();
+  scheduleModel->Clear();
   ui->month_payment->clear();
   ui->overpayment->clear();
   ui->totalPayment->clear();
 }
 /**
- * Initializes the difference table for credit calculation.
+ * Initializes the difference table for credit calculation. The table view
+ * formats only the rows it shows, so long schedules open instantly.
  *
- * @param data the credit data
- * @param intTerm the integer term
+ * @param schedule the credit schedule, ownership goes to the table model
  *
  * @return void
  *
  * @throws None
  */
-void CreditCalc::InitDiffTable(credit_data data, int intTerm) {
-  ui->tableWidget->setColumnCount(2);
-  ui->tableWidget->setRowCount(intTerm);
-  ui->tableWidget->setHorizontalHeaderLabels(QStringList() << "Дата"
-                                                           << "Сумма платежа");
-  for (int i = 0; i < intTerm; ++i) {
-    QTableWidgetItem *item = new QTableWidgetItem(
-        QString::number((double)data.diff_mouths_payment[i], 'f', 2));
-    ui->tableWidget->setItem(i, 1, item);
-    QTableWidgetItem *data = new QTableWidgetItem(
-        QDate::currentDate().addMonths(i).toString("dd.MM.yyyy"));
-    ui->tableWidget->setItem(i, 0, data);
-  }
+void CreditCalc::InitDiffTable(credit_schedule *schedule) {
+  scheduleModel->SetSchedule(schedule);
 }
 
 /**
@@ -101,15 +93,17 @@ void CreditCalc::AnnuitType(credit_data data) {
  * Calculate and display different types of credit payments.
  *
  * @param data credit data containing overpayment, total payment, and terms
+ * @param intTerm the term the data was calculated for
+ * @param schedule the payment schedule for the table
  *
  * @return void
  *
  * @throws None
  */
-void CreditCalc::DiffType(credit_data data) {
+void CreditCalc::DiffType(credit_data data, int intTerm,
+                          credit_schedule *schedule) {
   double dblOverPayment = data.overpayment;
   double dblTotalPayment = data.total_payment;
-  int intTerm = ui->term->text().toInt();
 
   ui->month_payment->setText(
       "От " + QString::number((double)data.diff_mouths_payment[0], 'f', 2) +
@@ -118,11 +112,14 @@ void CreditCalc::DiffType(credit_data data) {
       " RUB");
   ui->overpayment->setText(QString::number(dblOverPayment, 'f', 2) + " RUB");
   ui->totalPayment->setText(QString::number(dblTotalPayment, 'f', 2) + " RUB");
-  InitDiffTable(data, intTerm);
+  InitDiffTable(schedule);
 }
 
 /**
  * Executes the CreditCalc function, cleaning fields and validating parameters.
+ * The calculation runs on a worker thread and only the result of the latest
+ * press is shown. A press that was superseded while it waited for a free
+ * thread is not calculated at all.
  *
  * @param None
  *
@@ -134,21 +131,33 @@ void CreditCalc::ExecPressed() {
   CleanFields();
   if (ValidateParam(ui->amount->text()) && ValidateParam(ui->term->text()) &&
       ValidateParam(ui->rate->text())) {
-    credit_data data = {0};
-    data = s21_credit_calc(
-        ui->amount->text().toDouble(), ui->term->text().toDouble(),
-        ui->rate->text().toDouble(), ui->type->currentIndex());
+    double amount = ui->amount->text().toDouble();
+    double term = ui->term->text().toDouble();
+    double rate = ui->rate->text().toDouble();
+    int type = ui->type->currentIndex();
+    int intTerm = ui->term->text().toInt();
 
-    if (data.total_payment != CREDIT_ERROR) {
-      if (ui->type->currentIndex() == 0) {
-        AnnuitType(data);
-      } else if (ui->type->currentIndex() == 1) {
-        DiffType(data);
-      }
-    } else {
-      ui->totalPayment->setText("Некорректные данные");
-    }
+    calcTask.Run(
+        this,
+        [amount, term, rate, type](const AsyncTask::CancelToken &token) {
+          credit_data data = {};
+          if (!token->load()) data = s21_credit_calc(amount, term, rate, type);
+          return data;
+        },
+        [this, amount, rate, type, intTerm](credit_data data) {
+          if (data.total_payment != CREDIT_ERROR) {
+            if (type == 0) {
+              AnnuitType(data);
+            } else if (type == 1) {
+              DiffType(data, intTerm,
+                       s21_create_schedule(amount, intTerm, rate, 1));
+            }
+          } else {
+            ui->totalPayment->setText("Некорректные данные");
+          }
+        });
   } else {
+    calcTask.Cancel();
     ui->totalPayment->setText("Некорректные данные");
   }
 }
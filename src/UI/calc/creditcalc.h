@@ -3,6 +3,9 @@
 
 #include <QWidget>
 
+#include "asynctask.h"
+#include "schedulemodel.h"
+
 #define CREDIT_ERROR -335
 extern "C" {
 #include "../../calc_logic/bank_calc/include/s21_credit_calc.h"
@@ -21,12 +24,14 @@ class CreditCalc : public QWidget {
 
  private:
   Ui::CreditCalc *ui;
+  AsyncTask calcTask;
+  ScheduleModel *scheduleModel;
 
  private slots:
   void ExecPressed();
   void AnnuitType(credit_data data);
-  void DiffType(credit_data data);
-  void InitDiffTable(credit_data data, int intTerm);
+  void DiffType(credit_data data, int intTerm, credit_schedule *schedule);
+  void InitDiffTable(credit_schedule *schedule);
   void CleanFields();
   bool ValidateParam(QString param);
 };
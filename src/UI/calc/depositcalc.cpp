@@ -15,7 +15,7 @@
  *
  */
 DepositCalc::DepositCalc(QWidget *parent)
-    : QWidget(parent), ui(new Ui::DepositCalc) {
+    : QWidget(parent, Qt::Window), ui(new Ui::DepositCalc) {
   ui->setupUi(this);
   connect(ui->execButton, SIGNAL(released()), this, SLOT(ExecPressed()));
 }
@@ -130,11 +130,14 @@ void DepositCalc::Output(deposit_data data) {
 }
 
 /**
- * Function to handle the button press event for deposit calculation.
+ * Function to handle the button press event for deposit calculation. The
+ * calculation runs on a worker thread and only the result of the latest press
+ * is shown. A press that was superseded while it waited for a free thread is
+ * not calculated at all.
  */
 void DepositCalc::ExecPressed() {
   ClearFields();
-  deposit_data res = {0};
+  calcTask.Cancel();
   if (FieldsValidation()) {
     double replen = GetReplen();
     double withdraw = GetWithdraw();
@@ -142,17 +145,29 @@ void DepositCalc::ExecPressed() {
       ui->DepOutput->setText("Неккоректные данные");
     } else {
       int cap_percent = ui->cap_percent->isChecked();
-      res = s21_deposit_calc((double)ui->amount->text().toDouble(),
-                             (double)ui->term->text().toDouble(),
-                             (double)ui->rate->text().toDouble(),
-                             (double)ui->tax->text().toDouble(),
-                             (double)ui->frequency->text().toDouble(), replen,
-                             withdraw, cap_percent);
-      if (res.dep_total != DEPOSIT_ERROR) {
-        Output(res);
-      } else {
-        ui->DepOutput->setText("Неккоректные данные");
-      }
+      double amount = ui->amount->text().toDouble();
+      double term = ui->term->text().toDouble();
+      double rate = ui->rate->text().toDouble();
+      double tax = ui->tax->text().toDouble();
+      double frequency = ui->frequency->text().toDouble();
+
+      calcTask.Run(
+          this,
+          [=](const AsyncTask::CancelToken &token) {
+            deposit_data data = {};
+            if (!token->load()) {
+              data = s21_deposit_calc(amount, term, rate, tax, frequency,
+                                      replen, withdraw, cap_percent);
+            }
+            return data;
+          },
+          [this](deposit_data res) {
+            if (res.dep_total != DEPOSIT_ERROR) {
+              Output(res);
+            } else {
+              ui->DepOutput->setText("Неккоректные данные");
+            }
+          });
     }
   } else {
     ui->DepOutput->setText("Неккоректные данные");
@@ -3,6 +3,8 @@
 
 #include <QWidget>
 
+#include "asynctask.h"
+
 extern "C" {
 #include "../../calc_logic/bank_calc/include/s21_deposit_calc.h"
 }
@@ -20,6 +22,7 @@ class DepositCalc : public QWidget {
 
  private:
   Ui::DepositCalc *ui;
+  AsyncTask calcTask;
 
  private slots:
   void ExecPressed();
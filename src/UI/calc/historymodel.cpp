@@ -0,0 +1,82 @@
+/**
+ * @file historymodel.cpp
+ * @brief Contains the implementation of the HistoryModel class for the
+ * calculation history list.
+ */
+
+#include "historymodel.h"
+
+#include <QDateTime>
+
+/**
+ * Constructor for HistoryModel class.
+ *
+ * @param history the history to show, owned by the caller
+ * @param parent pointer to the parent object
+ */
+HistoryModel::HistoryModel(calc_history *history, QObject *parent)
+    : QAbstractListModel(parent), history(history) {}
+
+/**
+ * Replaces the shown records with the newest ones matching the query.
+ *
+ * @param query the text to search for, empty for all records
+ * @param mode HISTORY_SUBSTRING or HISTORY_PREFIX
+ *
+ * @return void
+ *
+ * @throws None
+ */
+void HistoryModel::Search(const QString &query, int mode) {
+  std::string cppQuery(query.toStdString());
+  beginResetModel();
+  ids.resize(MAX_RESULTS);
+  ids.resize(s21_history_search(history, cppQuery.c_str(), mode, ids.data(),
+                                ids.size()));
+  endResetModel();
+}
+
+/**
+ * Returns the expression of a shown record.
+ *
+ * @param index the row of the record
+ *
+ * @return the expression or an empty string
+ */
+QString HistoryModel::Expression(const QModelIndex &index) const {
+  QString res;
+  history_entry entry = {0, 0, nullptr, 0};
+  if (index.isValid() && (size_t)index.row() < ids.size() &&
+      s21_history_get(history, ids[index.row()], &entry) == HISTORY_OK) {
+    res = QString::fromUtf8(entry.expr, (int)entry.length);
+  }
+  return res;
+}
+
+int HistoryModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : (int)ids.size();
+}
+
+/**
+ * Reads and formats a single record on request of the view.
+ *
+ * @param index the row of the record
+ * @param role the requested role
+ *
+ * @return the record for the display role, empty value otherwise
+ *
+ * @throws None
+ */
+QVariant HistoryModel::data(const QModelIndex &index, int role) const {
+  QVariant res;
+  history_entry entry = {0, 0, nullptr, 0};
+  if (role == Qt::DisplayRole && index.isValid() &&
+      (size_t)index.row() < ids.size() &&
+      s21_history_get(history, ids[index.row()], &entry) == HISTORY_OK) {
+    QDateTime date = QDateTime::fromSecsSinceEpoch(entry.timestamp);
+    res = QString::fromUtf8(entry.expr, (int)entry.length) + " = " +
+          QString::number(entry.result, 'f', 7) + "  (" +
+          date.toString("dd.MM.yyyy hh:mm") + ")";
+  }
+  return res;
+}
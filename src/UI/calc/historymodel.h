@@ -0,0 +1,36 @@
+#ifndef HISTORYMODEL_H
+#define HISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <vector>
+
+extern "C" {
+#include "../../calc_logic/io/include/s21_history.h"
+}
+
+/**
+ * @brief List model over the found records of the calculation history. Only
+ * record numbers are stored, the records are read from the mapping and
+ * formatted in data().
+ */
+class HistoryModel : public QAbstractListModel {
+  Q_OBJECT
+
+ public:
+  explicit HistoryModel(calc_history *history, QObject *parent = nullptr);
+
+  void Search(const QString &query, int mode);
+  QString Expression(const QModelIndex &index) const;
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+
+ private:
+  static constexpr size_t MAX_RESULTS = 1000;
+
+  calc_history *history;
+  std::vector<size_t> ids;
+};
+
+#endif  // HISTORYMODEL_H
@@ -0,0 +1,61 @@
+/**
+ * @file historywindow.cpp
+ * @brief Contains the implementation of the HistoryWindow class for the
+ * calculation history.
+ */
+
+#include "historywindow.h"
+
+#include "ui_historywindow.h"
+
+/**
+ * Constructor for the HistoryWindow class.
+ *
+ * @param history the history to search, owned by the caller
+ * @param parent the parent widget
+ */
+HistoryWindow::HistoryWindow(calc_history *history, QWidget *parent)
+    : QWidget(parent, Qt::Window),
+      ui(new Ui::HistoryWindow),
+      model(new HistoryModel(history, this)) {
+  ui->setupUi(this);
+  ui->results->setModel(model);
+  ui->results->setUniformItemSizes(true);
+  connect(ui->search, SIGNAL(textChanged(QString)), this,
+          SLOT(SearchChanged()));
+  connect(ui->mode, SIGNAL(currentIndexChanged(int)), this,
+          SLOT(SearchChanged()));
+  connect(ui->results, SIGNAL(activated(QModelIndex)), this,
+          SLOT(ItemActivated(QModelIndex)));
+}
+
+HistoryWindow::~HistoryWindow() { delete ui; }
+
+/**
+ * Searches the history on every change of the query, the index makes it fast
+ * enough to keep up with typing.
+ */
+void HistoryWindow::SearchChanged() {
+  int mode = ui->mode->currentIndex() == 0 ? HISTORY_SUBSTRING : HISTORY_PREFIX;
+  model->Search(ui->search->text(), mode);
+}
+
+/**
+ * Repeats the search every time the window is shown, so the calculations made
+ * while it was hidden are listed too.
+ *
+ * @param event the show event
+ */
+void HistoryWindow::showEvent(QShowEvent *event) {
+  SearchChanged();
+  QWidget::showEvent(event);
+}
+
+/**
+ * Puts the chosen expression back into the calculator.
+ *
+ * @param index the chosen record
+ */
+void HistoryWindow::ItemActivated(const QModelIndex &index) {
+  emit Recalled(model->Expression(index));
+}
@@ -0,0 +1,34 @@
+#ifndef HISTORYWINDOW_H
+#define HISTORYWINDOW_H
+
+#include <QWidget>
+
+#include "historymodel.h"
+
+namespace Ui {
+class HistoryWindow;
+}
+
+class HistoryWindow : public QWidget {
+  Q_OBJECT
+
+ public:
+  explicit HistoryWindow(calc_history *history, QWidget *parent = nullptr);
+  ~HistoryWindow();
+
+ signals:
+  void Recalled(const QString &expr);
+
+ protected:
+  void showEvent(QShowEvent *event) override;
+
+ private:
+  Ui::HistoryWindow *ui;
+  HistoryModel *model;
+
+ private slots:
+  void SearchChanged();
+  void ItemActivated(const QModelIndex &index);
+};
+
+#endif  // HISTORYWINDOW_H
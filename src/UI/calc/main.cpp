@@ -1,10 +1,54 @@
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <cstdio>
+#include <cstring>
 
 #include "mainwindow.h"
 
+/**
+ * @brief Reports the time from the start of main() to the first painted frame
+ * of the main window, enabled with --startup-timing.
+ */
+class StartupTimer : public QObject {
+ public:
+  explicit StartupTimer(QObject *parent = nullptr) : QObject(parent) {
+    timer.start();
+  }
+
+  void WindowCreated() { created = timer.nsecsElapsed(); }
+
+ protected:
+  bool eventFilter(QObject *watched, QEvent *event) override {
+    if (event->type() == QEvent::Paint) {
+      watched->removeEventFilter(this);
+      QTimer::singleShot(0, this, [this]() {
+        std::fprintf(stderr,
+                     "startup: main window %.2f ms, first frame %.2f ms\n",
+                     created / 1e6, timer.nsecsElapsed() / 1e6);
+      });
+    }
+    return QObject::eventFilter(watched, event);
+  }
+
+ private:
+  QElapsedTimer timer;
+  qint64 created = 0;
+};
+
 int main(int argc, char *argv[]) {
+  StartupTimer *startup = nullptr;
+  for (int i = 1; i < argc && !startup; ++i) {
+    if (!std::strcmp(argv[i], "--startup-timing")) startup = new StartupTimer;
+  }
+
   QApplication a(argc, argv);
   MainWindow w;
+  if (startup) {
+    startup->setParent(&a);
+    startup->WindowCreated();
+    w.installEventFilter(startup);
+  }
   w.show();
   return a.exec();
 }
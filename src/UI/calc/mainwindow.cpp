@@ -5,12 +5,20 @@
 
 #include "mainwindow.h"
 
+#include <QDir>
+#include <QKeyEvent>
+#include <QStandardPaths>
+#include <ctime>
+#include <utility>
+
 #include "./ui_mainwindow.h"
 extern "C" {
 #include "../../calc_logic/s21_calc.h"
 }
 #include "creditcalc.h"
 #include "depositcalc.h"
+#include "historywindow.h"
+#include "plotwindow.h"
 
 QString(expression);
 
@@ -24,42 +32,50 @@ QString(expression);
  * @throws None
  */
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), ui(new Ui::MainWindow) {
+    : QMainWindow(parent),
+      ui(new Ui::MainWindow),
+      liveCalc(s21_create_live_calc()) {
   ui->setupUi(this);
   ui->display->setText("0");
-  QPushButton *numButtons[11] = {0};
-  for (int i = 0; i < 11; ++i) {
-    QString buttonName = "Button" + QString::number(i);
-    numButtons[i] = MainWindow::findChild<QPushButton *>(buttonName);
-    connect(numButtons[i], SIGNAL(released()), this, SLOT(NumPressed()));
+  QPushButton *const numButtons[] = {
+      ui->Button0, ui->Button1, ui->Button2, ui->Button3,
+      ui->Button4, ui->Button5, ui->Button6, ui->Button7,
+      ui->Button8, ui->Button9, ui->Button10};
+  for (QPushButton *button : numButtons) {
+    connect(button, &QPushButton::released, this, &MainWindow::NumPressed);
+  }
+  QPushButton *const operButtons[] = {
+      ui->plus,         ui->minus,         ui->div,  ui->mult, ui->power,
+      ui->left_bracket, ui->right_bracket, ui->cos,  ui->sin,  ui->tan,
+      ui->acos,         ui->asin,          ui->atan, ui->mod,  ui->sqrt,
+      ui->log,          ui->ln,            ui->comma};
+  for (QPushButton *button : operButtons) {
+    connect(button, &QPushButton::released, this, &MainWindow::OperPressed);
   }
-  connect(ui->plus, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->minus, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->div, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->mult, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->power, SIGNAL(released()), this, SLOT(OperPressed()));
 
-  connect(ui->left_bracket, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->right_bracket, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->cos, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->sin, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->tan, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->acos, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->asin, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->atan, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->mod, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->sqrt, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->log, SIGNAL(released()), this, SLOT(OperPressed()));
-  connect(ui->ln, SIGNAL(released()), this, SLOT(OperPressed()));
+  connect(ui->result, &QPushButton::released, this, &MainWindow::EqualButton);
+  connect(ui->clear, &QPushButton::released, this, &MainWindow::CancelPressed);
 
-  connect(ui->result, SIGNAL(released()), this, SLOT(EqualButton()));
-  connect(ui->clear, SIGNAL(released()), this, SLOT(CancelPressed()));
+  connect(ui->menuCredit, &QAction::triggered, this,
+          &MainWindow::CreditPressed);
+  connect(ui->menuDeposit, &QAction::triggered, this,
+          &MainWindow::DepositPressed);
+  connect(ui->menuPlot, &QAction::triggered, this, &MainWindow::PlotPressed);
+  connect(ui->menuHistory, &QAction::triggered, this,
+          &MainWindow::HistoryPressed);
 
-  connect(ui->menuCredit, SIGNAL(triggered()), this, SLOT(CreditPressed()));
-  connect(ui->menuDeposit, SIGNAL(triggered()), this, SLOT(DepositPressed()));
+  QString dir =
+      QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+  QDir().mkpath(dir);
+  std::string path((dir + "/history.s21h").toStdString());
+  s21_history_open(path.c_str(), &history);
 }
 
-MainWindow::~MainWindow() { delete ui; }
+MainWindow::~MainWindow() {
+  s21_clear_live_calc(liveCalc);
+  s21_history_close(&history);
+  delete ui;
+}
 
 /**
  * Handles the button press event and updates the display accordingly.
@@ -72,14 +88,7 @@ MainWindow::~MainWindow() { delete ui; }
  */
 void MainWindow::NumPressed() {
   QPushButton *button = (QPushButton *)sender();
-  QString buttonValue = button->text();
-  if (expression.size() == 0) {
-    ui->display->setText(buttonValue);
-    expression.append(buttonValue);
-  } else {
-    expression.append(buttonValue);
-    ui->display->setText(expression);
-  }
+  AppendText(button->text());
 }
 
 /**
@@ -87,13 +96,81 @@ void MainWindow::NumPressed() {
  */
 void MainWindow::OperPressed() {
   QPushButton *button = (QPushButton *)sender();
-  expression.append(button->text().toLower());
+  AppendText(button->text().toLower());
+}
+
+/**
+ * Appends text to the expression and updates the live preview. The live
+ * expression parses only the appended characters, not the whole expression.
+ *
+ * @param text the text to append
+ *
+ * @return void
+ *
+ * @throws None
+ */
+void MainWindow::AppendText(const QString &text) {
+  std::string cppText(text.toStdString());
+  expression.append(text);
+  s21_live_append(liveCalc, cppText.c_str());
   ui->display->setText(expression);
+  UpdatePreview();
+}
+
+/**
+ * Removes the last character of the expression, the live expression rewinds
+ * to the checkpoint saved before it.
+ */
+void MainWindow::BackspacePressed() {
+  if (expression.size()) {
+    if (expression.size() <= LIVE_MAX_LEN) s21_live_backspace(liveCalc);
+    expression.chop(1);
+    ui->display->setText(expression);
+    UpdatePreview();
+  }
+}
+
+/**
+ * Shows the result of the expression typed so far in the status bar, or
+ * nothing while it is incomplete or invalid.
+ */
+void MainWindow::UpdatePreview() {
+  long double res = 0;
+  if (expression.size() > LIVE_MAX_LEN ||
+      s21_live_result(liveCalc, &res) != VALID_OK) {
+    ui->statusbar->clearMessage();
+  } else {
+    ui->statusbar->showMessage("= " + QString::number((double)res, 'f', 7));
+  }
+}
+
+/**
+ * Handles typing the expression from the keyboard: Backspace removes the last
+ * character, Enter calculates, and characters of expressions, including the
+ * commas and spaces of sum(), integral() or solve(), are appended.
+ *
+ * @param event the key event
+ */
+void MainWindow::keyPressEvent(QKeyEvent *event) {
+  QString text = event->text().toLower();
+  if (event->key() == Qt::Key_Backspace) {
+    BackspacePressed();
+  } else if (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter) {
+    EqualButton();
+  } else if (text.size() == 1 &&
+             QString("0123456789.,+-*/^() abcdefghijklmnopqrstuvwxyz")
+                 .contains(text)) {
+    AppendText(text);
+  } else {
+    QMainWindow::keyPressEvent(event);
+  }
 }
 
 /**
  * The EqualButton function processes the input expression and displays the
- * result on the UI.
+ * result on the UI. The expression is evaluated on a worker thread, so the
+ * window keeps repainting while it runs, and a long series stops as soon as
+ * a newer calculation or the clear button cancels it.
  *
  * @param None
  *
@@ -102,61 +179,126 @@ void MainWindow::OperPressed() {
  * @throws None
  */
 void MainWindow::EqualButton() {
-  long double res = 0.0;
   std::string cppExpr(expression.toStdString());
+  expression.clear();
+  s21_live_reset(liveCalc);
+  ui->statusbar->clearMessage();
   if (cppExpr.length() > 255) {
-    ValidationError(1569325044);
-  } else {
-    res = s21_smart_calc(cppExpr.c_str());
-    if (res == 1569325041 || res == 1569325042 || res == 1569325043) {
-      ValidationError(res);
-    } else {
-      ui->display->setText(QString::number((double)res, 'f', 7));
-    }
+    calcTask.Cancel();
+    ValidationError(STR_OVERFLOW);
+    return;
   }
-  expression.clear();
+
+  calcTask.Run(
+      this,
+      [cppExpr](const AsyncTask::CancelToken &token) {
+        std::pair<int, long double> res(VALID_OK, 0);
+        res.first =
+            s21_calc_eval_cancel(cppExpr.c_str(), token.get(), &res.second);
+        return res;
+      },
+      [this, cppExpr](std::pair<int, long double> res) {
+        if (res.first != VALID_OK) {
+          ValidationError(res.first);
+        } else {
+          ui->display->setText(QString::number((double)res.second, 'f', 7));
+          s21_history_append(&history, cppExpr.c_str(), (double)res.second,
+                             time(nullptr));
+        }
+      });
 }
 
 /**
  * Function to handle the cancel button press in the MainWindow.
  */
 void MainWindow::CancelPressed() {
+  calcTask.Cancel();
   expression.clear();
+  s21_live_reset(liveCalc);
+  ui->statusbar->clearMessage();
   ui->display->setText("");
 }
 
 /**
  * Handle validation errors and display appropriate error message on the UI.
  *
- * @param res the code representing the specific validation error
+ * @param status the code representing the specific validation error
  *
  * @return void
  *
  * @throws None
  */
-void MainWindow::ValidationError(long double res) {
+void MainWindow::ValidationError(int status) {
   QString error;
-  if (res == 1569325041) error = "BRACKETS DO NOT MATCH";
-  if (res == 1569325042) error = "INVALID EXPRESSION";
-  if (res == 1569325043) error = "UNKNOWN FUNC";
-  if (res == 1569325044) error = "CHARACTER LIMIT REACHED (max 255)";
+  if (status == BRACKETS_NOT_MATCH) error = "BRACKETS DO NOT MATCH";
+  if (status == INVALID_EXPRESSION) error = "INVALID EXPRESSION";
+  if (status == UNKNOWN_FUNC) error = "UNKNOWN FUNC";
+  if (status == STR_OVERFLOW) error = "CHARACTER LIMIT REACHED (max 255)";
   ui->display->setText(error);
 }
 
 /**
- * CreditPressed function creates a new CreditCalc object and shows the credit
- * window.
+ * Shows a tool window, bringing it to the front if it is already open. Tool
+ * windows are children of the main window, so they are freed with it.
+ *
+ * @param window the window to show
+ */
+void MainWindow::ShowToolWindow(QWidget *window) {
+  window->show();
+  window->raise();
+  window->activateWindow();
+}
+
+/**
+ * CreditPressed function shows the credit window. It is created on the first
+ * use and reused afterwards.
  */
 void MainWindow::CreditPressed() {
-  CreditCalc *creditWindow = new CreditCalc;
-  creditWindow->show();
+  if (!creditWindow) creditWindow = new CreditCalc(this);
+  ShowToolWindow(creditWindow);
 }
 
 /**
- * DepositPressed function creates a new DepositCalc object and shows the
- * deposit window.
+ * DepositPressed function shows the deposit window. It is created on the
+ * first use and reused afterwards.
  */
 void MainWindow::DepositPressed() {
-  DepositCalc *depositWindow = new DepositCalc;
-  depositWindow->show();
+  if (!depositWindow) depositWindow = new DepositCalc(this);
+  ShowToolWindow(depositWindow);
+}
+
+/**
+ * PlotPressed function shows the graph window with the entered expression.
+ * It is created on the first use and reused afterwards, so its tile cache
+ * survives closing the window.
+ */
+void MainWindow::PlotPressed() {
+  if (!plotWindow) plotWindow = new PlotWindow(this);
+  ShowToolWindow(plotWindow);
+  if (expression.size()) plotWindow->SetExpression(expression);
+}
+
+/**
+ * HistoryPressed function shows the saved calculations. The window is created
+ * on the first use and reused afterwards.
+ */
+void MainWindow::HistoryPressed() {
+  if (!historyWindow) {
+    historyWindow = new HistoryWindow(&history, this);
+    connect(historyWindow, &HistoryWindow::Recalled, this,
+            &MainWindow::HistoryRecalled);
+  }
+  ShowToolWindow(historyWindow);
+}
+
+/**
+ * Replaces the expression with the one chosen in the history.
+ *
+ * @param expr the chosen expression
+ */
+void MainWindow::HistoryRecalled(const QString &expr) {
+  calcTask.Cancel();
+  expression.clear();
+  s21_live_reset(liveCalc);
+  AppendText(expr);
 }
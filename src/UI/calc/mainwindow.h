@@ -3,6 +3,18 @@
 
 #include <QMainWindow>
 
+#include "asynctask.h"
+
+extern "C" {
+#include "../../calc_logic/io/include/s21_history.h"
+#include "../../calc_logic/live/include/s21_live_calc.h"
+}
+
+class CreditCalc;
+class DepositCalc;
+class PlotWindow;
+class HistoryWindow;
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class MainWindow;
@@ -18,14 +30,32 @@ class MainWindow : public QMainWindow {
 
  private:
   Ui::MainWindow *ui;
+  AsyncTask calcTask;
+  live_calc *liveCalc;
+  calc_history history;
+  CreditCalc *creditWindow = nullptr;
+  DepositCalc *depositWindow = nullptr;
+  PlotWindow *plotWindow = nullptr;
+  HistoryWindow *historyWindow = nullptr;
+
+  void AppendText(const QString &text);
+  void UpdatePreview();
+  void ShowToolWindow(QWidget *window);
+
+ protected:
+  void keyPressEvent(QKeyEvent *event) override;
 
  private slots:
   void NumPressed();
   void OperPressed();
+  void BackspacePressed();
   void EqualButton();
   void CancelPressed();
-  void ValidationError(long double res);
+  void ValidationError(int status);
   void CreditPressed();
   void DepositPressed();
+  void PlotPressed();
+  void HistoryPressed();
+  void HistoryRecalled(const QString &expr);
 };
 #endif  // MAINWINDOW_H
@@ -0,0 +1,262 @@
+/**
+ * @file plotwidget.cpp
+ * @brief Contains the implementation of the PlotWidget class for function
+ * graphs.
+ */
+
+#include "plotwidget.h"
+
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <cmath>
+
+#define ZOOM_STEP 1.25
+#define MAX_VISIBLE_TILES 256
+#define TILE_FALLBACK_LEVELS 4
+
+/**
+ * Constructor for the PlotWidget class.
+ *
+ * @param parent the parent widget
+ */
+PlotWidget::PlotWidget(QWidget *parent) : QWidget(parent) {
+  setMinimumSize(200, 200);
+  s21_tile_cache_init(&cache, PLOT_TILE_CACHE_BYTES);
+  sampleTimer.setSingleShot(true);
+  connect(&sampleTimer, SIGNAL(timeout()), this, SLOT(Sample()));
+}
+
+PlotWidget::~PlotWidget() {
+  sampleTask.Cancel();
+  s21_clear_tile_cache(&cache);
+}
+
+/**
+ * Compiles the expression and starts drawing it.
+ *
+ * @param expr expression of the variable x
+ *
+ * @return VALID_OK or the validation error code, the previous graph is kept
+ * on error
+ *
+ * @throws None
+ */
+int PlotWidget::SetExpression(const QString &expr) {
+  std::string cppExpr(expr.toStdString());
+  compiled_expr parsed = {0};
+  int res = s21_compile_expr(cppExpr.c_str(), &parsed);
+  if (res == VALID_OK) {
+    compiled = CompiledPtr(new compiled_expr(parsed), [](compiled_expr *ptr) {
+      s21_clear_compiled(ptr);
+      delete ptr;
+    });
+    sampleTask.Cancel();
+    sampling = false;
+    resample = false;
+    s21_tile_cache_reset(&cache);
+    sampleTimer.start(0);
+    update();
+  }
+  return res;
+}
+
+/**
+ * Samples the visible tiles that are not cached yet on a worker thread. The
+ * timer coalesces bursts of wheel and mouse events, and while a sampling runs
+ * the next one waits for it instead of throwing its tiles away.
+ */
+void PlotWidget::Sample() {
+  if (!compiled) return;
+  if (sampling) {
+    resample = true;
+    return;
+  }
+
+  plot_tile_key keys[MAX_VISIBLE_TILES];
+  size_t count = s21_plot_tile_keys(view, keys, MAX_VISIBLE_TILES);
+  QVector<plot_tile_key> missing;
+  for (size_t i = 0; i < count; ++i) {
+    if (!s21_tile_cache_get(&cache, keys[i])) missing.append(keys[i]);
+  }
+  if (missing.isEmpty()) return;
+
+  CompiledPtr expr = compiled;
+  sampling = true;
+  sampleTask.Run(
+      this,
+      [expr, missing](const AsyncTask::CancelToken &token) {
+        Tiles res;
+        for (int i = 0; i < missing.size() && !token->load(); ++i) {
+          SamplesPtr samples(new plot_samples(), [](plot_samples *ptr) {
+            s21_clear_plot_samples(ptr);
+            delete ptr;
+          });
+          if (s21_plot_tile(expr.get(), missing[i], samples.get()) ==
+              PLOT_OK) {
+            res.append(qMakePair(missing[i], samples));
+          }
+        }
+        return res;
+      },
+      [this](Tiles res) { StoreTiles(res); });
+}
+
+/**
+ * Moves sampled tiles into the cache and starts the sampling that waited for
+ * them, if any.
+ *
+ * @param tiles the sampled tiles
+ */
+void PlotWidget::StoreTiles(const Tiles &tiles) {
+  for (const auto &tile : tiles) {
+    s21_tile_cache_put(&cache, tile.first, tile.second.get());
+  }
+  sampling = false;
+  update();
+  if (resample) {
+    resample = false;
+    Sample();
+  }
+}
+
+/**
+ * Looks up a tile, falling back to the coarser levels covering it while it is
+ * being sampled.
+ *
+ * @param key the tile
+ * @param found output for the tile that was found
+ *
+ * @return points of the found tile or nullptr
+ */
+const plot_samples *PlotWidget::FindTile(plot_tile_key key,
+                                         plot_tile_key *found) {
+  const plot_samples *res = nullptr;
+  for (int k = 0; k <= TILE_FALLBACK_LEVELS && !res; ++k) {
+    int64_t index =
+        key.index >= 0 ? key.index >> k : -((-key.index - 1) >> k) - 1;
+    for (int dy : {k, 0}) {
+      *found = plot_tile_key{key.x_level + k, key.y_level + dy, index};
+      res = s21_tile_cache_get(&cache, *found);
+      if (res) break;
+    }
+  }
+  return res;
+}
+
+QPointF PlotWidget::ToScreen(double x, double y) const {
+  return QPointF((x - view.x_min) / (view.x_max - view.x_min) * width(),
+                 (view.y_max - y) / (view.y_max - view.y_min) * height());
+}
+
+/**
+ * Draws the coordinate axes and the bounds of the view.
+ *
+ * @param painter painter of the widget
+ */
+void PlotWidget::DrawAxes(QPainter &painter) {
+  QPointF origin = ToScreen(0, 0);
+  painter.setPen(Qt::gray);
+  if (view.x_min < 0 && view.x_max > 0) {
+    painter.drawLine(QPointF(origin.x(), 0), QPointF(origin.x(), height()));
+  }
+  if (view.y_min < 0 && view.y_max > 0) {
+    painter.drawLine(QPointF(0, origin.y()), QPointF(width(), origin.y()));
+  }
+  painter.drawText(rect().adjusted(4, 4, -4, -4), Qt::AlignLeft | Qt::AlignTop,
+                   QString::number(view.y_max, 'g', 4));
+  painter.drawText(rect().adjusted(4, 4, -4, -4),
+                   Qt::AlignLeft | Qt::AlignBottom,
+                   QString::number(view.x_min, 'g', 4));
+  painter.drawText(rect().adjusted(4, 4, -4, -4),
+                   Qt::AlignRight | Qt::AlignBottom,
+                   QString::number(view.x_max, 'g', 4));
+}
+
+/**
+ * Draws the points of a tile as polylines, a NAN breaks the line.
+ *
+ * @param painter painter of the widget
+ * @param samples points of the tile
+ */
+void PlotWidget::DrawSamples(QPainter &painter, const plot_samples *samples) {
+  QPolygonF line;
+  for (size_t i = 0; i <= samples->count; ++i) {
+    if (i == samples->count || std::isnan(samples->y[i])) {
+      if (line.size() > 1) painter.drawPolyline(line);
+      line.clear();
+    } else {
+      line.append(ToScreen(samples->x[i], samples->y[i]));
+    }
+  }
+}
+
+void PlotWidget::paintEvent(QPaintEvent *) {
+  QPainter painter(this);
+  painter.fillRect(rect(), Qt::white);
+  DrawAxes(painter);
+
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setPen(QPen(Qt::blue, 2));
+  plot_tile_key keys[MAX_VISIBLE_TILES];
+  size_t count = s21_plot_tile_keys(view, keys, MAX_VISIBLE_TILES);
+  plot_tile_key drawn = {0, 0, 0};
+  bool anyDrawn = false;
+  for (size_t i = 0; i < count; ++i) {
+    plot_tile_key found;
+    const plot_samples *samples = FindTile(keys[i], &found);
+    bool repeated = anyDrawn && found.x_level == drawn.x_level &&
+                    found.y_level == drawn.y_level &&
+                    found.index == drawn.index;
+    if (samples && !repeated) {
+      DrawSamples(painter, samples);
+      drawn = found;
+      anyDrawn = true;
+    }
+  }
+}
+
+void PlotWidget::resizeEvent(QResizeEvent *) {
+  view.width = width();
+  view.height = height();
+  sampleTimer.start(0);
+}
+
+/**
+ * Zooms the view around the cursor.
+ *
+ * @param event the wheel event
+ */
+void PlotWidget::wheelEvent(QWheelEvent *event) {
+  double factor = event->angleDelta().y() > 0 ? 1 / ZOOM_STEP : ZOOM_STEP;
+  QPointF pos = event->position();
+  double x = view.x_min + pos.x() / width() * (view.x_max - view.x_min);
+  double y = view.y_max - pos.y() / height() * (view.y_max - view.y_min);
+
+  view.x_min = x + (view.x_min - x) * factor;
+  view.x_max = x + (view.x_max - x) * factor;
+  view.y_min = y + (view.y_min - y) * factor;
+  view.y_max = y + (view.y_max - y) * factor;
+  update();
+  sampleTimer.start(0);
+}
+
+void PlotWidget::mousePressEvent(QMouseEvent *event) { lastPos = event->pos(); }
+
+/**
+ * Pans the view while the mouse is dragged.
+ *
+ * @param event the mouse event
+ */
+void PlotWidget::mouseMoveEvent(QMouseEvent *event) {
+  QPoint delta = event->pos() - lastPos;
+  lastPos = event->pos();
+  double dx = delta.x() * (view.x_max - view.x_min) / width();
+  double dy = delta.y() * (view.y_max - view.y_min) / height();
+
+  view.x_min -= dx;
+  view.x_max -= dx;
+  view.y_min += dy;
+  view.y_max += dy;
+  update();
+  sampleTimer.start(0);
+}
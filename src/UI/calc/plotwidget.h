@@ -0,0 +1,64 @@
+#ifndef PLOTWIDGET_H
+#define PLOTWIDGET_H
+
+#include <QPainter>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include <memory>
+
+#include "asynctask.h"
+
+extern "C" {
+#include "../../calc_logic/plot/include/s21_plot.h"
+}
+
+/**
+ * @brief Graph of y = f(x) with wheel zoom and drag panning.
+ *
+ * The curve is cut into tiles of power-of-two zoom levels that are sampled
+ * adaptively on a worker thread and kept in a tile cache. Panning samples only
+ * the newly exposed tiles, and until they arrive a coarser cached tile is
+ * drawn in their place, so zooming and panning stay smooth.
+ */
+class PlotWidget : public QWidget {
+  Q_OBJECT
+
+ public:
+  explicit PlotWidget(QWidget *parent = nullptr);
+  ~PlotWidget();
+
+  int SetExpression(const QString &expr);
+
+ protected:
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void wheelEvent(QWheelEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+  void mouseMoveEvent(QMouseEvent *event) override;
+
+ private:
+  using CompiledPtr = std::shared_ptr<compiled_expr>;
+  using SamplesPtr = std::shared_ptr<plot_samples>;
+  using Tiles = QVector<QPair<plot_tile_key, SamplesPtr>>;
+
+  QPointF ToScreen(double x, double y) const;
+  void DrawAxes(QPainter &painter);
+  void DrawSamples(QPainter &painter, const plot_samples *samples);
+  const plot_samples *FindTile(plot_tile_key key, plot_tile_key *found);
+  void StoreTiles(const Tiles &tiles);
+
+  CompiledPtr compiled;
+  plot_view view = {-10, 10, -10, 10, 1, 1};
+  plot_tile_cache cache;
+  bool sampling = false;
+  bool resample = false;
+  QPoint lastPos;
+  QTimer sampleTimer;
+  AsyncTask sampleTask;
+
+ private slots:
+  void Sample();
+};
+
+#endif  // PLOTWIDGET_H
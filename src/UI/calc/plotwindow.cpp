@@ -0,0 +1,50 @@
+/**
+ * @file plotwindow.cpp
+ * @brief Contains the implementation of the PlotWindow class for function
+ * graphs.
+ */
+
+#include "plotwindow.h"
+
+#include "ui_plotwindow.h"
+
+/**
+ * Constructor for the PlotWindow class.
+ *
+ * @param parent the parent widget
+ */
+PlotWindow::PlotWindow(QWidget *parent)
+    : QWidget(parent, Qt::Window), ui(new Ui::PlotWindow) {
+  ui->setupUi(this);
+  connect(ui->plotButton, SIGNAL(released()), this, SLOT(PlotPressed()));
+  connect(ui->expression, SIGNAL(returnPressed()), this, SLOT(PlotPressed()));
+}
+
+PlotWindow::~PlotWindow() { delete ui; }
+
+/**
+ * Puts the expression into the input field and draws it.
+ *
+ * @param expr expression of the variable x
+ */
+void PlotWindow::SetExpression(const QString &expr) {
+  ui->expression->setText(expr);
+  PlotPressed();
+}
+
+/**
+ * Draws the entered expression or shows why it can not be drawn.
+ *
+ * @return void
+ *
+ * @throws None
+ */
+void PlotWindow::PlotPressed() {
+  int res = ui->plot->SetExpression(ui->expression->text());
+  QString error;
+  if (res == 1569325041) error = "BRACKETS DO NOT MATCH";
+  if (res == 1569325042) error = "INVALID EXPRESSION";
+  if (res == 1569325043) error = "UNKNOWN FUNC";
+  if (res == 1569325044) error = "CHARACTER LIMIT REACHED (max 255)";
+  ui->status->setText(error);
+}
@@ -0,0 +1,26 @@
+#ifndef PLOTWINDOW_H
+#define PLOTWINDOW_H
+
+#include <QWidget>
+
+namespace Ui {
+class PlotWindow;
+}
+
+class PlotWindow : public QWidget {
+  Q_OBJECT
+
+ public:
+  explicit PlotWindow(QWidget *parent = nullptr);
+  ~PlotWindow();
+
+  void SetExpression(const QString &expr);
+
+ private:
+  Ui::PlotWindow *ui;
+
+ private slots:
+  void PlotPressed();
+};
+
+#endif  // PLOTWINDOW_H
@@ -0,0 +1,81 @@
+/**
+ * @file schedulemodel.cpp
+ * @brief Contains the implementation of the ScheduleModel class for payment
+ * schedule tables.
+ */
+
+#include "schedulemodel.h"
+
+/**
+ * Constructor for ScheduleModel class.
+ *
+ * @param parent pointer to the parent object
+ */
+ScheduleModel::ScheduleModel(QObject *parent) : QAbstractTableModel(parent) {}
+
+ScheduleModel::~ScheduleModel() { s21_clear_schedule(schedule); }
+
+/**
+ * Replaces the shown schedule. The model takes ownership of it.
+ *
+ * @param newSchedule the schedule to show, may be NULL
+ *
+ * @return void
+ *
+ * @throws None
+ */
+void ScheduleModel::SetSchedule(credit_schedule *newSchedule) {
+  beginResetModel();
+  s21_clear_schedule(schedule);
+  schedule = newSchedule;
+  rows = s21_schedule_term(schedule);
+  firstDate = QDate::currentDate();
+  endResetModel();
+}
+
+/**
+ * Removes the shown schedule.
+ */
+void ScheduleModel::Clear() { SetSchedule(nullptr); }
+
+int ScheduleModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : rows;
+}
+
+int ScheduleModel::columnCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : 2;
+}
+
+/**
+ * Calculates and formats a single cell on request of the view.
+ *
+ * @param index the cell
+ * @param role the requested role
+ *
+ * @return payment date or sum for the display role, empty value otherwise
+ *
+ * @throws None
+ */
+QVariant ScheduleModel::data(const QModelIndex &index, int role) const {
+  QVariant res;
+  if (role == Qt::DisplayRole && index.isValid() && index.row() < rows) {
+    if (index.column() == 0) {
+      res = firstDate.addMonths(index.row()).toString("dd.MM.yyyy");
+    } else {
+      schedule_row row = {0};
+      if (s21_schedule_row(schedule, index.row() + 1, &row) == SCHEDULE_OK) {
+        res = QString::number((double)row.payment, 'f', 2);
+      }
+    }
+  }
+  return res;
+}
+
+QVariant ScheduleModel::headerData(int section, Qt::Orientation orientation,
+                                   int role) const {
+  QVariant res;
+  if (role == Qt::DisplayRole && orientation == Qt::Horizontal) {
+    res = section == 0 ? QString("Дата") : QString("Сумма платежа");
+  }
+  return res;
+}
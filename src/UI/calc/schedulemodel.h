@@ -0,0 +1,38 @@
+#ifndef SCHEDULEMODEL_H
+#define SCHEDULEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QDate>
+
+extern "C" {
+#include "../../calc_logic/bank_calc/include/s21_credit_schedule.h"
+}
+
+/**
+ * @brief Table model over a credit schedule. Rows are calculated and
+ * formatted in data(), so only the rows the view asks for cost anything.
+ */
+class ScheduleModel : public QAbstractTableModel {
+  Q_OBJECT
+
+ public:
+  explicit ScheduleModel(QObject *parent = nullptr);
+  ~ScheduleModel();
+
+  void SetSchedule(credit_schedule *newSchedule);
+  void Clear();
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+ private:
+  credit_schedule *schedule = nullptr;
+  QDate firstDate;
+  int rows = 0;
+};
+
+#endif  // SCHEDULEMODEL_H
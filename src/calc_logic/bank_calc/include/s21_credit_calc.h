@@ -3,6 +3,7 @@
 
 #define CREDIT_ERROR -335
 #include <math.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,7 +19,21 @@ typedef struct credit_output_data {
 
 } credit_data;
 
+typedef struct credit_batch {
+  size_t count;
+  const double *amount;
+  const double *term;
+  const double *rate;
+  const int *type;
+  double *monthly_payment;
+  double *overpayment;
+  double *total_payment;
+} credit_batch;
+
 credit_data s21_credit_calc(ld amount, ld term, ld rate, int type);
+credit_data s21_calc_annuity(ld amount, ld rate, ld term);
+ld s21_calc_diff_month(ld amount, ld rate, ld term, int month);
+void s21_credit_calc_batch(credit_batch batch);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,71 @@
+#ifndef S21_CREDIT_SCHEDULE_H
+#define S21_CREDIT_SCHEDULE_H
+
+#include <stddef.h>
+
+#include "s21_credit_calc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum schedule_return_codes { SCHEDULE_OK, SCHEDULE_ERROR };
+enum prepay_mode { PREPAY_REDUCE_TERM, PREPAY_REDUCE_PAYMENT };
+
+typedef struct schedule_row {
+  ld payment;
+  ld interest;
+  ld principal;
+  ld prepayment;
+  ld balance;
+} schedule_row;
+
+/**
+ * @brief Part of the schedule between two prepayment events. Segments form a
+ * persistent list through prev, so every history state shares its prefix.
+ */
+typedef struct schedule_segment {
+  int prev;
+  int start;
+  int end;
+  ld balance;
+  ld payment;
+  ld prepayment;
+} schedule_segment;
+
+typedef struct credit_schedule {
+  int type;
+  ld monthly_rate;
+  int segments_count;
+  size_t segments_size;
+  schedule_segment *segments;
+  int states_count;
+  int current_state;
+  size_t states_size;
+  int *states;
+} credit_schedule;
+
+typedef struct schedule_totals {
+  ld total_payment;
+  ld overpayment;
+  int term;
+} schedule_totals;
+
+credit_schedule *s21_create_schedule(ld amount, ld term, ld rate, int type);
+int s21_schedule_prepay(credit_schedule *schedule, int month, ld sum,
+                        int mode);
+int s21_schedule_undo(credit_schedule *schedule);
+int s21_schedule_redo(credit_schedule *schedule);
+int s21_schedule_term(const credit_schedule *schedule);
+int s21_schedule_row(const credit_schedule *schedule, int month,
+                     schedule_row *row);
+int s21_schedule_fill(const credit_schedule *schedule, int from,
+                      schedule_row *rows, int count);
+schedule_totals s21_schedule_totals(const credit_schedule *schedule);
+void s21_clear_schedule(credit_schedule *schedule);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_CREDIT_SCHEDULE_H
@@ -0,0 +1,39 @@
+#ifndef S21_CREDIT_SOLVER_H
+#define S21_CREDIT_SOLVER_H
+
+#include <stddef.h>
+
+#include "s21_credit_calc.h"
+
+#define SOLVER_MAX_ITER 32
+#define SOLVER_TOLERANCE 1e-15L
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum solver_return_codes {
+  SOLVER_OK,
+  SOLVER_NO_SOLUTION,
+  SOLVER_NO_CONVERGENCE
+};
+
+typedef struct solver_batch_data {
+  const ld *amount;
+  const ld *term;
+  const ld *payment;
+  ld *rate;
+  int *status;
+} solver_batch_data;
+
+int s21_solve_rate(ld amount, ld term, ld payment, ld *rate);
+int s21_solve_term(ld amount, ld rate, ld payment, ld *term);
+int s21_solve_amount(ld term, ld rate, ld payment, ld *amount);
+int s21_effective_apr(ld amount, const ld *payments, int count, ld *apr);
+int s21_solve_rate_batch(solver_batch_data data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_CREDIT_SOLVER_H
@@ -0,0 +1,89 @@
+#ifndef S21_MONTE_CARLO_H
+#define S21_MONTE_CARLO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "s21_credit_calc.h"
+
+#define MC_BATCH 64
+#define SKETCH_BINS 2048
+#define SKETCH_ACCURACY 0.01
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum mc_return_codes { MC_OK, MC_ERROR };
+enum mc_product { MC_CREDIT, MC_DEPOSIT };
+
+/**
+ * @brief Vasicek short rate model, all values are annual rates in percent.
+ */
+typedef struct rate_model {
+  ld initial;
+  ld mean;
+  ld speed;
+  ld volatility;
+} rate_model;
+
+/**
+ * @brief Parameters of a simulation. fast_math_ulps at the bound of cos in
+ * s21_fast_math.h or above draws the normal values with its inline
+ * approximation instead of libm, 0 keeps libm.
+ */
+typedef struct mc_params {
+  int product;
+  ld amount;
+  int term;
+  rate_model model;
+  uint64_t seed;
+  size_t paths;
+  int threads;
+  int fast_math_ulps;
+} mc_params;
+
+/**
+ * @brief Mergeable quantile sketch with logarithmic bins of bounded relative
+ * error. The bins cover magnitudes from about e^-20 to e^20, values outside
+ * go to the first or the last bin and are counted in clamped, as quantiles
+ * that fall on them lose the error bound.
+ */
+typedef struct quantile_sketch {
+  uint64_t positive[SKETCH_BINS];
+  uint64_t negative[SKETCH_BINS];
+  uint64_t zero;
+  uint64_t count;
+  uint64_t clamped;
+  double sum;
+} quantile_sketch;
+
+/**
+ * @brief Result of a simulation. clamped is the number of outcomes outside
+ * the range of the quantile sketch, the quantiles are exact to
+ * SKETCH_ACCURACY only while it is 0.
+ */
+typedef struct mc_result {
+  ld p5;
+  ld p50;
+  ld p95;
+  ld mean;
+  size_t paths;
+  size_t clamped;
+  int threads;
+  double seconds;
+  double paths_per_sec;
+} mc_result;
+
+void s21_philox4x32(const uint32_t counter[4], const uint32_t key[2],
+                    uint32_t out[4]);
+void s21_sketch_add(quantile_sketch *sketch, double value);
+void s21_sketch_merge(quantile_sketch *dst, const quantile_sketch *src);
+double s21_sketch_quantile(const quantile_sketch *sketch, double q);
+int s21_monte_carlo(mc_params params, mc_result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_MONTE_CARLO_H
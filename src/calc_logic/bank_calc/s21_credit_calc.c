@@ -74,3 +74,39 @@ credit_data s21_credit_calc(ld amount, ld term, ld rate, int type) {
   }
   return res;
 }
+
+/**
+ * @brief Calculate credit data for columns of credits.
+ *
+ * Results match s21_credit_calc() row by row: invalid rows get CREDIT_ERROR
+ * in total_payment and differentiated rows have no monthly payment. Totals of
+ * differentiated credits use the closed form of the monthly sum, so each row
+ * costs O(1) regardless of the term.
+ *
+ * @param batch Input columns and output columns of the same length.
+ */
+void s21_credit_calc_batch(credit_batch batch) {
+  for (size_t i = 0; i < batch.count; i++) {
+    double amount = batch.amount[i];
+    double term = batch.term[i];
+    double rate = floor(batch.rate[i]);
+    batch.monthly_payment[i] = 0;
+    batch.overpayment[i] = 0;
+    batch.total_payment[i] = CREDIT_ERROR;
+
+    if (amount > 0 && term > 0 && batch.rate[i] > 0 && term < 120) {
+      if (!batch.type[i]) {
+        credit_data res = s21_calc_annuity(amount, rate, term);
+        batch.monthly_payment[i] = res.monthly_payment;
+        batch.overpayment[i] = res.overpayment;
+        batch.total_payment[i] = res.total_payment;
+      } else {
+        double months = floor(term);
+        double part = amount / term;
+        double balances = amount * months - part * months * (months - 1) / 2;
+        batch.overpayment[i] = balances * rate / 1200;
+        batch.total_payment[i] = part * months + batch.overpayment[i];
+      }
+    }
+  }
+}
@@ -0,0 +1,331 @@
+/**
+ * @file
+ * @brief Contains a credit schedule supporting early repayments with undo/redo
+ */
+
+#include "include/s21_credit_schedule.h"
+
+#include <stdlib.h>
+
+#define SCHEDULE_INIT_SIZE 8
+
+/**
+ * @brief Appends a segment to the schedule pool.
+ *
+ * @return Index of the new segment or -1 if memory allocation fails.
+ */
+static int s21_push_segment(credit_schedule *schedule, schedule_segment seg) {
+  if ((size_t)schedule->segments_count == schedule->segments_size) {
+    size_t size = schedule->segments_size * 2;
+    schedule_segment *tmp =
+        realloc(schedule->segments, size * sizeof(schedule_segment));
+    if (!tmp) return -1;
+    schedule->segments = tmp;
+    schedule->segments_size = size;
+  }
+  schedule->segments[schedule->segments_count] = seg;
+  return schedule->segments_count++;
+}
+
+/**
+ * @brief Makes the given segment the head of a new history state, dropping
+ * states that could be redone.
+ */
+static int s21_push_state(credit_schedule *schedule, int head) {
+  if ((size_t)schedule->current_state + 1 == schedule->states_size) {
+    size_t size = schedule->states_size * 2;
+    int *tmp = realloc(schedule->states, size * sizeof(int));
+    if (!tmp) return SCHEDULE_ERROR;
+    schedule->states = tmp;
+    schedule->states_size = size;
+  }
+  schedule->current_state++;
+  schedule->states[schedule->current_state] = head;
+  schedule->states_count = schedule->current_state + 1;
+  return SCHEDULE_OK;
+}
+
+/**
+ * @brief Finds the segment that covers the given month in the current state.
+ *
+ * @param schedule The credit schedule.
+ * @param month The month to look for.
+ * @param newer Output for the segment following the found one, or -1.
+ * @return Index of the segment.
+ */
+static int s21_find_segment(const credit_schedule *schedule, int month,
+                            int *newer) {
+  int cur = schedule->states[schedule->current_state];
+  *newer = -1;
+  while (cur >= 0 && schedule->segments[cur].start > month) {
+    *newer = cur;
+    cur = schedule->segments[cur].prev;
+  }
+  return cur;
+}
+
+/**
+ * @brief Calculate the balance before the k-th payment of a segment. Annuity
+ * segments use the closed form, so the lookup is O(1) for both types.
+ */
+static ld s21_segment_balance(const credit_schedule *schedule,
+                              const schedule_segment *seg, int k) {
+  ld res = 0;
+  if (!schedule->type) {
+    ld growth = powl(1 + schedule->monthly_rate, k);
+    res = seg->balance * growth -
+          seg->payment * (growth - 1) / schedule->monthly_rate;
+  } else {
+    res = seg->balance - k * seg->payment;
+  }
+  return res;
+}
+
+/**
+ * @brief Calculate a single schedule row of a segment.
+ */
+static schedule_row s21_segment_row(const credit_schedule *schedule,
+                                    const schedule_segment *seg, int month,
+                                    ld prepayment) {
+  schedule_row res = {0};
+  ld before = s21_segment_balance(schedule, seg, month - seg->start);
+
+  res.interest = before * schedule->monthly_rate;
+  if (month == seg->end) {
+    res.principal = before;
+  } else if (!schedule->type) {
+    res.principal = seg->payment - res.interest;
+  } else {
+    res.principal = fminl(seg->payment, before);
+  }
+  res.payment = res.principal + res.interest;
+  res.prepayment = prepayment;
+  res.balance = before - res.principal - prepayment;
+  return res;
+}
+
+/**
+ * @brief Calculate a prepayment that the following segment applies at the end
+ * of the given month.
+ */
+static ld s21_prepayment_at(const credit_schedule *schedule, int newer,
+                            int month) {
+  ld res = 0;
+  if (newer >= 0 && schedule->segments[newer].start == month + 1) {
+    res = schedule->segments[newer].prepayment;
+  }
+  return res;
+}
+
+/**
+ * @brief Create a credit schedule.
+ *
+ * @param amount The amount of the credit.
+ * @param term The term of the credit in months.
+ * @param rate The annual interest rate, floored like in s21_credit_calc().
+ * @param type The type of payment calculation (0 for annuity, 1 for
+ * differentiated).
+ * @return Pointer to the schedule or NULL on invalid input or allocation
+ * failure.
+ */
+credit_schedule *s21_create_schedule(ld amount, ld term, ld rate, int type) {
+  if (amount <= 0 || term < 1 || floorl(rate) <= 0) return NULL;
+
+  credit_schedule *res = calloc(1, sizeof(credit_schedule));
+  if (res) {
+    res->segments = calloc(SCHEDULE_INIT_SIZE, sizeof(schedule_segment));
+    res->states = calloc(SCHEDULE_INIT_SIZE, sizeof(int));
+    if (!res->segments || !res->states) {
+      s21_clear_schedule(res);
+      return NULL;
+    }
+    res->segments_size = SCHEDULE_INIT_SIZE;
+    res->states_size = SCHEDULE_INIT_SIZE;
+    res->type = type;
+    res->monthly_rate = floorl(rate) / 100.0 / 12.0;
+
+    schedule_segment first = {-1, 1, (int)term, amount, 0, 0};
+    if (!type) {
+      first.payment = s21_calc_annuity(amount, floorl(rate), first.end)
+                          .monthly_payment;
+    } else {
+      first.payment = amount / first.end;
+    }
+    s21_push_segment(res, first);
+    res->states_count = 1;
+  }
+  return res;
+}
+
+/**
+ * @brief Apply an early repayment together with the payment of the given
+ * month. Only the tail after the month is recomputed; events at or after the
+ * month are discarded in the new state but remain reachable through undo.
+ *
+ * @param schedule The credit schedule.
+ * @param month The month of the repayment.
+ * @param sum The repayment sum; sums above the balance close the credit.
+ * @param mode PREPAY_REDUCE_TERM or PREPAY_REDUCE_PAYMENT.
+ * @return SCHEDULE_OK on success, SCHEDULE_ERROR otherwise.
+ */
+int s21_schedule_prepay(credit_schedule *schedule, int month, ld sum,
+                        int mode) {
+  if (!schedule || sum <= 0 || month < 1 ||
+      month >= s21_schedule_term(schedule)) {
+    return SCHEDULE_ERROR;
+  }
+  if (mode != PREPAY_REDUCE_TERM && mode != PREPAY_REDUCE_PAYMENT) {
+    return SCHEDULE_ERROR;
+  }
+
+  int newer = -1;
+  int idx = s21_find_segment(schedule, month, &newer);
+  schedule_segment seg = schedule->segments[idx];
+  ld balance = s21_segment_row(schedule, &seg, month, 0).balance;
+  ld rate = schedule->monthly_rate;
+
+  schedule_segment next = {idx, month + 1, month, 0, 0, fminl(sum, balance)};
+  if (sum < balance) {
+    int remaining = seg.end - month;
+    next.balance = balance - sum;
+    next.end = seg.end;
+    if (mode == PREPAY_REDUCE_PAYMENT) {
+      next.payment = !schedule->type ? next.balance * rate /
+                                           -expm1l(-remaining * log1pl(rate))
+                                     : next.balance / remaining;
+    } else {
+      ld months = 0;
+      next.payment = seg.payment;
+      if (!schedule->type) {
+        months = -log1pl(-next.balance * rate / seg.payment) / log1pl(rate);
+      } else {
+        months = next.balance / seg.payment;
+      }
+      next.end = month + (int)ceill(months - 1e-9);
+    }
+  }
+
+  int head = s21_push_segment(schedule, next);
+  if (head < 0) return SCHEDULE_ERROR;
+  return s21_push_state(schedule, head);
+}
+
+/**
+ * @brief Return the schedule to the state before the last repayment.
+ *
+ * @param schedule The credit schedule.
+ * @return SCHEDULE_OK on success, SCHEDULE_ERROR if there is nothing to undo.
+ */
+int s21_schedule_undo(credit_schedule *schedule) {
+  if (!schedule || schedule->current_state == 0) return SCHEDULE_ERROR;
+  schedule->current_state--;
+  return SCHEDULE_OK;
+}
+
+/**
+ * @brief Reapply the last undone repayment.
+ *
+ * @param schedule The credit schedule.
+ * @return SCHEDULE_OK on success, SCHEDULE_ERROR if there is nothing to redo.
+ */
+int s21_schedule_redo(credit_schedule *schedule) {
+  if (!schedule || schedule->current_state + 1 >= schedule->states_count) {
+    return SCHEDULE_ERROR;
+  }
+  schedule->current_state++;
+  return SCHEDULE_OK;
+}
+
+/**
+ * @brief Get the current term of the credit.
+ *
+ * @param schedule The credit schedule.
+ * @return The number of the last payment month, 0 for NULL schedule.
+ */
+int s21_schedule_term(const credit_schedule *schedule) {
+  if (!schedule) return 0;
+  return schedule->segments[schedule->states[schedule->current_state]].end;
+}
+
+/**
+ * @brief Calculate a single row of the current schedule.
+ *
+ * @param schedule The credit schedule.
+ * @param month The month of the row, starting from 1.
+ * @param row Output for the row.
+ * @return SCHEDULE_OK on success, SCHEDULE_ERROR if the month is out of term.
+ */
+int s21_schedule_row(const credit_schedule *schedule, int month,
+                     schedule_row *row) {
+  if (!row || month < 1 || month > s21_schedule_term(schedule)) {
+    return SCHEDULE_ERROR;
+  }
+
+  int newer = -1;
+  int idx = s21_find_segment(schedule, month, &newer);
+  *row = s21_segment_row(schedule, &schedule->segments[idx], month,
+                         s21_prepayment_at(schedule, newer, month));
+  return SCHEDULE_OK;
+}
+
+/**
+ * @brief Materialize consecutive rows of the current schedule.
+ *
+ * @param schedule The credit schedule.
+ * @param from The first month to fill, starting from 1.
+ * @param rows Output array of rows.
+ * @param count Capacity of the output array.
+ * @return The number of filled rows.
+ */
+int s21_schedule_fill(const credit_schedule *schedule, int from,
+                      schedule_row *rows, int count) {
+  if (!schedule || !rows || from < 1) return 0;
+
+  int term = s21_schedule_term(schedule);
+  int month = from;
+  while (month <= term && month - from < count) {
+    int newer = -1;
+    int idx = s21_find_segment(schedule, month, &newer);
+    const schedule_segment *seg = &schedule->segments[idx];
+    int end = newer >= 0 ? schedule->segments[newer].start - 1 : seg->end;
+    for (; month <= end && month - from < count; month++) {
+      ld prepayment = s21_prepayment_at(schedule, newer, month);
+      rows[month - from] = s21_segment_row(schedule, seg, month, prepayment);
+    }
+  }
+  return month - from;
+}
+
+/**
+ * @brief Calculate total payment and overpayment of the current schedule.
+ *
+ * @param schedule The credit schedule.
+ * @return Totals including prepayments and the current term.
+ */
+schedule_totals s21_schedule_totals(const credit_schedule *schedule) {
+  schedule_totals res = {0};
+  res.term = s21_schedule_term(schedule);
+
+  schedule_row rows[64];
+  for (int month = 1; month <= res.term; month += 64) {
+    int filled = s21_schedule_fill(schedule, month, rows, 64);
+    for (int i = 0; i < filled; i++) {
+      res.total_payment += rows[i].payment + rows[i].prepayment;
+      res.overpayment += rows[i].interest;
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Free the credit schedule.
+ *
+ * @param schedule The credit schedule.
+ */
+void s21_clear_schedule(credit_schedule *schedule) {
+  if (schedule) {
+    free(schedule->segments);
+    free(schedule->states);
+    free(schedule);
+  }
+}
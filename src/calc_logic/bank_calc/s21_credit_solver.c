@@ -0,0 +1,220 @@
+/**
+ * @file
+ * @brief Contains inverse solvers for credit parameters
+ */
+
+#include "include/s21_credit_solver.h"
+
+/**
+ * @brief Value with its first and second derivative (forward-mode jet)
+ */
+typedef struct jet {
+  ld v;
+  ld d1;
+  ld d2;
+} jet;
+
+static jet s21_jet_const(ld value) { return (jet){value, 0, 0}; }
+
+static jet s21_jet_var(ld value) { return (jet){value, 1, 0}; }
+
+static jet s21_jet_add(jet a, jet b) {
+  return (jet){a.v + b.v, a.d1 + b.d1, a.d2 + b.d2};
+}
+
+static jet s21_jet_sub(jet a, jet b) {
+  return (jet){a.v - b.v, a.d1 - b.d1, a.d2 - b.d2};
+}
+
+static jet s21_jet_mul(jet a, jet b) {
+  return (jet){a.v * b.v, a.d1 * b.v + a.v * b.d1,
+               a.d2 * b.v + 2 * a.d1 * b.d1 + a.v * b.d2};
+}
+
+static jet s21_jet_div(jet a, jet b) {
+  jet res = {0};
+  res.v = a.v / b.v;
+  res.d1 = (a.d1 - res.v * b.d1) / b.v;
+  res.d2 = (a.d2 - 2 * res.d1 * b.d1 - res.v * b.d2) / b.v;
+  return res;
+}
+
+/**
+ * @brief Raises a jet to a constant power.
+ */
+static jet s21_jet_pow(jet a, ld power) {
+  ld p2 = powl(a.v, power - 2);
+  ld p1 = p2 * a.v;
+  return (jet){p1 * a.v, power * p1 * a.d1,
+               power * (power - 1) * p2 * a.d1 * a.d1 + power * p1 * a.d2};
+}
+
+/**
+ * @brief Residual of the annuity formula for a monthly rate: A*r/(1-(1+r)^-n)-P
+ */
+static jet s21_annuity_residual(ld amount, ld term, ld payment, ld rate) {
+  jet r = s21_jet_var(rate);
+  jet discount = s21_jet_pow(s21_jet_add(s21_jet_const(1), r), -term);
+  jet factor = s21_jet_div(r, s21_jet_sub(s21_jet_const(1), discount));
+  return s21_jet_sub(s21_jet_mul(s21_jet_const(amount), factor),
+                     s21_jet_const(payment));
+}
+
+/**
+ * @brief Residual of the present value equation: sum(P_k*(1+r)^-k) - A
+ */
+static jet s21_pv_residual(ld amount, const ld *payments, int count, ld rate) {
+  jet base = s21_jet_add(s21_jet_const(1), s21_jet_var(rate));
+  jet res = s21_jet_const(-amount);
+  for (int i = 0; i < count; i++) {
+    jet discount = s21_jet_pow(base, -(i + 1));
+    res = s21_jet_add(res, s21_jet_mul(s21_jet_const(payments[i]), discount));
+  }
+  return res;
+}
+
+/**
+ * @brief Performs a single Halley step, falling back to Newton when the
+ * Halley denominator degenerates.
+ *
+ * @param f Residual with derivatives at the current point.
+ * @return The step to subtract from the current point.
+ */
+static ld s21_halley_step(jet f) {
+  ld step = f.v / f.d1;
+  ld denom = 2 * f.d1 * f.d1 - f.v * f.d2;
+  if (denom != 0 && isfinite(denom)) {
+    ld halley = 2 * f.v * f.d1 / denom;
+    if (fabsl(halley) <= 2 * fabsl(step)) step = halley;
+  }
+  return step;
+}
+
+/**
+ * @brief Calculate the annual interest rate that produces the given annuity
+ * payment.
+ *
+ * @param amount The amount of the credit.
+ * @param term The term of the credit in months.
+ * @param payment The desired monthly payment.
+ * @param rate Output for the annual interest rate in percent.
+ * @return SOLVER_OK on success, SOLVER_NO_SOLUTION if no positive rate gives
+ * the payment, SOLVER_NO_CONVERGENCE if iterations did not converge.
+ */
+int s21_solve_rate(ld amount, ld term, ld payment, ld *rate) {
+  if (!rate || amount <= 0 || term <= 0 || payment * term <= amount) {
+    return SOLVER_NO_SOLUTION;
+  }
+
+  int res = SOLVER_NO_CONVERGENCE;
+  ld cur = 2 * (term * payment - amount) / (amount * (term + 1));
+  for (int i = 0; i < SOLVER_MAX_ITER && res != SOLVER_OK; i++) {
+    jet f = s21_annuity_residual(amount, term, payment, cur);
+    ld step = s21_halley_step(f);
+    ld next = cur - step;
+    if (next <= 0) next = cur / 2;
+    if (fabsl(next - cur) <= SOLVER_TOLERANCE * fmaxl(1, cur)) res = SOLVER_OK;
+    cur = next;
+  }
+  *rate = cur * 1200;
+  return res;
+}
+
+/**
+ * @brief Calculate the term that repays the credit with the given annuity
+ * payment.
+ *
+ * @param amount The amount of the credit.
+ * @param rate The annual interest rate in percent.
+ * @param payment The monthly payment.
+ * @param term Output for the (fractional) term in months.
+ * @return SOLVER_OK on success, SOLVER_NO_SOLUTION if the payment does not
+ * cover the monthly interest.
+ */
+int s21_solve_term(ld amount, ld rate, ld payment, ld *term) {
+  ld monthly_rate = rate / 100.0 / 12.0;
+  if (!term || amount <= 0 || rate <= 0 || payment <= amount * monthly_rate) {
+    return SOLVER_NO_SOLUTION;
+  }
+
+  *term = -log1pl(-amount * monthly_rate / payment) / log1pl(monthly_rate);
+  return SOLVER_OK;
+}
+
+/**
+ * @brief Calculate the credit amount that is repaid by the given annuity
+ * payment.
+ *
+ * @param term The term of the credit in months.
+ * @param rate The annual interest rate in percent.
+ * @param payment The monthly payment.
+ * @param amount Output for the credit amount.
+ * @return SOLVER_OK on success, SOLVER_NO_SOLUTION on invalid input.
+ */
+int s21_solve_amount(ld term, ld rate, ld payment, ld *amount) {
+  if (!amount || term <= 0 || rate <= 0 || payment <= 0) {
+    return SOLVER_NO_SOLUTION;
+  }
+
+  ld monthly_rate = rate / 100.0 / 12.0;
+  *amount = payment * -expm1l(-term * log1pl(monthly_rate)) / monthly_rate;
+  return SOLVER_OK;
+}
+
+/**
+ * @brief Calculate the effective annual percentage rate of an arbitrary
+ * monthly payment schedule, e.g. the differentiated one.
+ *
+ * @param amount The amount of the credit.
+ * @param payments Monthly payments, first one due after one month.
+ * @param count The number of payments.
+ * @param apr Output for the effective annual rate in percent.
+ * @return SOLVER_OK on success, SOLVER_NO_SOLUTION if payments do not exceed
+ * the amount, SOLVER_NO_CONVERGENCE if iterations did not converge.
+ */
+int s21_effective_apr(ld amount, const ld *payments, int count, ld *apr) {
+  if (!apr || !payments || amount <= 0 || count <= 0) {
+    return SOLVER_NO_SOLUTION;
+  }
+
+  ld total = 0;
+  for (int i = 0; i < count; i++) total += payments[i];
+  if (total <= amount) return SOLVER_NO_SOLUTION;
+
+  int res = SOLVER_NO_CONVERGENCE;
+  ld cur = 2 * (total - amount) / (amount * (count + 1));
+  for (int i = 0; i < SOLVER_MAX_ITER && res != SOLVER_OK; i++) {
+    jet f = s21_pv_residual(amount, payments, count, cur);
+    ld next = cur - s21_halley_step(f);
+    if (next <= 0) next = cur / 2;
+    if (fabsl(next - cur) <= SOLVER_TOLERANCE * fmaxl(1, cur)) res = SOLVER_OK;
+    cur = next;
+  }
+  *apr = expm1l(12 * log1pl(cur)) * 100;
+  return res;
+}
+
+/**
+ * @brief Solve annual rates for a whole portfolio of annuity credits.
+ *
+ * @param data Input columns (amount, term, payment) and output columns (rate,
+ * status); status may be NULL.
+ * @param count The number of credits.
+ * @return SOLVER_OK if every credit was solved, otherwise the status of the
+ * first failed one.
+ */
+int s21_solve_rate_batch(solver_batch_data data, size_t count) {
+  if (!data.amount || !data.term || !data.payment || !data.rate) {
+    return SOLVER_NO_SOLUTION;
+  }
+
+  int res = SOLVER_OK;
+  for (size_t i = 0; i < count; i++) {
+    data.rate[i] = 0;
+    int status = s21_solve_rate(data.amount[i], data.term[i], data.payment[i],
+                                &data.rate[i]);
+    if (data.status) data.status[i] = status;
+    if (res == SOLVER_OK) res = status;
+  }
+  return res;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file
+ * @brief Contains Monte Carlo simulation of floating-rate credits and deposits
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_monte_carlo.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../compiler/include/s21_fast_math.h"
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+#define MC_TWO_PI 6.283185307179586
+#define MC_GROUP_BATCHES 256
+
+/**
+ * @brief Groups of batches simulated by one thread: first, first + step and
+ * so on. The sum of every group goes to its own slot of sums.
+ */
+typedef struct mc_worker {
+  const mc_params *params;
+  size_t first_group;
+  size_t step;
+  double *sums;
+  quantile_sketch sketch;
+} mc_worker;
+
+/**
+ * @brief Philox4x32-10 counter-based generator. The same counter and key
+ * always give the same output, so every path owns an independent stream.
+ *
+ * @param counter 128-bit counter.
+ * @param key 64-bit key.
+ * @param out Output for 128 random bits.
+ */
+void s21_philox4x32(const uint32_t counter[4], const uint32_t key[2],
+                    uint32_t out[4]) {
+  uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+  uint32_t k[2] = {key[0], key[1]};
+
+  for (int i = 0; i < PHILOX_ROUNDS; i++) {
+    uint64_t p0 = (uint64_t)PHILOX_M0 * c[0];
+    uint64_t p1 = (uint64_t)PHILOX_M1 * c[2];
+    uint32_t next[4] = {(uint32_t)(p1 >> 32) ^ c[1] ^ k[0], (uint32_t)p1,
+                        (uint32_t)(p0 >> 32) ^ c[3] ^ k[1], (uint32_t)p0};
+    memcpy(c, next, sizeof(c));
+    k[0] += PHILOX_W0;
+    k[1] += PHILOX_W1;
+  }
+  memcpy(out, c, sizeof(c));
+}
+
+/**
+ * @brief Standard normal value of the given path and month (Box-Muller),
+ * with the fast-math cosine if fast is set.
+ */
+static double s21_mc_normal(uint64_t seed, uint64_t path, int month,
+                            int fast) {
+  uint32_t counter[4] = {(uint32_t)path, (uint32_t)(path >> 32),
+                         (uint32_t)month, 0};
+  uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+  uint32_t bits[4] = {0};
+  s21_philox4x32(counter, key, bits);
+
+  double u1 = (((uint64_t)bits[0] << 21 ^ bits[1] >> 11) + 0.5) * 0x1p-53;
+  double u2 = (((uint64_t)bits[2] << 21 ^ bits[3] >> 11) + 0.5) * 0x1p-53;
+  return sqrt(-2 * log(u1)) *
+         (fast ? s21_fast_cos(MC_TWO_PI * u2) : cos(MC_TWO_PI * u2));
+}
+
+/**
+ * @brief Simulate a batch of consecutive paths.
+ *
+ * The state of the batch is kept in plain arrays so the per-month update loops
+ * run over contiguous memory and can be vectorized by the compiler.
+ *
+ * @param params Simulation parameters.
+ * @param first_path Index of the first path of the batch.
+ * @param count Number of paths in the batch, at most MC_BATCH.
+ * @param outcome Output for overpayment (credit) or interest (deposit).
+ */
+static void s21_simulate_batch(const mc_params *params, uint64_t first_path,
+                               int count, double *outcome) {
+  double rate[MC_BATCH];
+  double balance[MC_BATCH];
+  double acc[MC_BATCH];
+  double noise[MC_BATCH];
+  const rate_model *model = &params->model;
+  double drift = (double)model->speed / 12.0;
+  double vol = (double)model->volatility * sqrt(1.0 / 12.0);
+
+  for (int j = 0; j < count; j++) {
+    rate[j] = (double)model->initial;
+    balance[j] = (double)params->amount;
+    acc[j] = 0;
+  }
+
+  int fast = params->fast_math_ulps >= FAST_MATH_ULPS_COS;
+  for (int month = 0; month < params->term; month++) {
+    int remaining = params->term - month;
+    for (int j = 0; j < count; j++) {
+      noise[j] = s21_mc_normal(params->seed, first_path + j, month, fast);
+    }
+    for (int j = 0; j < count; j++) {
+      double r = fmax(rate[j], 0) / 1200.0;
+      double interest = balance[j] * r;
+      if (params->product == MC_CREDIT) {
+        double payment = r > 0 ? interest / -expm1(-remaining * log1p(r))
+                               : balance[j] / remaining;
+        acc[j] += interest;
+        balance[j] -= payment - interest;
+      } else {
+        balance[j] += interest;
+      }
+      rate[j] += drift * ((double)model->mean - rate[j]) + vol * noise[j];
+    }
+  }
+
+  for (int j = 0; j < count; j++) {
+    outcome[j] = params->product == MC_CREDIT
+                     ? acc[j]
+                     : balance[j] - (double)params->amount;
+  }
+}
+
+/**
+ * @brief Worker thread simulating every step-th group of batches into its own
+ * sketch.
+ */
+static void *s21_mc_worker(void *arg) {
+  mc_worker *worker = arg;
+  const mc_params *params = worker->params;
+  size_t batches = (params->paths + MC_BATCH - 1) / MC_BATCH;
+  size_t groups = (batches + MC_GROUP_BATCHES - 1) / MC_GROUP_BATCHES;
+  double outcome[MC_BATCH];
+
+  for (size_t g = worker->first_group; g < groups; g += worker->step) {
+    double sum = 0;
+    for (size_t b = g * MC_GROUP_BATCHES;
+         b < batches && b < (g + 1) * MC_GROUP_BATCHES; b++) {
+      size_t first = b * MC_BATCH;
+      int count = (int)(params->paths - first < MC_BATCH
+                            ? params->paths - first
+                            : MC_BATCH);
+      s21_simulate_batch(params, first, count, outcome);
+      for (int j = 0; j < count; j++) {
+        s21_sketch_add(&worker->sketch, outcome[j]);
+        if (!isnan(outcome[j])) sum += outcome[j];
+      }
+    }
+    worker->sums[g] = sum;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Add a value to the quantile sketch.
+ *
+ * @param sketch The quantile sketch.
+ * @param value The value to add.
+ */
+void s21_sketch_add(quantile_sketch *sketch, double value) {
+  if (!sketch || isnan(value)) return;
+
+  if (value == 0) {
+    sketch->zero++;
+  } else {
+    double gamma = (1 + SKETCH_ACCURACY) / (1 - SKETCH_ACCURACY);
+    double bin = ceil(log(fabs(value)) / log(gamma)) + SKETCH_BINS / 2;
+    int idx = 0;
+    if (bin < 0 || bin >= SKETCH_BINS) {
+      idx = bin < 0 ? 0 : SKETCH_BINS - 1;
+      sketch->clamped++;
+    } else {
+      idx = (int)bin;
+    }
+    if (value > 0) {
+      sketch->positive[idx]++;
+    } else {
+      sketch->negative[idx]++;
+    }
+  }
+  sketch->count++;
+  sketch->sum += value;
+}
+
+/**
+ * @brief Merge one sketch into another. Merging is exact: the result equals
+ * the sketch of all values added to both.
+ *
+ * @param dst The sketch to merge into.
+ * @param src The sketch to merge from.
+ */
+void s21_sketch_merge(quantile_sketch *dst, const quantile_sketch *src) {
+  if (!dst || !src) return;
+
+  for (int i = 0; i < SKETCH_BINS; i++) {
+    dst->positive[i] += src->positive[i];
+    dst->negative[i] += src->negative[i];
+  }
+  dst->zero += src->zero;
+  dst->count += src->count;
+  dst->clamped += src->clamped;
+  dst->sum += src->sum;
+}
+
+/**
+ * @brief Estimate a quantile with relative error of SKETCH_ACCURACY, unless it
+ * falls on a clamped value.
+ *
+ * @param sketch The quantile sketch.
+ * @param q The quantile in [0, 1].
+ * @return The estimated value, NAN for an empty sketch.
+ */
+double s21_sketch_quantile(const quantile_sketch *sketch, double q) {
+  if (!sketch || !sketch->count || q < 0 || q > 1) return NAN;
+
+  double gamma = (1 + SKETCH_ACCURACY) / (1 - SKETCH_ACCURACY);
+  uint64_t rank = (uint64_t)(q * (double)(sketch->count - 1));
+  uint64_t seen = 0;
+  double res = NAN;
+
+  for (int i = SKETCH_BINS - 1; i >= 0 && isnan(res); i--) {
+    seen += sketch->negative[i];
+    if (seen > rank) res = -2 * pow(gamma, i - SKETCH_BINS / 2) / (gamma + 1);
+  }
+  if (isnan(res)) {
+    seen += sketch->zero;
+    if (seen > rank) res = 0;
+  }
+  for (int i = 0; i < SKETCH_BINS && isnan(res); i++) {
+    seen += sketch->positive[i];
+    if (seen > rank) res = 2 * pow(gamma, i - SKETCH_BINS / 2) / (gamma + 1);
+  }
+  return res;
+}
+
+/**
+ * @brief Run a Monte Carlo simulation of a floating-rate credit or deposit.
+ *
+ * Credits are re-amortized every month at the current rate and report the
+ * overpayment, deposits are capitalized monthly and report the interest.
+ * Every path draws from its own Philox stream, and the sums of groups of
+ * paths are added in the order of the groups after all threads finish, so
+ * neither the quantiles nor the mean depend on the number of threads or the
+ * order in which they finish.
+ *
+ * @param params Simulation parameters, threads <= 0 uses all cores.
+ * @param result Output for quantiles, mean and throughput.
+ * @return MC_OK on success, MC_ERROR on invalid input or allocation failure.
+ */
+int s21_monte_carlo(mc_params params, mc_result *result) {
+  if (!result || params.amount <= 0 || params.term <= 0 || !params.paths) {
+    return MC_ERROR;
+  }
+  if (params.product != MC_CREDIT && params.product != MC_DEPOSIT) {
+    return MC_ERROR;
+  }
+  if (params.threads <= 0) params.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (params.threads <= 0) params.threads = 1;
+
+  size_t batches = (params.paths + MC_BATCH - 1) / MC_BATCH;
+  size_t groups = (batches + MC_GROUP_BATCHES - 1) / MC_GROUP_BATCHES;
+  mc_worker *workers = calloc(params.threads, sizeof(mc_worker));
+  pthread_t *ids = calloc(params.threads, sizeof(pthread_t));
+  char *created = calloc(params.threads, sizeof(char));
+  double *sums = calloc(groups, sizeof(double));
+  if (!workers || !ids || !created || !sums) {
+    free(workers);
+    free(ids);
+    free(created);
+    free(sums);
+    return MC_ERROR;
+  }
+
+  struct timespec start = {0};
+  struct timespec end = {0};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (int i = 0; i < params.threads; i++) {
+    workers[i].params = &params;
+    workers[i].first_group = i;
+    workers[i].step = params.threads;
+    workers[i].sums = sums;
+  }
+  for (int i = 1; i < params.threads; i++) {
+    created[i] = !pthread_create(&ids[i], NULL, s21_mc_worker, &workers[i]);
+  }
+  s21_mc_worker(&workers[0]);
+  for (int i = 1; i < params.threads; i++) {
+    if (created[i]) {
+      pthread_join(ids[i], NULL);
+    } else {
+      s21_mc_worker(&workers[i]);
+    }
+  }
+  for (int i = 1; i < params.threads; i++) {
+    s21_sketch_merge(&workers[0].sketch, &workers[i].sketch);
+  }
+  workers[0].sketch.sum = 0;
+  for (size_t g = 0; g < groups; g++) workers[0].sketch.sum += sums[g];
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  const quantile_sketch *sketch = &workers[0].sketch;
+  result->p5 = s21_sketch_quantile(sketch, 0.05);
+  result->p50 = s21_sketch_quantile(sketch, 0.5);
+  result->p95 = s21_sketch_quantile(sketch, 0.95);
+  result->mean = sketch->sum / sketch->count;
+  result->paths = sketch->count;
+  result->clamped = sketch->clamped;
+  result->threads = params.threads;
+  result->seconds =
+      (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  result->paths_per_sec =
+      result->seconds > 0 ? sketch->count / result->seconds : 0;
+
+  free(workers);
+  free(ids);
+  free(created);
+  free(sums);
+  return MC_OK;
+}
@@ -0,0 +1,39 @@
+#ifndef S21_AGGREGATE_H
+#define S21_AGGREGATE_H
+
+#include <stddef.h>
+
+#include "s21_compiler.h"
+
+#define AGGREGATE_CHUNK 65536
+#define AGGREGATE_PARALLEL_MIN (1 << 20)
+#define AGGREGATE_MAX_TERMS 1e10
+#define AGGREGATE_MIN_PANELS 16
+#define AGGREGATE_MAX_PANELS (1 << 16)
+#define AGGREGATE_TOLERANCE 1e-13
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum aggregate_kind {
+  AGGREGATE_NONE,
+  AGGREGATE_SUM,
+  AGGREGATE_PROD,
+  AGGREGATE_INTEGRAL
+};
+
+int s21_aggregate_kind(const char *name);
+int s21_compile_series(const char *index, const char *body,
+                       compiled_expr *compiled);
+int s21_eval_series(const compiled_expr *body, int kind, double from,
+                    double to, int threads, const calc_cancel_flag *cancel,
+                    double *result);
+int s21_eval_integral(const compiled_expr *body, double a, double b,
+                      const calc_cancel_flag *cancel, double *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_AGGREGATE_H
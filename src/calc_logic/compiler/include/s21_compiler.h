@@ -0,0 +1,80 @@
+#ifndef S21_COMPILER_H
+#define S21_COMPILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../translator/include/translator.h"
+
+#define EXPR_BLOCK 256
+#define EXPR_FUNC_COUNT 9
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef double (*math_func_ptr)(double);
+
+enum expr_opcode {
+  OP_CONST,
+  OP_X,
+  OP_ADD,
+  OP_SUB,
+  OP_MUL,
+  OP_DIV,
+  OP_POW,
+  OP_NEG,
+  OP_FUNC,
+  OP_PARAM
+};
+
+/**
+ * @brief An instruction of a compiled program. Tokens hold indices instead of
+ * pointers, so a program is a position-independent block of memory.
+ */
+typedef struct expr_token {
+  uint8_t op;
+  uint8_t func;
+  uint16_t slot;
+  uint32_t literal;
+} expr_token;
+
+/**
+ * @brief Expression of the variable x compiled into a postfix program. The
+ * tokens and the literal pool share one allocation, so a typical formula
+ * fits in one or two cache lines.
+ *
+ * slot is the stack row an instruction writes, a binary operator also reads
+ * the row above it, func indexes the function table and literal indexes
+ * literals. Programs taken from a precompiled file point into its mapping
+ * and are not freed with s21_clear_compiled().
+ *
+ * fast_math_ulps opts in to the inline approximations of s21_fast_math.h:
+ * the evaluators use them for sin, cos and tan, the ones faster than libm,
+ * when their error bound is at most that many ulps. 0, as compiled, keeps
+ * libm.
+ */
+typedef struct compiled_expr {
+  int count;
+  int depth;
+  int literals_count;
+  int fast_math_ulps;
+  const expr_token *code;
+  const double *literals;
+} compiled_expr;
+
+int s21_compile_expr(const char *expr, compiled_expr *compiled);
+double s21_eval_compiled(const compiled_expr *compiled, double x);
+double s21_eval_compiled_with(const compiled_expr *compiled, double x,
+                              const double *params);
+int s21_eval_compiled_batch(const compiled_expr *compiled, const double *x,
+                            double *y, size_t count);
+math_func_ptr s21_compiled_func(int func);
+const char *s21_compiled_func_name(int func);
+void s21_clear_compiled(compiled_expr *compiled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_COMPILER_H
@@ -0,0 +1,59 @@
+#ifndef S21_EXPR_BATCH_H
+#define S21_EXPR_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "s21_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A distinct subexpression of a batch. It writes the stack row slot
+ * and reads the rows a and b, b is the literal of a constant instead.
+ */
+typedef struct batch_node {
+  uint8_t op;
+  uint8_t func;
+  uint32_t slot;
+  uint32_t a;
+  uint32_t b;
+} batch_node;
+
+/**
+ * @brief Expression expr of the batch is the value of node.
+ */
+typedef struct batch_output {
+  uint32_t node;
+  uint32_t expr;
+} batch_output;
+
+/**
+ * @brief Expressions of x compiled into one DAG in which every distinct
+ * subexpression is a single node. instructions is what the expressions
+ * compiled one by one would execute per value, nodes_count what the batch
+ * executes.
+ */
+typedef struct compiled_batch {
+  int count;
+  int nodes_count;
+  int slots;
+  long instructions;
+  const batch_node *nodes;
+  const batch_output *outputs;
+  const double *literals;
+} compiled_batch;
+
+int s21_compile_batch(const char *const *exprs, int count,
+                      compiled_batch *batch, int *failed);
+int s21_eval_batch(const compiled_batch *batch, const double *x, double *y,
+                   size_t rows);
+void s21_clear_batch(compiled_batch *batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_EXPR_BATCH_H
@@ -0,0 +1,396 @@
+#ifndef S21_FAST_MATH_H
+#define S21_FAST_MATH_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Error bounds of the approximations against the exact result, in units in
+ * the last place, as checked by the sampled accuracy test. */
+#define FAST_MATH_ULPS_SIN 2
+#define FAST_MATH_ULPS_COS 2
+#define FAST_MATH_ULPS_TAN 4
+#define FAST_MATH_ULPS_ATAN 1
+#define FAST_MATH_ULPS_ASIN 1
+#define FAST_MATH_ULPS_ACOS 1
+#define FAST_MATH_ULPS_SQRT 1
+#define FAST_MATH_ULPS_LOG 2
+#define FAST_MATH_ULPS_LOG10 3
+
+/* Arguments of sin, cos and tan up to 2^19 * pi/2 are reduced inline,
+ * larger ones by libm. */
+#define FAST_MATH_TRIG_MAX 823549.6
+
+#define FAST_MATH_ROUND 0x1.8p52
+#define FAST_MATH_INV_PIO2 6.36619772367581382433e-01
+#define FAST_MATH_PIO2_1 1.57079632673412561417e+00
+#define FAST_MATH_PIO2_2 6.07710050630396597660e-11
+#define FAST_MATH_PIO2_2T 2.02226624879595063154e-21
+#define FAST_MATH_PIO2_3 2.02226624871116645580e-21
+#define FAST_MATH_PIO2_3T 8.47842766036889956997e-32
+#define FAST_MATH_PIO2_HI 1.57079632679489655800e+00
+#define FAST_MATH_PIO2_LO 6.12323399573676603587e-17
+#define FAST_MATH_PIO4_HI 7.85398163397448278999e-01
+#define FAST_MATH_PI 3.14159265358979311600e+00
+#define FAST_MATH_LN2_HI 6.93147180369123816490e-01
+#define FAST_MATH_LN2_LO 1.90821492927058770002e-10
+#define FAST_MATH_IVLN10 4.34294481903251816668e-01
+#define FAST_MATH_LOG10_2HI 3.01029995663611771306e-01
+#define FAST_MATH_LOG10_2LO 3.69423907715893078616e-13
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reduce x to y0 + y1 in [-pi/4, pi/4] by a multiple n of pi/2 in
+ * three steps of 33 bits of pi/2, the Cody-Waite scheme of fdlibm, and
+ * return n & 3. Adding 1.5 * 2^52 rounds to the nearest integer, which
+ * ends up in the low bits of the mantissa, so there is no conversion that
+ * could overflow outside of the domain.
+ */
+static inline int s21_fast_reduce(double x, double *y0, double *y1) {
+  double rounded = x * FAST_MATH_INV_PIO2 + FAST_MATH_ROUND;
+  uint64_t bits = 0;
+  memcpy(&bits, &rounded, sizeof(bits));
+  double fn = rounded - FAST_MATH_ROUND;
+  double r = x - fn * FAST_MATH_PIO2_1;
+  double t = r;
+  double w = fn * FAST_MATH_PIO2_2;
+  r = t - w;
+  w = fn * FAST_MATH_PIO2_2T - ((t - r) - w);
+  t = r;
+  w = fn * FAST_MATH_PIO2_3;
+  r = t - w;
+  w = fn * FAST_MATH_PIO2_3T - ((t - r) - w);
+  *y0 = r - w;
+  *y1 = (r - *y0) - w;
+  return (int)(bits & 3);
+}
+
+/**
+ * @brief sin(x + y) on [-pi/4, pi/4], y being the tail of x: the minimax
+ * polynomial of fdlibm.
+ */
+static inline double s21_fast_sin_kernel(double x, double y) {
+  double z = x * x;
+  double v = z * x;
+  double r = 8.33333333332248946124e-03 +
+             z * (-1.98412698298579493134e-04 +
+                  z * (2.75573137070700676789e-06 +
+                       z * (-2.50507602534068634195e-08 +
+                            z * 1.58969099521155010221e-10)));
+  return x - ((z * (0.5 * y - v * r) - y) - v * -1.66666666666666324348e-01);
+}
+
+/**
+ * @brief cos(x + y) on [-pi/4, pi/4], y being the tail of x: the minimax
+ * polynomial of fdlibm.
+ */
+static inline double s21_fast_cos_kernel(double x, double y) {
+  double z = x * x;
+  double r = z * (4.16666666666666019037e-02 +
+                  z * (-1.38888888888741095749e-03 +
+                       z * (2.48015872894767294178e-05 +
+                            z * (-2.75573143513906633035e-07 +
+                                 z * (2.08757232129817482790e-09 +
+                                      z * -1.13596475577881948265e-11)))));
+  double hz = 0.5 * z;
+  double w = 1 - hz;
+  return w + (((1 - w) - hz) + (z * r - x * y));
+}
+
+/**
+ * @brief (quadrant & 1) ? b : a, and x negated if quadrant & 2, with bit
+ * operations: a branch on the quadrant of a random argument mispredicts
+ * half of the time.
+ */
+static inline double s21_fast_select(int quadrant, double a, double b) {
+  uint64_t bits_a = 0;
+  uint64_t bits_b = 0;
+  memcpy(&bits_a, &a, sizeof(bits_a));
+  memcpy(&bits_b, &b, sizeof(bits_b));
+  uint64_t mask = 0 - (uint64_t)(quadrant & 1);
+  bits_a = (bits_a & ~mask) | (bits_b & mask);
+  memcpy(&a, &bits_a, sizeof(bits_a));
+  return a;
+}
+
+static inline double s21_fast_negate(int quadrant, double x) {
+  uint64_t bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  bits ^= (uint64_t)(quadrant & 2) << 62;
+  memcpy(&x, &bits, sizeof(bits));
+  return x;
+}
+
+/**
+ * @brief a < b for unsigned 64-bit a and b as 0 or 1, without a compare:
+ * SSE2 has no 64-bit integer compare, and a compare of doubles turned into
+ * a mask keeps the compiler from vectorizing a loop.
+ */
+static inline int s21_fast_below(uint64_t a, uint64_t b) {
+  return (int)(((~a & b) | (~(a ^ b) & (a - b))) >> 63);
+}
+
+/* The cores below hold no calls, so a loop over them keeps its constants
+ * in registers. They are accurate only inside the domain of the function;
+ * s21_fast_sin() and the others take libm outside of it. */
+
+static inline int s21_fast_trig_domain(double x) {
+  return fabs(x) <= FAST_MATH_TRIG_MAX;
+}
+
+static inline double s21_fast_sin_core(double x) {
+  double y0 = 0;
+  double y1 = 0;
+  int n = s21_fast_reduce(x, &y0, &y1);
+  double res = s21_fast_select(n, s21_fast_sin_kernel(y0, y1),
+                               s21_fast_cos_kernel(y0, y1));
+  return s21_fast_negate(n, res);
+}
+
+static inline double s21_fast_cos_core(double x) {
+  double y0 = 0;
+  double y1 = 0;
+  int n = s21_fast_reduce(x, &y0, &y1);
+  double res = s21_fast_select(n, s21_fast_cos_kernel(y0, y1),
+                               s21_fast_sin_kernel(y0, y1));
+  return s21_fast_negate(n + 1, res);
+}
+
+static inline double s21_fast_tan_core(double x) {
+  double y0 = 0;
+  double y1 = 0;
+  int n = s21_fast_reduce(x, &y0, &y1);
+  double s = s21_fast_sin_kernel(y0, y1);
+  double c = s21_fast_cos_kernel(y0, y1);
+  double res = s21_fast_select(n, s, c) / s21_fast_select(n, c, s);
+  return s21_fast_negate(n << 1, res);
+}
+
+static inline double s21_fast_sin(double x) {
+  return s21_fast_trig_domain(x) ? s21_fast_sin_core(x) : sin(x);
+}
+
+static inline double s21_fast_cos(double x) {
+  return s21_fast_trig_domain(x) ? s21_fast_cos_core(x) : cos(x);
+}
+
+static inline double s21_fast_tan(double x) {
+  return s21_fast_trig_domain(x) ? s21_fast_tan_core(x) : tan(x);
+}
+
+/**
+ * @brief atan(x) of fdlibm: the argument is reduced to |x| < 7/16 around
+ * one of four breakpoints whose arctangents are stored in two parts. The
+ * breakpoint is chosen by s21_fast_select() instead of branches; below 7/16
+ * it is 0 with both parts zero, which gives the same result.
+ */
+static inline double s21_fast_atan(double x) {
+  double a = fabs(x);
+  uint64_t bits = 0;
+  memcpy(&bits, &a, sizeof(bits));
+  int id0 = s21_fast_below(bits, 0x3fdc000000000000ull) ^ 1;
+  int id1 = s21_fast_below(bits, 0x3fe6000000000000ull) ^ 1;
+  int id2 = s21_fast_below(bits, 0x3ff3000000000000ull) ^ 1;
+  int id3 = s21_fast_below(bits, 0x4003800000000000ull) ^ 1;
+  double num = s21_fast_select(id0, a, 2 * a - 1);
+  num = s21_fast_select(id1, num, a - 1);
+  num = s21_fast_select(id2, num, a - 1.5);
+  num = s21_fast_select(id3, num, -1);
+  double den = s21_fast_select(id0, 1, 2 + a);
+  den = s21_fast_select(id1, den, a + 1);
+  den = s21_fast_select(id2, den, 1 + 1.5 * a);
+  den = s21_fast_select(id3, den, a);
+  double hi = s21_fast_select(id0, 0, 4.63647609000806093515e-01);
+  hi = s21_fast_select(id1, hi, 7.85398163397448278999e-01);
+  hi = s21_fast_select(id2, hi, 9.82793723247329054082e-01);
+  hi = s21_fast_select(id3, hi, 1.57079632679489655800e+00);
+  double lo = s21_fast_select(id0, 0, 2.26987774529616870924e-17);
+  lo = s21_fast_select(id1, lo, 3.06161699786838301793e-17);
+  lo = s21_fast_select(id2, lo, 1.39033110312309984516e-17);
+  lo = s21_fast_select(id3, lo, 6.12323399573676603587e-17);
+  a = num / den;
+  double z = a * a;
+  double w = z * z;
+  double s1 = z * (3.33333333333329318027e-01 +
+                   w * (1.42857142725034663711e-01 +
+                        w * (9.09088713343650656196e-02 +
+                             w * (6.66107313738753120669e-02 +
+                                  w * (4.97687799461593236017e-02 +
+                                       w * 1.62858201153657823623e-02)))));
+  double s2 = w * (-1.99999999998764832476e-01 +
+                   w * (-1.11111104054623557880e-01 +
+                        w * (-7.69187620504482999495e-02 +
+                             w * (-5.83357013379057348645e-02 +
+                                  w * -3.65315727442169155270e-02))));
+  return copysign(hi - ((a * (s1 + s2) - lo) - a), x);
+}
+
+/**
+ * @brief The rational approximation of fdlibm behind asin and acos:
+ * asin(sqrt(t)) / sqrt(t) - 1 for t in [0, 1/4].
+ */
+static inline double s21_fast_asin_rational(double t) {
+  double p = t * (1.66666666666666657415e-01 +
+                  t * (-3.25565818622400915405e-01 +
+                       t * (2.01212532134862925881e-01 +
+                            t * (-4.00555345006794114027e-02 +
+                                 t * (7.91534994289814532176e-04 +
+                                      t * 3.47933107596021167570e-05)))));
+  double q = 1 + t * (-2.40339491173441421878e+00 +
+                      t * (2.02094576023350569471e+00 +
+                           t * (-6.88283971605453293030e-01 +
+                                t * 7.70381505559019352791e-02)));
+  return p / q;
+}
+
+/**
+ * @brief x with the low 32 bits of the mantissa cleared, so its square is
+ * exact.
+ */
+static inline double s21_fast_high_part(double x) {
+  uint64_t bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  bits &= 0xffffffff00000000ull;
+  memcpy(&x, &bits, sizeof(bits));
+  return x;
+}
+
+static inline int s21_fast_asin_domain(double x) { return fabs(x) < 1; }
+
+static inline double s21_fast_asin_core(double x) {
+  double a = s21_fast_asin_domain(x) ? fabs(x) : 0;
+  if (a < 0.5) return x + x * s21_fast_asin_rational(x * x);
+  double t = 0.5 * (1 - a);
+  double s = sqrt(t);
+  double r = s21_fast_asin_rational(t);
+  double res = 0;
+  if (a >= 0.975) {
+    res = FAST_MATH_PIO2_HI - (2 * (s + s * r) - FAST_MATH_PIO2_LO);
+  } else {
+    double w = s21_fast_high_part(s);
+    double c = (t - w * w) / (s + w);
+    double p = 2 * s * r - (FAST_MATH_PIO2_LO - 2 * c);
+    res = FAST_MATH_PIO4_HI - (p - (FAST_MATH_PIO4_HI - 2 * w));
+  }
+  return copysign(res, x);
+}
+
+static inline double s21_fast_acos_core(double x) {
+  double res = 0;
+  if (!s21_fast_asin_domain(x)) {
+    res = NAN;
+  } else if (fabs(x) < 0.5) {
+    double r = s21_fast_asin_rational(x * x);
+    res = FAST_MATH_PIO2_HI - (x - (FAST_MATH_PIO2_LO - x * r));
+  } else if (x < 0) {
+    double z = 0.5 * (1 + x);
+    double s = sqrt(z);
+    double w = s21_fast_asin_rational(z) * s - FAST_MATH_PIO2_LO;
+    res = FAST_MATH_PI - 2 * (s + w);
+  } else {
+    double z = 0.5 * (1 - x);
+    double s = sqrt(z);
+    double df = s21_fast_high_part(s);
+    double c = (z - df * df) / (s + df);
+    res = 2 * (df + (s21_fast_asin_rational(z) * s + c));
+  }
+  return res;
+}
+
+static inline double s21_fast_asin(double x) {
+  return s21_fast_asin_domain(x) ? s21_fast_asin_core(x) : asin(x);
+}
+
+static inline double s21_fast_acos(double x) {
+  return s21_fast_asin_domain(x) ? s21_fast_acos_core(x) : acos(x);
+}
+
+/**
+ * @brief sqrt() is a single instruction once the compiler inlines it, which
+ * a call through the function table prevents.
+ */
+static inline double s21_fast_sqrt(double x) { return sqrt(x); }
+
+/**
+ * @brief Split a positive finite x into 2^k * (1 + f) with 1 + f in
+ * [sqrt(2)/2, sqrt(2)) and return log(1 + f), the polynomial of fdlibm in
+ * s = f / (2 + f). Subnormals are scaled by a select, and k is built from
+ * the exponent bits, so the compiler can vectorize it.
+ */
+static inline double s21_fast_log_reduce(double x, double *k) {
+  uint64_t bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  int subnormal = s21_fast_below(bits, 0x0010000000000000ull);
+  x *= s21_fast_select(subnormal, 1, 0x1p54);
+  memcpy(&bits, &x, sizeof(bits));
+  bits += (uint64_t)(0x3ff00000 - 0x3fe6a09e) << 32;
+  uint64_t exponent = 0x4330000000000000ull | bits >> 52;
+  double e = 0;
+  memcpy(&e, &exponent, sizeof(e));
+  *k = e - 0x1p52 - 0x3ff - s21_fast_select(subnormal, 0, 54);
+  bits = (bits & 0x000fffffffffffffull) + ((uint64_t)0x3fe6a09e << 32);
+  memcpy(&x, &bits, sizeof(bits));
+
+  double f = x - 1;
+  double s = f / (2 + f);
+  double z = s * s;
+  double w = z * z;
+  double t1 = w * (3.999999999940941908e-01 +
+                   w * (2.222219843214978396e-01 +
+                        w * 1.531383769920937332e-01));
+  double t2 = z * (6.666666666666735130e-01 +
+                   w * (2.857142874366239149e-01 +
+                        w * (1.818357216161805012e-01 +
+                             w * 1.479819860511658591e-01)));
+  double hfsq = 0.5 * f * f;
+  return f - (hfsq - s * (hfsq + t1 + t2));
+}
+
+static inline int s21_fast_log_domain(double x) {
+  return x > 0 && x < INFINITY;
+}
+
+/* 1 for the positive finite x of s21_fast_log_domain(), from the bits. */
+static inline int s21_fast_log_bits_domain(double x) {
+  uint64_t bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  return s21_fast_below(bits - 1, 0x7fefffffffffffffull);
+}
+
+static inline double s21_fast_log_core(double x) {
+  double k = 0;
+  int slow = !s21_fast_log_bits_domain(x);
+  double lm = s21_fast_log_reduce(s21_fast_select(slow, x, 1), &k);
+  return k * FAST_MATH_LN2_HI + (lm + k * FAST_MATH_LN2_LO);
+}
+
+static inline double s21_fast_log10_core(double x) {
+  double k = 0;
+  int slow = !s21_fast_log_bits_domain(x);
+  double lm = s21_fast_log_reduce(s21_fast_select(slow, x, 1), &k);
+  return k * FAST_MATH_LOG10_2HI +
+         (k * FAST_MATH_LOG10_2LO + lm * FAST_MATH_IVLN10);
+}
+
+static inline double s21_fast_log(double x) {
+  return s21_fast_log_domain(x) ? s21_fast_log_core(x) : log(x);
+}
+
+static inline double s21_fast_log10(double x) {
+  return s21_fast_log_domain(x) ? s21_fast_log10_core(x) : log10(x);
+}
+
+int s21_fast_math_ulps(int func);
+int s21_fast_math_enabled(int func, int max_ulps);
+double s21_fast_math_func(int func, double x);
+void s21_fast_math_block(int func, double *values, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_FAST_MATH_H
@@ -0,0 +1,63 @@
+#ifndef S21_FUNCTIONS_H
+#define S21_FUNCTIONS_H
+
+#include <stdint.h>
+
+#include "s21_compiler.h"
+
+#define FUNC_MAX_DEFS 64
+#define FUNC_MAX_PARAMS 4
+#define FUNC_NAME_SIZE 16
+#define FUNC_MAX_LEN 255
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum user_func_state { FUNC_EMPTY, FUNC_STALE, FUNC_BUILDING, FUNC_READY };
+
+/**
+ * @brief A user-defined function such as f(x,y)=x^2+y. program is the body
+ * with the calls already inlined and the parameters left as OP_PARAM
+ * tokens, calls holds a bit for every function of the registry the body
+ * calls.
+ */
+typedef struct user_func {
+  char name[FUNC_NAME_SIZE];
+  char params[FUNC_MAX_PARAMS][FUNC_NAME_SIZE];
+  int params_count;
+  char body[FUNC_MAX_LEN + 1];
+  int state;
+  int status;
+  uint64_t calls;
+  compiled_expr program;
+} user_func;
+
+/**
+ * @brief Named functions that expressions compiled with the registry may
+ * call. generation changes whenever a function changes, so programs
+ * compiled before that have to be compiled again.
+ */
+typedef struct func_registry {
+  user_func funcs[FUNC_MAX_DEFS];
+  uint32_t generation;
+} func_registry;
+
+func_registry *s21_create_registry(void);
+int s21_define_func(func_registry *registry, const char *definition);
+int s21_undefine_func(func_registry *registry, const char *name);
+int s21_func_status(const func_registry *registry, const char *name);
+int s21_find_func(const func_registry *registry, const char *name);
+void s21_clear_registry(func_registry *registry);
+
+int s21_compile_expr_with(const char *expr, const func_registry *registry,
+                          compiled_expr *compiled);
+int s21_compile_body(const char *expr, const func_registry *registry,
+                     const char (*params)[FUNC_NAME_SIZE], int params_count,
+                     compiled_expr *compiled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_FUNCTIONS_H
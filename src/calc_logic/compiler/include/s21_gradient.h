@@ -0,0 +1,29 @@
+#ifndef S21_GRADIENT_H
+#define S21_GRADIENT_H
+
+#include <stddef.h>
+
+#include "s21_compiler.h"
+
+#define GRADIENT_MAX_VARS 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t s21_gradient_scratch(const compiled_expr *compiled, int params_count);
+int s21_eval_gradient(const compiled_expr *compiled, double x,
+                      const double *params, int params_count, double *value,
+                      double *gradient);
+int s21_eval_gradient_into(const compiled_expr *compiled, double x,
+                           const double *params, int params_count,
+                           double *value, double *gradient, double *scratch);
+int s21_eval_gradient_batch(const compiled_expr *compiled, const double *x,
+                            const double *params, int params_count,
+                            double *y, double *gradient, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_GRADIENT_H
@@ -0,0 +1,32 @@
+#ifndef S21_ROOTS_H
+#define S21_ROOTS_H
+
+#include <stddef.h>
+
+#include "s21_compiler.h"
+
+#define ROOTS_SCAN_POINTS 257
+#define ROOTS_MAX_ITER 100
+#define ROOTS_MIN_TOLERANCE 1.5e-8
+#define ROOTS_PARALLEL_MIN 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum root_kind { ROOT_NONE, ROOT_SOLVE, ROOT_MINIMIZE };
+
+int s21_root_kind(const char *name);
+int s21_solve_expr(const compiled_expr *compiled, double a, double b,
+                   double *roots, int max_roots, int *count);
+int s21_minimize_expr(const compiled_expr *compiled, double a, double b,
+                      double *x, double *y);
+int s21_solve_batch(const compiled_expr *programs, const double *a,
+                    const double *b, double *roots, size_t count,
+                    int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_ROOTS_H
@@ -0,0 +1,350 @@
+/**
+ * @file
+ * @brief Contains sums, products and integrals of compiled expressions,
+ * evaluated in blocks and reduced in an order that does not depend on the
+ * number of threads
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_aggregate.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "include/s21_functions.h"
+
+#define AGGREGATE_PAIRWISE_LEAF 8
+#define AGGREGATE_GAUSS_POINTS 5
+
+/* The 5-point Gauss-Legendre rule on [-1, 1]. */
+static const double s21_gauss_nodes[AGGREGATE_GAUSS_POINTS] = {
+    -0.906179845938663992797626878299, -0.538469310105683091036314420700, 0,
+    0.538469310105683091036314420700, 0.906179845938663992797626878299};
+static const double s21_gauss_weights[AGGREGATE_GAUSS_POINTS] = {
+    0.236926885056189087514264040720, 0.478628670499366468041291514836,
+    0.568888888888888888888888888889, 0.478628670499366468041291514836,
+    0.236926885056189087514264040720};
+
+/**
+ * @brief Chunks of a series computed by one thread: first, first + step
+ * and so on.
+ */
+typedef struct series_worker {
+  const compiled_expr *body;
+  int kind;
+  double from;
+  long long terms;
+  long long chunks;
+  long long first;
+  int step;
+  double *results;
+  double *x;
+  double *y;
+  const calc_cancel_flag *cancel;
+  int status;
+} series_worker;
+
+/**
+ * @brief Name of an aggregate the parser evaluates through compiled
+ * programs.
+ *
+ * @return AGGREGATE_SUM, AGGREGATE_PROD, AGGREGATE_INTEGRAL or
+ * AGGREGATE_NONE.
+ */
+int s21_aggregate_kind(const char *name) {
+  int res = AGGREGATE_NONE;
+  if (name && !strcmp(name, "sum")) {
+    res = AGGREGATE_SUM;
+  } else if (name && !strcmp(name, "prod")) {
+    res = AGGREGATE_PROD;
+  } else if (name && !strcmp(name, "integral")) {
+    res = AGGREGATE_INTEGRAL;
+  }
+  return res;
+}
+
+/**
+ * @brief Compile the body of a series as a program of x that takes the
+ * index, so it runs on the batch evaluator.
+ *
+ * @param index Name of the index, e.g. "i".
+ * @param body The body, e.g. "1/i^2".
+ * @param compiled Output for the program, to be freed with
+ * s21_clear_compiled().
+ * @return VALID_OK, the error of the body, or UNKNOWN_FUNC if it uses x
+ * while x is not the index.
+ */
+int s21_compile_series(const char *index, const char *body,
+                       compiled_expr *compiled) {
+  if (!index || !body || !compiled) return NULL_PTR;
+  memset(compiled, 0, sizeof(compiled_expr));
+  if (strlen(index) >= FUNC_NAME_SIZE) return INVALID_EXPRESSION;
+  if (!strcmp(index, "x")) return s21_compile_expr(body, compiled);
+
+  char params[1][FUNC_NAME_SIZE] = {{0}};
+  strcpy(params[0], index);
+  compiled_expr program;
+  int res = s21_compile_body(body, NULL, (const char(*)[FUNC_NAME_SIZE])params,
+                             1, &program);
+  expr_token *code = NULL;
+  if (res == VALID_OK) {
+    code = malloc(program.count * sizeof(expr_token) +
+                  program.literals_count * sizeof(double));
+    if (!code) res = NULL_PTR;
+  }
+  for (int i = 0; res == VALID_OK && i < program.count; i++) {
+    code[i] = program.code[i];
+    if (code[i].op == OP_X) res = UNKNOWN_FUNC;
+    if (code[i].op == OP_PARAM) {
+      code[i] = (expr_token){OP_X, 0, code[i].slot, 0};
+    }
+  }
+  if (res == VALID_OK) {
+    double *literals = (double *)(code + program.count);
+    memcpy(literals, program.literals,
+           program.literals_count * sizeof(double));
+    *compiled = program;
+    compiled->code = code;
+    compiled->literals = literals;
+  } else {
+    free(code);
+  }
+  s21_clear_compiled(&program);
+  return res;
+}
+
+/**
+ * @brief Sum or multiply values pairwise, so the rounding error grows with
+ * the logarithm of their number.
+ */
+static double s21_pairwise(const double *values, size_t count, int kind) {
+  double res = kind == AGGREGATE_PROD;
+  if (count <= AGGREGATE_PAIRWISE_LEAF) {
+    for (size_t i = 0; i < count; i++) {
+      res = kind == AGGREGATE_PROD ? res * values[i] : res + values[i];
+    }
+  } else {
+    double a = s21_pairwise(values, count / 2, kind);
+    double b = s21_pairwise(values + count / 2, count - count / 2, kind);
+    res = kind == AGGREGATE_PROD ? a * b : a + b;
+  }
+  return res;
+}
+
+/**
+ * @brief Neumaier's compensated sum of the results of the chunks.
+ */
+static double s21_compensated_sum(const double *values, long long count) {
+  double sum = 0;
+  double compensation = 0;
+  for (long long i = 0; i < count; i++) {
+    double next = sum + values[i];
+    if (fabs(sum) >= fabs(values[i])) {
+      compensation += (sum - next) + values[i];
+    } else {
+      compensation += (values[i] - next) + sum;
+    }
+    sum = next;
+  }
+  return isfinite(sum) ? sum + compensation : sum;
+}
+
+/**
+ * @brief Whether the caller asked to stop, read once per chunk or estimate.
+ */
+static int s21_cancelled(const calc_cancel_flag *cancel) {
+  return cancel && atomic_load_explicit(cancel, memory_order_relaxed);
+}
+
+static void *s21_series_worker(void *arg) {
+  series_worker *worker = arg;
+  for (long long chunk = worker->first;
+       worker->status == VALID_OK && chunk < worker->chunks;
+       chunk += worker->step) {
+    if (s21_cancelled(worker->cancel)) {
+      worker->status = CANCELLED;
+      break;
+    }
+    long long begin = chunk * AGGREGATE_CHUNK;
+    size_t count = worker->terms - begin < AGGREGATE_CHUNK
+                       ? (size_t)(worker->terms - begin)
+                       : AGGREGATE_CHUNK;
+    for (size_t i = 0; i < count; i++) {
+      worker->x[i] = worker->from + (double)(begin + (long long)i);
+    }
+    worker->status =
+        s21_eval_compiled_batch(worker->body, worker->x, worker->y, count);
+    worker->results[chunk] = s21_pairwise(worker->y, count, worker->kind);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Run the chunks of a series, one worker per thread, the calling
+ * thread included.
+ */
+static int s21_run_series(series_worker *workers, int threads) {
+  pthread_t ids[threads];
+  int created[threads];
+  for (int i = 1; i < threads; i++) {
+    created[i] = !pthread_create(&ids[i], NULL, s21_series_worker,
+                                 &workers[i]);
+  }
+  s21_series_worker(&workers[0]);
+  int res = workers[0].status;
+  for (int i = 1; i < threads; i++) {
+    if (created[i]) {
+      pthread_join(ids[i], NULL);
+    } else {
+      s21_series_worker(&workers[i]);
+    }
+    if (res == VALID_OK) res = workers[i].status;
+  }
+  return res;
+}
+
+/**
+ * @brief Sum or multiply a compiled body over the index from, from + 1, ...
+ * up to to.
+ *
+ * The index range is cut into chunks of AGGREGATE_CHUNK terms. A chunk is
+ * evaluated in blocks and reduced pairwise, and the chunk results are
+ * combined in order, with compensation for sums. The result is the same
+ * for any number of threads and stays accurate over 10^9 terms.
+ *
+ * @param body Program of the index as x, from s21_compile_series().
+ * @param kind AGGREGATE_SUM or AGGREGATE_PROD.
+ * @param from The first index.
+ * @param to The last index.
+ * @param threads Maximum number of threads, <= 0 uses all cores; series
+ * shorter than AGGREGATE_PARALLEL_MIN run on the calling thread.
+ * @param cancel Flag set by another thread to stop the series, checked
+ * before every chunk, or NULL.
+ * @param result Output for the result: 0 for an empty sum, 1 for an empty
+ * product, NAN for NAN bounds.
+ * @return VALID_OK, STR_OVERFLOW for more than AGGREGATE_MAX_TERMS terms,
+ * CANCELLED if the flag was set, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_eval_series(const compiled_expr *body, int kind, double from,
+                    double to, int threads, const calc_cancel_flag *cancel,
+                    double *result) {
+  if (!body || !body->code || !result ||
+      (kind != AGGREGATE_SUM && kind != AGGREGATE_PROD)) {
+    return NULL_PTR;
+  }
+  double span = floor(to - from) + 1;
+  if (isnan(span)) {
+    *result = NAN;
+    return VALID_OK;
+  }
+  if (span > AGGREGATE_MAX_TERMS) return STR_OVERFLOW;
+  long long terms = span > 0 ? (long long)span : 0;
+  long long chunks = (terms + AGGREGATE_CHUNK - 1) / AGGREGATE_CHUNK;
+  if (!terms) {
+    *result = kind == AGGREGATE_PROD;
+    return VALID_OK;
+  }
+
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads <= 0 || terms < AGGREGATE_PARALLEL_MIN) threads = 1;
+  if (threads > chunks) threads = (int)chunks;
+  double *results = malloc(chunks * sizeof(double));
+  double *buffers = malloc(2 * (size_t)threads * AGGREGATE_CHUNK *
+                           sizeof(double));
+  series_worker *workers = calloc(threads, sizeof(series_worker));
+  int res = results && buffers && workers ? VALID_OK : NULL_PTR;
+
+  for (int i = 0; res == VALID_OK && i < threads; i++) {
+    double *x = buffers + 2 * (size_t)i * AGGREGATE_CHUNK;
+    workers[i] = (series_worker){body,    kind,   from,    terms,
+                                 chunks,  i,      threads, results,
+                                 x,       x + AGGREGATE_CHUNK, cancel,
+                                 VALID_OK};
+  }
+  if (res == VALID_OK) res = s21_run_series(workers, threads);
+  if (res == VALID_OK && kind == AGGREGATE_SUM) {
+    *result = s21_compensated_sum(results, chunks);
+  } else if (res == VALID_OK) {
+    *result = 1;
+    for (long long i = 0; i < chunks; i++) *result *= results[i];
+  }
+  free(results);
+  free(buffers);
+  free(workers);
+  return res;
+}
+
+/**
+ * @brief Apply the Gauss-Legendre rule on panels of equal width.
+ */
+static int s21_gauss(const compiled_expr *body, double a, double b,
+                     int panels, double *x, double *y, double *result) {
+  double width = (b - a) / panels;
+  size_t count = (size_t)panels * AGGREGATE_GAUSS_POINTS;
+  for (int p = 0; p < panels; p++) {
+    for (int k = 0; k < AGGREGATE_GAUSS_POINTS; k++) {
+      x[p * AGGREGATE_GAUSS_POINTS + k] =
+          a + width * (p + 0.5 + 0.5 * s21_gauss_nodes[k]);
+    }
+  }
+  int res = s21_eval_compiled_batch(body, x, y, count);
+  for (size_t i = 0; i < count; i++) {
+    y[i] *= s21_gauss_weights[i % AGGREGATE_GAUSS_POINTS];
+  }
+  *result = s21_pairwise(y, count, AGGREGATE_SUM) * width / 2;
+  return res;
+}
+
+/**
+ * @brief Integrate a compiled expression of x from a to b. The number of
+ * panels of a 5-point Gauss-Legendre rule is doubled until two estimates
+ * agree to AGGREGATE_TOLERANCE or AGGREGATE_MAX_PANELS is reached, every
+ * estimate being one batch evaluation.
+ *
+ * @param body Program of x.
+ * @param a The lower bound.
+ * @param b The upper bound.
+ * @param cancel Flag set by another thread to stop the integration, checked
+ * before every estimate, or NULL.
+ * @param result Output for the integral, NAN for infinite bounds or an
+ * integrand that is not defined on the interval.
+ * @return VALID_OK on success, CANCELLED if the flag was set, NULL_PTR on
+ * invalid arguments or allocation failure.
+ */
+int s21_eval_integral(const compiled_expr *body, double a, double b,
+                      const calc_cancel_flag *cancel, double *result) {
+  if (!body || !body->code || !result) return NULL_PTR;
+  if (!isfinite(a) || !isfinite(b) || a == b) {
+    *result = a == b ? 0 : NAN;
+    return VALID_OK;
+  }
+
+  size_t size = (size_t)AGGREGATE_MAX_PANELS * AGGREGATE_GAUSS_POINTS;
+  double *x = malloc(2 * size * sizeof(double));
+  if (!x) return NULL_PTR;
+  double *y = x + size;
+
+  double estimate = NAN;
+  int res = s21_gauss(body, a, b, AGGREGATE_MIN_PANELS, x, y, &estimate);
+  int done = isnan(estimate);
+  for (int panels = 2 * AGGREGATE_MIN_PANELS;
+       res == VALID_OK && !done && panels <= AGGREGATE_MAX_PANELS;
+       panels *= 2) {
+    double next = NAN;
+    if (s21_cancelled(cancel)) {
+      res = CANCELLED;
+      break;
+    }
+    res = s21_gauss(body, a, b, panels, x, y, &next);
+    done = isnan(next) || fabs(next - estimate) <=
+                              AGGREGATE_TOLERANCE * fmax(1, fabs(next));
+    estimate = next;
+  }
+  if (res == VALID_OK) *result = estimate;
+  free(x);
+  return res;
+}
@@ -0,0 +1,654 @@
+/**
+ * @file
+ * @brief Contains compilation of expressions with x into postfix programs and
+ * their batch evaluation
+ */
+
+#include "include/s21_compiler.h"
+
+#include "include/s21_fast_math.h"
+#include "include/s21_functions.h"
+
+#define COMPILER_MAX_LEN 255
+#define COMPILER_MAX_CODE 4096
+#define COMPILER_NEG_PRIORITY 4
+#define COMPILER_BRACKET -1
+#define COMPILER_CALL -2
+
+_Static_assert(sizeof(expr_token) == 8, "token layout");
+
+typedef struct compiler_oper {
+  int op;
+  int priority;
+  int func;
+} compiler_oper;
+
+/**
+ * @brief Call of a user function whose arguments are being compiled.
+ */
+typedef struct compiler_call {
+  int func;
+  int args;
+  int arg_start[FUNC_MAX_PARAMS];
+} compiler_call;
+
+typedef struct compiler_state {
+  const func_registry *registry;
+  const char (*params)[FUNC_NAME_SIZE];
+  int params_count;
+  compiler_oper opers[COMPILER_MAX_LEN + 1];
+  int opers_count;
+  compiler_call calls[COMPILER_MAX_LEN + 1];
+  int calls_count;
+  expr_token code[COMPILER_MAX_CODE];
+  int count;
+  double literals[COMPILER_MAX_CODE];
+  int literals_count;
+  expr_token args[COMPILER_MAX_CODE];
+  double args_values[COMPILER_MAX_CODE];
+  int depth;
+  int max_depth;
+  int overflow;
+} compiler_state;
+
+/* Functions of s21_init_functions(), indexed by expr_token.func. The order
+ * is part of the precompiled file format, new functions go to the end. */
+static const math_func_ptr s21_compiler_funcs[EXPR_FUNC_COUNT] = {
+    cos, sin, tan, acos, asin, atan, sqrt, log10, log};
+static const char *const s21_compiler_func_names[EXPR_FUNC_COUNT] = {
+    "cos", "sin", "tan", "acos", "asin", "atan", "sqrt", "ln", "log"};
+
+static int s21_compiler_func(double (*math_func)(double)) {
+  int res = 0;
+  while (res < EXPR_FUNC_COUNT && s21_compiler_funcs[res] != math_func) res++;
+  return res;
+}
+
+/**
+ * @brief Apply an operator to constants exactly the way the evaluators do.
+ */
+static double s21_fold(int op, int func, double a, double b) {
+  double res = NAN;
+  if (op == OP_ADD) {
+    res = a + b;
+  } else if (op == OP_SUB) {
+    res = a - b;
+  } else if (op == OP_MUL) {
+    res = a * b;
+  } else if (op == OP_DIV) {
+    res = b ? a / b : NAN;
+  } else if (op == OP_POW) {
+    res = pow(a, b);
+  } else if (op == OP_NEG) {
+    res = -a;
+  } else if (op == OP_FUNC) {
+    res = s21_compiler_funcs[func](a);
+  }
+  return res;
+}
+
+/**
+ * @brief Append an instruction to the program and track the stack depth. An
+ * operator whose operands are all constants is folded into a constant.
+ */
+static void s21_emit(compiler_state *state, int op, double value, int func) {
+  int binary = op >= OP_ADD && op <= OP_POW;
+  int operands = binary ? 2 : op == OP_NEG || op == OP_FUNC;
+  int consts = 0;
+  while (consts < operands && consts < state->count &&
+         state->code[state->count - 1 - consts].op == OP_CONST) {
+    consts++;
+  }
+  if (operands && consts == operands) {
+    const expr_token *top = &state->code[state->count - 1];
+    double a = state->literals[top[-binary].literal];
+    double b = binary ? state->literals[top->literal] : 0;
+    value = s21_fold(op, func, a, b);
+    state->count -= operands;
+    state->depth -= operands;
+    op = OP_CONST;
+  }
+  if (state->count == COMPILER_MAX_CODE ||
+      state->literals_count == COMPILER_MAX_CODE) {
+    state->overflow = 1;
+    return;
+  }
+
+  expr_token token = {op, func, 0, 0};
+  if (op == OP_CONST) {
+    token.literal = state->literals_count;
+    state->literals[state->literals_count++] = value;
+  }
+  if (op == OP_CONST || op == OP_X || op == OP_PARAM) {
+    token.slot = state->depth++;
+  } else if (op == OP_NEG || op == OP_FUNC) {
+    token.slot = state->depth - 1;
+  } else {
+    token.slot = --state->depth - 1;
+  }
+  state->code[state->count++] = token;
+  if (state->depth > state->max_depth) state->max_depth = state->depth;
+}
+
+/**
+ * @brief Move operators of at least the given priority from the operator
+ * stack to the program, stopping at a left bracket.
+ */
+static void s21_flush_opers(compiler_state *state, int priority) {
+  while (state->opers_count) {
+    compiler_oper top = state->opers[state->opers_count - 1];
+    if (top.op < 0 || top.priority < priority) break;
+    s21_emit(state, top.op, 0, top.func);
+    state->opers_count--;
+  }
+}
+
+static void s21_push_compiler_oper(compiler_state *state, int op,
+                                   int priority, int func) {
+  state->opers[state->opers_count++] = (compiler_oper){op, priority, func};
+}
+
+static int s21_find_param(const compiler_state *state, const char *name) {
+  int res = state->params_count - 1;
+  while (res >= 0 && strcmp(state->params[res], name)) res--;
+  return res;
+}
+
+/**
+ * @brief Open a call of a user function: the arguments are compiled in
+ * place and moved into the body when the call is closed.
+ */
+static int s21_open_call(compiler_state *state, const char *expr, int *iter,
+                         int func) {
+  while (expr[*iter] == ' ') (*iter)++;
+  if (expr[*iter] != '(') return INVALID_EXPRESSION;
+
+  int status = state->registry->funcs[func].status;
+  if (status == VALID_OK) {
+    state->calls[state->calls_count] = (compiler_call){func, 1, {state->count}};
+    s21_push_compiler_oper(state, COMPILER_CALL, 0, state->calls_count++);
+    (*iter)++;
+  }
+  return status;
+}
+
+/**
+ * @brief Close the innermost call: replace the code of its arguments with
+ * the body of the function, every parameter with a copy of its argument.
+ * The copies go through s21_emit(), so constant arguments fold the body.
+ */
+static int s21_inline_call(compiler_state *state) {
+  compiler_call call = state->calls[--state->calls_count];
+  const user_func *func = &state->registry->funcs[call.func];
+  if (call.args != func->params_count) return INVALID_EXPRESSION;
+
+  int start = call.arg_start[0];
+  int len = state->count - start;
+  for (int i = 0; i < len; i++) {
+    expr_token token = state->code[start + i];
+    state->args[i] = token;
+    state->args_values[i] =
+        token.op == OP_CONST ? state->literals[token.literal] : 0;
+  }
+  state->count = start;
+  state->depth -= call.args;
+
+  const compiled_expr *body = &func->program;
+  for (int i = 0; i < body->count; i++) {
+    expr_token token = body->code[i];
+    if (token.op == OP_PARAM) {
+      int arg = token.func;
+      int from = call.arg_start[arg] - start;
+      int to = arg + 1 < call.args ? call.arg_start[arg + 1] - start : len;
+      for (int j = from; j < to; j++) {
+        s21_emit(state, state->args[j].op, state->args_values[j],
+                 state->args[j].func);
+      }
+    } else {
+      double value = token.op == OP_CONST ? body->literals[token.literal] : 0;
+      s21_emit(state, token.op, value, token.func);
+    }
+  }
+  return state->overflow ? STR_OVERFLOW : VALID_OK;
+}
+
+/**
+ * @brief Read a name: a parameter, the variable, a built-in function or a
+ * call of a user function.
+ */
+static int s21_read_name(compiler_state *state, const char *expr, int *iter,
+                         int *expect_operand) {
+  int res = VALID_OK;
+  char name[COMPILER_MAX_LEN + 1] = {0};
+  s21_read_funcs(expr, iter, name);
+  int param = s21_find_param(state, name);
+  oper_data data = s21_init_functions(name);
+  int func = state->registry ? s21_find_func(state->registry, name) : -1;
+
+  if (param >= 0) {
+    s21_emit(state, OP_PARAM, 0, param);
+    *expect_operand = 0;
+  } else if (!strcmp(name, "x")) {
+    s21_emit(state, OP_X, 0, 0);
+    *expect_operand = 0;
+  } else if (data.type != NO_TYPE) {
+    s21_push_compiler_oper(state, OP_FUNC, data.priority,
+                           s21_compiler_func(data.math_func));
+  } else if (func >= 0) {
+    res = s21_open_call(state, expr, iter, func);
+  } else {
+    res = UNKNOWN_FUNC;
+  }
+  return res;
+}
+
+/**
+ * @brief Read a number, a name, a bracket or a prefix operator, i.e. a token
+ * at a position where an operand is expected.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_read_operand(compiler_state *state, const char *expr, int *iter,
+                            int *expect_operand) {
+  int res = VALID_OK;
+  char c = expr[*iter];
+
+  if (isdigit(c) || c == '.') {
+    char buffer[COMPILER_MAX_LEN + 1] = {0};
+    int len = 0;
+    while (isdigit(expr[*iter]) || expr[*iter] == '.') {
+      buffer[len++] = expr[(*iter)++];
+    }
+    char *end = NULL;
+    double value = strtod(buffer, &end);
+    if (*end != '\0' || !strcmp(buffer, ".")) {
+      res = INVALID_EXPRESSION;
+    } else {
+      s21_emit(state, OP_CONST, value, 0);
+      *expect_operand = 0;
+    }
+  } else if (c >= 'a' && c <= 'z') {
+    res = s21_read_name(state, expr, iter, expect_operand);
+  } else if (c == '(') {
+    s21_push_compiler_oper(state, COMPILER_BRACKET, 0, 0);
+    (*iter)++;
+  } else if (c == '-') {
+    s21_push_compiler_oper(state, OP_NEG, COMPILER_NEG_PRIORITY, 0);
+    (*iter)++;
+  } else if (c == '+') {
+    (*iter)++;
+  } else {
+    res = INVALID_EXPRESSION;
+  }
+  return res;
+}
+
+/**
+ * @brief Read a binary operator, a right bracket or an argument separator,
+ * i.e. a token at a position where an operand has just ended.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_read_binary(compiler_state *state, const char *expr, int *iter,
+                           int *expect_operand) {
+  int res = VALID_OK;
+  char c = expr[*iter];
+  static const char opers[] = "+-*/:^";
+  static const int codes[] = {OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_DIV, OP_POW};
+
+  if (c == ')' || c == ',') {
+    s21_flush_opers(state, 0);
+    compiler_oper top = state->opers_count
+                            ? state->opers[state->opers_count - 1]
+                            : (compiler_oper){0, 0, 0};
+    if (c == ')' && !state->opers_count) {
+      res = BRACKETS_NOT_MATCH;
+    } else if (c == ')') {
+      state->opers_count--;
+      if (top.op == COMPILER_CALL) res = s21_inline_call(state);
+    } else if (top.op != COMPILER_CALL ||
+               state->calls[top.func].args == FUNC_MAX_PARAMS) {
+      res = INVALID_EXPRESSION;
+    } else {
+      compiler_call *call = &state->calls[top.func];
+      call->arg_start[call->args++] = state->count;
+      *expect_operand = 1;
+    }
+    (*iter)++;
+  } else if (c && strchr(opers, c)) {
+    oper_data data = s21_init_oper(c);
+    s21_flush_opers(state, data.priority + (data.assoc == ASSOC_RIGHT));
+    s21_push_compiler_oper(state, codes[strchr(opers, c) - opers],
+                           data.priority, 0);
+    *expect_operand = 1;
+    (*iter)++;
+  } else {
+    res = INVALID_EXPRESSION;
+  }
+  return res;
+}
+
+/**
+ * @brief Copy the tokens and the literals they use into one block, the
+ * literals right after the last token. Literals of folded constants are
+ * left out.
+ *
+ * @return VALID_OK or NULL_PTR if the block can not be allocated.
+ */
+static int s21_pack_program(const compiler_state *state,
+                            compiled_expr *compiled) {
+  int literals_count = 0;
+  for (int i = 0; i < state->count; i++) {
+    literals_count += state->code[i].op == OP_CONST;
+  }
+  expr_token *code = malloc(state->count * sizeof(expr_token) +
+                            literals_count * sizeof(double));
+  if (!code) return NULL_PTR;
+
+  double *literals = (double *)(code + state->count);
+  literals_count = 0;
+  for (int i = 0; i < state->count; i++) {
+    code[i] = state->code[i];
+    if (code[i].op == OP_CONST) {
+      literals[literals_count] = state->literals[code[i].literal];
+      code[i].literal = literals_count++;
+    }
+  }
+  compiled->code = code;
+  compiled->count = state->count;
+  compiled->depth = state->max_depth;
+  compiled->literals_count = literals_count;
+  compiled->literals = literals;
+  return VALID_OK;
+}
+
+/**
+ * @brief Compile an expression into a postfix program, calls of user
+ * functions inlined and constant subexpressions folded.
+ *
+ * @param expr The expression.
+ * @param registry User functions the expression may call, may be NULL.
+ * @param params Parameter names compiled into OP_PARAM tokens when the
+ * expression is the body of a user function, may be NULL.
+ * @param params_count Number of parameters.
+ * @param compiled Output for the program, to be freed with
+ * s21_clear_compiled().
+ * @return VALID_OK on success or a validation error code, STR_OVERFLOW also
+ * if the inlined program gets too long.
+ */
+int s21_compile_body(const char *expr, const func_registry *registry,
+                     const char (*params)[FUNC_NAME_SIZE], int params_count,
+                     compiled_expr *compiled) {
+  if (!expr || !compiled || (!params && params_count)) return NULL_PTR;
+  memset(compiled, 0, sizeof(compiled_expr));
+  if (strlen(expr) > COMPILER_MAX_LEN) return STR_OVERFLOW;
+
+  /* The buffers are written before they are read, only the counters have
+   * to start at zero, and clearing the whole state would dominate the cost
+   * of compiling short expressions. */
+  compiler_state *state = malloc(sizeof(compiler_state));
+  if (!state) return NULL_PTR;
+  state->registry = registry;
+  state->params = params;
+  state->params_count = params_count;
+  state->opers_count = 0;
+  state->calls_count = 0;
+  state->count = 0;
+  state->literals_count = 0;
+  state->depth = 0;
+  state->max_depth = 0;
+  state->overflow = 0;
+
+  int res = VALID_OK;
+  int expect_operand = 1;
+  int iter = 0;
+  while (expr[iter] != '\0' && res == VALID_OK) {
+    if (expr[iter] == ' ') {
+      iter++;
+    } else if (expect_operand) {
+      res = s21_read_operand(state, expr, &iter, &expect_operand);
+    } else {
+      res = s21_read_binary(state, expr, &iter, &expect_operand);
+    }
+  }
+
+  if (res == VALID_OK && expect_operand) res = INVALID_EXPRESSION;
+  if (res == VALID_OK) {
+    s21_flush_opers(state, 0);
+    if (state->opers_count) res = BRACKETS_NOT_MATCH;
+  }
+  if (res == VALID_OK && state->overflow) res = STR_OVERFLOW;
+  if (res == VALID_OK) res = s21_pack_program(state, compiled);
+  free(state);
+  return res;
+}
+
+/**
+ * @brief Compile an expression of the variable x into a postfix program.
+ *
+ * Operators keep the priorities and associativity of s21_smart_calc(), a
+ * unary minus binds weaker than the power, so -x^2 is -(x^2).
+ *
+ * @param expr The expression, e.g. "sin(x)/x".
+ * @param compiled Output for the program, to be freed with
+ * s21_clear_compiled().
+ * @return VALID_OK on success or a validation error code.
+ */
+int s21_compile_expr(const char *expr, compiled_expr *compiled) {
+  return s21_compile_body(expr, NULL, NULL, 0, compiled);
+}
+
+/**
+ * @brief Compile an expression of the variable x that may call the functions
+ * of a registry. The calls are inlined, so the program does not depend on
+ * the registry afterwards.
+ *
+ * @param expr The expression, e.g. "f(x,2)+1".
+ * @param registry The user functions.
+ * @param compiled Output for the program, to be freed with
+ * s21_clear_compiled().
+ * @return VALID_OK on success or a validation error code.
+ */
+int s21_compile_expr_with(const char *expr, const func_registry *registry,
+                          compiled_expr *compiled) {
+  return s21_compile_body(expr, registry, NULL, 0, compiled);
+}
+
+/**
+ * @brief Run the program over a block of x values. Every stack slot is a row
+ * of the block, so each instruction is a tight loop over contiguous memory,
+ * and the rows come from the tokens, not from a moving top pointer.
+ *
+ * @param compiled The program.
+ * @param stack Scratch memory of depth * width values.
+ * @param width Row width of the stack, at least count.
+ * @param x Values of the variable.
+ * @param y Output for the results.
+ * @param count Number of values in the block.
+ */
+static void s21_eval_block(const compiled_expr *compiled, double *stack,
+                           size_t width, const double *x, double *y,
+                           size_t count) {
+  for (int i = 0; i < compiled->count; i++) {
+    expr_token token = compiled->code[i];
+    double *a = stack + token.slot * width;
+    const double *b = a + width;
+    switch (token.op) {
+      case OP_CONST: {
+        double value = compiled->literals[token.literal];
+        for (size_t j = 0; j < count; j++) a[j] = value;
+        break;
+      }
+      case OP_X:
+        memcpy(a, x, count * sizeof(double));
+        break;
+      case OP_ADD:
+        for (size_t j = 0; j < count; j++) a[j] += b[j];
+        break;
+      case OP_SUB:
+        for (size_t j = 0; j < count; j++) a[j] -= b[j];
+        break;
+      case OP_MUL:
+        for (size_t j = 0; j < count; j++) a[j] *= b[j];
+        break;
+      case OP_DIV:
+        for (size_t j = 0; j < count; j++) a[j] = b[j] ? a[j] / b[j] : NAN;
+        break;
+      case OP_POW:
+        /* The exponent is the token right before, a square is a multiply
+         * the loop can vectorize, and is what pow() returns for it. */
+        if (i && compiled->code[i - 1].op == OP_CONST &&
+            compiled->literals[compiled->code[i - 1].literal] == 2) {
+          for (size_t j = 0; j < count; j++) a[j] *= a[j];
+        } else {
+          for (size_t j = 0; j < count; j++) a[j] = pow(a[j], b[j]);
+        }
+        break;
+      case OP_NEG:
+        for (size_t j = 0; j < count; j++) a[j] = -a[j];
+        break;
+      case OP_FUNC: {
+        math_func_ptr func = s21_compiler_funcs[token.func];
+        if (s21_fast_math_enabled(token.func, compiled->fast_math_ulps)) {
+          s21_fast_math_block(token.func, a, count);
+        } else {
+          for (size_t j = 0; j < count; j++) a[j] = func(a[j]);
+        }
+        break;
+      }
+      case OP_PARAM:
+        /* A batch passes no parameters, as s21_eval_compiled() does not. */
+        for (size_t j = 0; j < count; j++) a[j] = NAN;
+        break;
+    }
+  }
+  memcpy(y, stack, count * sizeof(double));
+}
+
+/**
+ * @brief Evaluate a compiled expression at a single point. Every token names
+ * its stack slot, so the loop needs no stack pointer.
+ *
+ * @param compiled The program.
+ * @param x Value of the variable.
+ * @return The result, NAN if it is not defined.
+ */
+double s21_eval_compiled(const compiled_expr *compiled, double x) {
+  return s21_eval_compiled_with(compiled, x, NULL);
+}
+
+/**
+ * @brief Evaluate a program compiled with parameters, e.g. the body of a
+ * user function or a workbook cell, at a single point.
+ *
+ * @param compiled The program.
+ * @param x Value of the variable.
+ * @param params Values of the parameters in the order they were given to
+ * s21_compile_body(), may be NULL if the program has none.
+ * @return The result, NAN if it is not defined.
+ */
+double s21_eval_compiled_with(const compiled_expr *compiled, double x,
+                              const double *params) {
+  if (!compiled || !compiled->code || compiled->depth <= 0) return NAN;
+  double stack[compiled->depth];
+  for (int i = 0; i < compiled->count; i++) {
+    expr_token token = compiled->code[i];
+    double *a = stack + token.slot;
+    switch (token.op) {
+      case OP_CONST:
+        *a = compiled->literals[token.literal];
+        break;
+      case OP_X:
+        *a = x;
+        break;
+      case OP_ADD:
+        *a += a[1];
+        break;
+      case OP_SUB:
+        *a -= a[1];
+        break;
+      case OP_MUL:
+        *a *= a[1];
+        break;
+      case OP_DIV:
+        *a = a[1] ? *a / a[1] : NAN;
+        break;
+      case OP_POW:
+        *a = pow(*a, a[1]);
+        break;
+      case OP_NEG:
+        *a = -*a;
+        break;
+      case OP_FUNC:
+        *a = s21_fast_math_enabled(token.func, compiled->fast_math_ulps)
+                 ? s21_fast_math_func(token.func, *a)
+                 : s21_compiler_funcs[token.func](*a);
+        break;
+      case OP_PARAM:
+        *a = params ? params[token.func] : NAN;
+        break;
+    }
+  }
+  return stack[0];
+}
+
+/**
+ * @brief Evaluate a compiled expression over an array of x values, EXPR_BLOCK
+ * values at a time.
+ *
+ * @param compiled The program.
+ * @param x Values of the variable.
+ * @param y Output for the results, NAN where the result is not defined.
+ * @param count Number of values.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_eval_compiled_batch(const compiled_expr *compiled, const double *x,
+                            double *y, size_t count) {
+  if (!compiled || !compiled->code || compiled->depth <= 0) return NULL_PTR;
+  if (!count) return VALID_OK;
+  if (!x || !y) return NULL_PTR;
+
+  double *stack = malloc((size_t)compiled->depth * EXPR_BLOCK * sizeof(double));
+  if (!stack) return NULL_PTR;
+  for (size_t i = 0; i < count; i += EXPR_BLOCK) {
+    size_t block = count - i < EXPR_BLOCK ? count - i : EXPR_BLOCK;
+    s21_eval_block(compiled, stack, EXPR_BLOCK, x + i, y + i, block);
+  }
+  free(stack);
+  return VALID_OK;
+}
+
+/**
+ * @brief A function of the function table.
+ *
+ * @param func Index of the function, expr_token.func.
+ * @return The function, or NULL if there is no such function.
+ */
+math_func_ptr s21_compiled_func(int func) {
+  return func >= 0 && func < EXPR_FUNC_COUNT ? s21_compiler_funcs[func] : NULL;
+}
+
+/**
+ * @brief Name of a function of the function table, as s21_init_functions()
+ * knows it.
+ *
+ * @param func Index of the function, expr_token.func.
+ * @return The name, or NULL if there is no such function.
+ */
+const char *s21_compiled_func_name(int func) {
+  return func >= 0 && func < EXPR_FUNC_COUNT ? s21_compiler_func_names[func]
+                                             : NULL;
+}
+
+/**
+ * @brief Free a compiled expression.
+ *
+ * @param compiled The program.
+ */
+void s21_clear_compiled(compiled_expr *compiled) {
+  if (compiled) {
+    free((void *)compiled->code);
+    memset(compiled, 0, sizeof(compiled_expr));
+  }
+}
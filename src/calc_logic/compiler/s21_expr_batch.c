@@ -0,0 +1,349 @@
+/**
+ * @file
+ * @brief Contains compilation of a batch of expressions into one DAG with
+ * shared subexpressions and its evaluation over columns of x values
+ */
+
+#include "include/s21_expr_batch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_NONE UINT32_MAX
+#define BATCH_FNV_OFFSET 14695981039346656037ULL
+#define BATCH_FNV_PRIME 1099511628211ULL
+
+/**
+ * @brief A node while the DAG is built: operands are nodes, not rows.
+ */
+typedef struct batch_key {
+  uint32_t op;
+  uint32_t func;
+  uint32_t a;
+  uint32_t b;
+  double value;
+} batch_key;
+
+typedef struct batch_builder {
+  batch_key *nodes;
+  int count;
+  int capacity;
+  int *index;
+  int index_capacity;
+} batch_builder;
+
+static uint64_t s21_batch_hash(const batch_key *key) {
+  uint64_t words[4] = {(uint64_t)key->op << 32 | key->func,
+                       (uint64_t)key->a << 32 | key->b, 0, 0};
+  memcpy(&words[2], &key->value, sizeof(double));
+  uint64_t res = BATCH_FNV_OFFSET;
+  for (int i = 0; i < 3; i++) res = (res ^ words[i]) * BATCH_FNV_PRIME;
+  return res ^ res >> 29;
+}
+
+static int s21_batch_same(const batch_key *a, const batch_key *b) {
+  return a->op == b->op && a->func == b->func && a->a == b->a &&
+         a->b == b->b && !memcmp(&a->value, &b->value, sizeof(double));
+}
+
+/**
+ * @brief Rebuild the index of the nodes with twice the capacity, so it is at
+ * most half full.
+ */
+static int s21_batch_grow_index(batch_builder *builder) {
+  int grown = builder->index_capacity ? 2 * builder->index_capacity : 1024;
+  int *index = malloc(grown * sizeof(int));
+  if (!index) return NULL_PTR;
+  memset(index, -1, grown * sizeof(int));
+  for (int i = 0; i < builder->count; i++) {
+    uint64_t slot = s21_batch_hash(&builder->nodes[i]) & (grown - 1);
+    while (index[slot] >= 0) slot = (slot + 1) & (grown - 1);
+    index[slot] = i;
+  }
+  free(builder->index);
+  builder->index = index;
+  builder->index_capacity = grown;
+  return VALID_OK;
+}
+
+/**
+ * @brief Find the node of a subexpression or add it.
+ *
+ * @return Index of the node or -1 if memory can not be allocated.
+ */
+static int s21_batch_intern(batch_builder *builder, batch_key key) {
+  if (key.op == OP_ADD || key.op == OP_MUL) {
+    if (key.a > key.b) {
+      uint32_t swap = key.a;
+      key.a = key.b;
+      key.b = swap;
+    }
+  }
+  if (2 * (builder->count + 1) > builder->index_capacity &&
+      s21_batch_grow_index(builder) != VALID_OK) {
+    return -1;
+  }
+
+  uint64_t mask = builder->index_capacity - 1;
+  uint64_t slot = s21_batch_hash(&key) & mask;
+  while (builder->index[slot] >= 0) {
+    if (s21_batch_same(&builder->nodes[builder->index[slot]], &key)) {
+      return builder->index[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (builder->count == builder->capacity) {
+    int grown = builder->capacity ? 2 * builder->capacity : 1024;
+    batch_key *nodes = realloc(builder->nodes, grown * sizeof(batch_key));
+    if (!nodes) return -1;
+    builder->nodes = nodes;
+    builder->capacity = grown;
+  }
+  builder->nodes[builder->count] = key;
+  builder->index[slot] = builder->count;
+  return builder->count++;
+}
+
+/**
+ * @brief Add the nodes of a compiled expression to the DAG.
+ *
+ * @return The node of the whole expression, -1 on allocation failure.
+ */
+static int s21_batch_add(batch_builder *builder,
+                         const compiled_expr *program) {
+  int stack[program->depth];
+  int top = 0;
+  int res = 0;
+  for (int i = 0; res >= 0 && i < program->count; i++) {
+    expr_token token = program->code[i];
+    batch_key key = {token.op, token.func, BATCH_NONE, BATCH_NONE, 0};
+    if (token.op == OP_CONST) {
+      key.value = program->literals[token.literal];
+    } else if (token.op >= OP_ADD && token.op <= OP_POW) {
+      key.b = stack[--top];
+      key.a = stack[--top];
+    } else if (token.op == OP_NEG || token.op == OP_FUNC) {
+      key.a = stack[--top];
+    }
+    res = s21_batch_intern(builder, key);
+    stack[top++] = res;
+  }
+  return res;
+}
+
+static int s21_batch_compare_outputs(const void *a, const void *b) {
+  const batch_output *x = a;
+  const batch_output *y = b;
+  return x->node != y->node ? (x->node > y->node) - (x->node < y->node)
+                            : (x->expr > y->expr) - (x->expr < y->expr);
+}
+
+/**
+ * @brief Give every node a stack row. A row is taken back after the last
+ * node that reads it, so the rows needed grow with the width of the DAG,
+ * not with its size. Roots are copied out right after they are computed.
+ */
+static int s21_batch_finish(const batch_builder *builder, const int *roots,
+                            int count, compiled_batch *batch) {
+  int nodes_count = builder->count;
+  int literals_count = 0;
+  for (int i = 0; i < nodes_count; i++) {
+    literals_count += builder->nodes[i].op == OP_CONST;
+  }
+  char *block = malloc(nodes_count * sizeof(batch_node) +
+                       count * sizeof(batch_output) +
+                       literals_count * sizeof(double));
+  int *last_use = malloc(2 * nodes_count * sizeof(int));
+  if (!block || !last_use) {
+    free(block);
+    free(last_use);
+    return NULL_PTR;
+  }
+  batch_node *nodes = (batch_node *)block;
+  batch_output *outputs = (batch_output *)(nodes + nodes_count);
+  double *literals = (double *)(outputs + count);
+  int *free_slots = last_use + nodes_count;
+
+  for (int i = 0; i < nodes_count; i++) {
+    const batch_key *key = &builder->nodes[i];
+    last_use[i] = i;
+    if (key->a != BATCH_NONE) last_use[key->a] = i;
+    if (key->b != BATCH_NONE) last_use[key->b] = i;
+  }
+
+  int free_count = 0;
+  int slots = 0;
+  literals_count = 0;
+  for (int i = 0; i < nodes_count; i++) {
+    const batch_key *key = &builder->nodes[i];
+    batch_node node = {key->op, key->func, 0, 0, 0};
+    if (key->a != BATCH_NONE) {
+      node.a = nodes[key->a].slot;
+      if (last_use[key->a] == i) free_slots[free_count++] = node.a;
+    }
+    if (key->b != BATCH_NONE) {
+      node.b = nodes[key->b].slot;
+      if (last_use[key->b] == i && key->b != key->a) {
+        free_slots[free_count++] = node.b;
+      }
+    }
+    if (key->op == OP_CONST) {
+      node.b = literals_count;
+      literals[literals_count++] = key->value;
+    }
+    node.slot = free_count ? free_slots[--free_count] : slots++;
+    if (last_use[i] == i) free_slots[free_count++] = node.slot;
+    nodes[i] = node;
+  }
+  free(last_use);
+
+  for (int i = 0; i < count; i++) {
+    outputs[i] = (batch_output){roots[i], i};
+  }
+  qsort(outputs, count, sizeof(batch_output), s21_batch_compare_outputs);
+  batch->count = count;
+  batch->nodes_count = nodes_count;
+  batch->slots = slots;
+  batch->nodes = nodes;
+  batch->outputs = outputs;
+  batch->literals = literals;
+  return VALID_OK;
+}
+
+/**
+ * @brief Compile expressions of x into one DAG. Subexpressions that occur in
+ * several expressions, or several times in one, become one node, and
+ * a + b and b + a are the same node, as are a * b and b * a.
+ *
+ * @param exprs The expressions.
+ * @param count Number of expressions.
+ * @param batch Output for the batch, to be freed with s21_clear_batch().
+ * @param failed Output for the index of the expression that does not
+ * compile, may be NULL.
+ * @return VALID_OK on success, otherwise the error of that expression or
+ * NULL_PTR.
+ */
+int s21_compile_batch(const char *const *exprs, int count,
+                      compiled_batch *batch, int *failed) {
+  if (!exprs || !batch || count <= 0) return NULL_PTR;
+  memset(batch, 0, sizeof(compiled_batch));
+
+  batch_builder builder = {0};
+  int *roots = malloc(count * sizeof(int));
+  int res = roots ? VALID_OK : NULL_PTR;
+  for (int i = 0; res == VALID_OK && i < count; i++) {
+    compiled_expr program;
+    res = s21_compile_expr(exprs[i], &program);
+    if (res == VALID_OK) {
+      batch->instructions += program.count;
+      roots[i] = s21_batch_add(&builder, &program);
+      if (roots[i] < 0) res = NULL_PTR;
+      s21_clear_compiled(&program);
+    }
+    if (res != VALID_OK && failed) *failed = i;
+  }
+
+  if (res == VALID_OK) res = s21_batch_finish(&builder, roots, count, batch);
+  if (res != VALID_OK) memset(batch, 0, sizeof(compiled_batch));
+  free(builder.nodes);
+  free(builder.index);
+  free(roots);
+  return res;
+}
+
+/**
+ * @brief Run the nodes over a block of x values, copying every result to the
+ * outputs that need it as soon as it is computed.
+ */
+static void s21_batch_block(const compiled_batch *batch, double *stack,
+                            const double *x, double *y, size_t rows,
+                            size_t count) {
+  int next_output = 0;
+  for (int i = 0; i < batch->nodes_count; i++) {
+    batch_node node = batch->nodes[i];
+    double *out = stack + (size_t)node.slot * EXPR_BLOCK;
+    const double *a = stack + (size_t)node.a * EXPR_BLOCK;
+    const double *b =
+        node.op == OP_CONST ? NULL : stack + (size_t)node.b * EXPR_BLOCK;
+    switch (node.op) {
+      case OP_CONST: {
+        double value = batch->literals[node.b];
+        for (size_t j = 0; j < count; j++) out[j] = value;
+        break;
+      }
+      case OP_X:
+        memcpy(out, x, count * sizeof(double));
+        break;
+      case OP_ADD:
+        for (size_t j = 0; j < count; j++) out[j] = a[j] + b[j];
+        break;
+      case OP_SUB:
+        for (size_t j = 0; j < count; j++) out[j] = a[j] - b[j];
+        break;
+      case OP_MUL:
+        for (size_t j = 0; j < count; j++) out[j] = a[j] * b[j];
+        break;
+      case OP_DIV:
+        for (size_t j = 0; j < count; j++) out[j] = b[j] ? a[j] / b[j] : NAN;
+        break;
+      case OP_POW:
+        for (size_t j = 0; j < count; j++) out[j] = pow(a[j], b[j]);
+        break;
+      case OP_NEG:
+        for (size_t j = 0; j < count; j++) out[j] = -a[j];
+        break;
+      case OP_FUNC: {
+        math_func_ptr func = s21_compiled_func(node.func);
+        for (size_t j = 0; j < count; j++) out[j] = func(a[j]);
+        break;
+      }
+    }
+    for (; next_output < batch->count &&
+           batch->outputs[next_output].node == (uint32_t)i;
+         next_output++) {
+      memcpy(y + batch->outputs[next_output].expr * rows, out,
+             count * sizeof(double));
+    }
+  }
+}
+
+/**
+ * @brief Evaluate every expression of a batch over a column of x values.
+ * Each distinct subexpression is computed once per value.
+ *
+ * @param batch The batch.
+ * @param x Values of the variable.
+ * @param y Output for count * rows results, the results of expression i at
+ * y + i * rows, NAN where a result is not defined.
+ * @param rows Number of values.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_eval_batch(const compiled_batch *batch, const double *x, double *y,
+                   size_t rows) {
+  if (!batch || !batch->nodes) return NULL_PTR;
+  if (!rows) return VALID_OK;
+  if (!x || !y) return NULL_PTR;
+
+  double *stack = malloc((size_t)batch->slots * EXPR_BLOCK * sizeof(double));
+  if (!stack) return NULL_PTR;
+  for (size_t i = 0; i < rows; i += EXPR_BLOCK) {
+    size_t block = rows - i < EXPR_BLOCK ? rows - i : EXPR_BLOCK;
+    s21_batch_block(batch, stack, x + i, y + i, rows, block);
+  }
+  free(stack);
+  return VALID_OK;
+}
+
+/**
+ * @brief Free a compiled batch.
+ *
+ * @param batch The batch.
+ */
+void s21_clear_batch(compiled_batch *batch) {
+  if (batch) {
+    free((void *)batch->nodes);
+    memset(batch, 0, sizeof(compiled_batch));
+  }
+}
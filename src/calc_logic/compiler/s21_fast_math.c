@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Contains the fast-math mode of compiled programs: functions of the
+ * function table replaced by the inline approximations of s21_fast_math.h
+ */
+
+#include "include/s21_fast_math.h"
+
+#include "include/s21_compiler.h"
+
+#define FAST_MATH_CHUNK 256
+
+/* Run the core over a chunk of arguments in loops without calls or
+ * branches and with a constant count, which the compiler vectorizes even
+ * at -O2, then give the arguments outside of its domain to libm, a pass a
+ * chunk without such arguments skips. A short chunk is padded with 0.5,
+ * which is inside the domain of every function. */
+#define FAST_MATH_LOOP(core, domain, libm)                                \
+  for (size_t i = 0; i < count; i += FAST_MATH_CHUNK) {                   \
+    size_t n = count - i < FAST_MATH_CHUNK ? count - i : FAST_MATH_CHUNK; \
+    uint64_t slow = 0;                                                    \
+    memcpy(args, values + i, n * sizeof(double));                         \
+    for (size_t j = n; j < FAST_MATH_CHUNK; j++) args[j] = 0.5;           \
+    for (size_t j = 0; j < FAST_MATH_CHUNK; j++) res[j] = core(args[j]);  \
+    for (size_t j = 0; j < FAST_MATH_CHUNK; j++) {                        \
+      slow |= !domain(args[j]);                                           \
+    }                                                                     \
+    memcpy(values + i, res, n * sizeof(double));                          \
+    for (size_t j = 0; slow && j < n; j++) {                              \
+      if (!domain(args[j])) values[i + j] = libm(args[j]);                \
+    }                                                                     \
+  }
+
+/* atan and sqrt take any argument. */
+static int s21_fast_any_domain(double x) {
+  (void)x;
+  return 1;
+}
+
+/**
+ * @brief Error bound of the approximation of a function of the function
+ * table.
+ *
+ * @param func Index of the function, expr_token.func.
+ * @return The bound in ulps, -1 if the function has no approximation.
+ */
+int s21_fast_math_ulps(int func) {
+  math_func_ptr math_func = s21_compiled_func(func);
+  int res = -1;
+  if (math_func == cos) {
+    res = FAST_MATH_ULPS_COS;
+  } else if (math_func == sin) {
+    res = FAST_MATH_ULPS_SIN;
+  } else if (math_func == tan) {
+    res = FAST_MATH_ULPS_TAN;
+  } else if (math_func == acos) {
+    res = FAST_MATH_ULPS_ACOS;
+  } else if (math_func == asin) {
+    res = FAST_MATH_ULPS_ASIN;
+  } else if (math_func == atan) {
+    res = FAST_MATH_ULPS_ATAN;
+  } else if (math_func == sqrt) {
+    res = FAST_MATH_ULPS_SQRT;
+  } else if (math_func == log10) {
+    res = FAST_MATH_ULPS_LOG10;
+  } else if (math_func == log) {
+    res = FAST_MATH_ULPS_LOG;
+  }
+  return res;
+}
+
+/**
+ * @brief Whether a program with compiled_expr.fast_math_ulps set to
+ * max_ulps evaluates a function by its approximation. Only sin, cos and tan
+ * are, the approximations fast_math_bench measures faster than glibc at -O2
+ * and -O3. The others stay available through s21_fast_math_func(),
+ * s21_fast_math_block() and the inline functions.
+ */
+int s21_fast_math_enabled(int func, int max_ulps) {
+  math_func_ptr math_func = s21_compiled_func(func);
+  int ulps = s21_fast_math_ulps(func);
+  return max_ulps > 0 && ulps <= max_ulps &&
+         (math_func == cos || math_func == sin || math_func == tan);
+}
+
+/**
+ * @brief Apply the approximation of a function of the function table to a
+ * single value.
+ *
+ * @param func Index of the function, expr_token.func.
+ * @param x The argument.
+ * @return The approximation, the libm result for a function without one.
+ */
+double s21_fast_math_func(int func, double x) {
+  math_func_ptr math_func = s21_compiled_func(func);
+  double res = NAN;
+  if (math_func == cos) {
+    res = s21_fast_cos(x);
+  } else if (math_func == sin) {
+    res = s21_fast_sin(x);
+  } else if (math_func == tan) {
+    res = s21_fast_tan(x);
+  } else if (math_func == acos) {
+    res = s21_fast_acos(x);
+  } else if (math_func == asin) {
+    res = s21_fast_asin(x);
+  } else if (math_func == atan) {
+    res = s21_fast_atan(x);
+  } else if (math_func == sqrt) {
+    res = s21_fast_sqrt(x);
+  } else if (math_func == log10) {
+    res = s21_fast_log10(x);
+  } else if (math_func == log) {
+    res = s21_fast_log(x);
+  } else if (math_func) {
+    res = math_func(x);
+  }
+  return res;
+}
+
+/**
+ * @brief Apply the approximation of a function of the function table to a
+ * block of values in place. The function is chosen once per block and
+ * every loop inlines its approximation, so no value costs a call.
+ *
+ * @param func Index of the function, expr_token.func.
+ * @param values The arguments, replaced by the results.
+ * @param count Number of values.
+ */
+void s21_fast_math_block(int func, double *values, size_t count) {
+  math_func_ptr math_func = s21_compiled_func(func);
+  double args[FAST_MATH_CHUNK];
+  double res[FAST_MATH_CHUNK];
+  if (math_func == cos) {
+    FAST_MATH_LOOP(s21_fast_cos_core, s21_fast_trig_domain, cos);
+  } else if (math_func == sin) {
+    FAST_MATH_LOOP(s21_fast_sin_core, s21_fast_trig_domain, sin);
+  } else if (math_func == tan) {
+    FAST_MATH_LOOP(s21_fast_tan_core, s21_fast_trig_domain, tan);
+  } else if (math_func == acos) {
+    FAST_MATH_LOOP(s21_fast_acos_core, s21_fast_asin_domain, acos);
+  } else if (math_func == asin) {
+    FAST_MATH_LOOP(s21_fast_asin_core, s21_fast_asin_domain, asin);
+  } else if (math_func == atan) {
+    FAST_MATH_LOOP(s21_fast_atan, s21_fast_any_domain, atan);
+  } else if (math_func == sqrt) {
+    FAST_MATH_LOOP(s21_fast_sqrt, s21_fast_any_domain, sqrt);
+  } else if (math_func == log10) {
+    FAST_MATH_LOOP(s21_fast_log10_core, s21_fast_log_domain, log10);
+  } else if (math_func == log) {
+    FAST_MATH_LOOP(s21_fast_log_core, s21_fast_log_domain, log);
+  } else if (math_func) {
+    for (size_t j = 0; j < count; j++) values[j] = math_func(values[j]);
+  }
+}
@@ -0,0 +1,242 @@
+/**
+ * @file
+ * @brief Contains the registry of user-defined functions: parsing of
+ * definitions, recursion checks and recompilation of dependents
+ */
+
+#include "include/s21_functions.h"
+
+/**
+ * @brief Create an empty registry.
+ *
+ * @return The registry, to be freed with s21_clear_registry(), or NULL.
+ */
+func_registry *s21_create_registry(void) {
+  return calloc(1, sizeof(func_registry));
+}
+
+/**
+ * @brief Find a defined function by name.
+ *
+ * @return Index of the function or -1 if there is no such function.
+ */
+int s21_find_func(const func_registry *registry, const char *name) {
+  int res = -1;
+  for (int i = 0; registry && name && res < 0 && i < FUNC_MAX_DEFS; i++) {
+    const user_func *func = &registry->funcs[i];
+    if (func->state != FUNC_EMPTY && !strcmp(func->name, name)) res = i;
+  }
+  return res;
+}
+
+/**
+ * @brief Status of a function, which changes when the functions it calls
+ * are defined, changed or removed.
+ *
+ * @return VALID_OK if it can be called, UNKNOWN_FUNC if it is not defined,
+ * otherwise the error of its body, RECURSIVE_FUNC for a recursive one.
+ */
+int s21_func_status(const func_registry *registry, const char *name) {
+  int func = s21_find_func(registry, name);
+  return func < 0 ? UNKNOWN_FUNC : registry->funcs[func].status;
+}
+
+static void s21_skip_spaces(const char *text, int *iter) {
+  while (text[*iter] == ' ') (*iter)++;
+}
+
+/**
+ * @brief Read a name that may be given to a function or a parameter: not a
+ * built-in function. A parameter may be x, a function may not.
+ */
+static int s21_read_def_name(const char *text, int *iter, char *name,
+                             int param) {
+  char buffer[FUNC_MAX_LEN + 1] = {0};
+  s21_skip_spaces(text, iter);
+  s21_read_funcs(text, iter, buffer);
+  s21_skip_spaces(text, iter);
+  if (!buffer[0] || strlen(buffer) >= FUNC_NAME_SIZE ||
+      (!param && !strcmp(buffer, "x")) ||
+      s21_init_functions(buffer).type != NO_TYPE) {
+    return INVALID_EXPRESSION;
+  }
+  strcpy(name, buffer);
+  return VALID_OK;
+}
+
+/**
+ * @brief Parse "name(a,b)=body" into the name, the parameters and the body.
+ */
+static int s21_parse_definition(const char *definition, user_func *func) {
+  int iter = 0;
+  int res = s21_read_def_name(definition, &iter, func->name, 0);
+  if (res == VALID_OK && definition[iter++] != '(') res = INVALID_EXPRESSION;
+
+  char next = ',';
+  while (res == VALID_OK && next == ',') {
+    char *param = func->params[func->params_count];
+    if (func->params_count == FUNC_MAX_PARAMS) {
+      res = INVALID_EXPRESSION;
+    } else {
+      res = s21_read_def_name(definition, &iter, param, 1);
+    }
+    for (int i = 0; res == VALID_OK && i < func->params_count; i++) {
+      if (!strcmp(func->params[i], param)) res = INVALID_EXPRESSION;
+    }
+    if (res == VALID_OK) func->params_count++;
+    next = definition[iter++];
+  }
+  if (res == VALID_OK && next != ')') res = INVALID_EXPRESSION;
+
+  s21_skip_spaces(definition, &iter);
+  if (res == VALID_OK && definition[iter++] != '=') res = INVALID_EXPRESSION;
+  if (res == VALID_OK) strcpy(func->body, definition + iter);
+  return res;
+}
+
+static int s21_is_param(const user_func *func, const char *name) {
+  int res = 0;
+  for (int i = 0; !res && i < func->params_count; i++) {
+    res = !strcmp(func->params[i], name);
+  }
+  return res;
+}
+
+/**
+ * @brief Compile a stale function after the functions it calls. Reaching a
+ * function that is still being built means the definitions are recursive.
+ *
+ * @return Status of the function.
+ */
+static int s21_build_func(func_registry *registry, int index) {
+  user_func *func = &registry->funcs[index];
+  if (func->state == FUNC_READY) return func->status;
+  if (func->state == FUNC_BUILDING) return RECURSIVE_FUNC;
+
+  func->state = FUNC_BUILDING;
+  func->calls = 0;
+  s21_clear_compiled(&func->program);
+  int res = VALID_OK;
+  for (int iter = 0; func->body[iter];) {
+    if (func->body[iter] >= 'a' && func->body[iter] <= 'z') {
+      char name[FUNC_MAX_LEN + 1] = {0};
+      s21_read_funcs(func->body, &iter, name);
+      int callee = s21_find_func(registry, name);
+      if (callee >= 0 && !s21_is_param(func, name)) {
+        func->calls |= 1ULL << callee;
+        int status = s21_build_func(registry, callee);
+        if (res == VALID_OK) res = status;
+      }
+    } else {
+      iter++;
+    }
+  }
+
+  if (res == VALID_OK) {
+    res = s21_compile_body(func->body, registry,
+                           (const char(*)[FUNC_NAME_SIZE])func->params,
+                           func->params_count, &func->program);
+  }
+  func->status = res;
+  func->state = FUNC_READY;
+  return res;
+}
+
+/**
+ * @brief Mark a function, everything that calls it directly or indirectly
+ * and every function with an error as stale, then compile them again.
+ * Functions with errors may call the changed name, so they get a new
+ * chance.
+ */
+static void s21_rebuild_from(func_registry *registry, int index) {
+  uint64_t stale = index >= 0 ? 1ULL << index : 0;
+  for (int i = 0; i < FUNC_MAX_DEFS; i++) {
+    const user_func *func = &registry->funcs[i];
+    if (func->state != FUNC_EMPTY && func->status != VALID_OK) {
+      stale |= 1ULL << i;
+    }
+  }
+  uint64_t grown = 0;
+  while (grown != stale) {
+    grown = stale;
+    for (int i = 0; i < FUNC_MAX_DEFS; i++) {
+      if (registry->funcs[i].calls & stale) stale |= 1ULL << i;
+    }
+  }
+
+  for (int i = 0; i < FUNC_MAX_DEFS; i++) {
+    user_func *func = &registry->funcs[i];
+    if (func->state != FUNC_EMPTY && (stale >> i & 1)) {
+      func->state = FUNC_STALE;
+    }
+  }
+  for (int i = 0; i < FUNC_MAX_DEFS; i++) {
+    if (registry->funcs[i].state == FUNC_STALE) s21_build_func(registry, i);
+  }
+  registry->generation++;
+}
+
+/**
+ * @brief Define or redefine a function, e.g. "f(x,y)=x^2+y". The body may
+ * call other user functions, also ones defined later. The function and
+ * everything that depends on it are compiled again.
+ *
+ * @param registry The registry.
+ * @param definition The definition, at most FUNC_MAX_LEN characters.
+ * @return Status of the function as s21_func_status() reports it, or
+ * INVALID_EXPRESSION for a malformed definition, which is not stored.
+ */
+int s21_define_func(func_registry *registry, const char *definition) {
+  if (!registry || !definition) return NULL_PTR;
+  if (strlen(definition) > FUNC_MAX_LEN) return STR_OVERFLOW;
+
+  user_func parsed = {0};
+  int res = s21_parse_definition(definition, &parsed);
+  int index = res == VALID_OK ? s21_find_func(registry, parsed.name) : -1;
+  for (int i = 0; res == VALID_OK && index < 0 && i < FUNC_MAX_DEFS; i++) {
+    if (registry->funcs[i].state == FUNC_EMPTY) index = i;
+  }
+  if (res == VALID_OK && index < 0) res = STR_OVERFLOW;
+
+  if (res == VALID_OK) {
+    user_func *func = &registry->funcs[index];
+    s21_clear_compiled(&func->program);
+    parsed.state = FUNC_STALE;
+    *func = parsed;
+    s21_rebuild_from(registry, index);
+    res = func->status;
+  }
+  return res;
+}
+
+/**
+ * @brief Remove a function. Functions that call it get UNKNOWN_FUNC.
+ *
+ * @param registry The registry.
+ * @param name Name of the function.
+ * @return VALID_OK, or UNKNOWN_FUNC if it is not defined.
+ */
+int s21_undefine_func(func_registry *registry, const char *name) {
+  int index = s21_find_func(registry, name);
+  if (index < 0) return UNKNOWN_FUNC;
+
+  user_func *func = &registry->funcs[index];
+  s21_clear_compiled(&func->program);
+  memset(func, 0, sizeof(user_func));
+  s21_rebuild_from(registry, index);
+  return VALID_OK;
+}
+
+/**
+ * @brief Free a registry.
+ *
+ * @param registry The registry.
+ */
+void s21_clear_registry(func_registry *registry) {
+  if (registry) {
+    for (int i = 0; i < FUNC_MAX_DEFS; i++) {
+      s21_clear_compiled(&registry->funcs[i].program);
+    }
+    free(registry);
+  }
+}
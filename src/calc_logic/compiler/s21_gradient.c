@@ -0,0 +1,294 @@
+/**
+ * @file
+ * @brief Contains forward-mode differentiation of compiled programs: every
+ * stack value carries its derivatives by x and by the parameters
+ */
+
+#include "include/s21_gradient.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define GRADIENT_LN10 2.30258509299404568402
+
+/**
+ * @brief Derivative of a function of the function table at a, value being
+ * the function at a.
+ */
+static double s21_func_derivative(int func, double a, double value) {
+  math_func_ptr math_func = s21_compiled_func(func);
+  double res = NAN;
+  if (math_func == cos) {
+    res = -sin(a);
+  } else if (math_func == sin) {
+    res = cos(a);
+  } else if (math_func == tan) {
+    res = 1 + value * value;
+  } else if (math_func == acos) {
+    res = -1 / sqrt(1 - a * a);
+  } else if (math_func == asin) {
+    res = 1 / sqrt(1 - a * a);
+  } else if (math_func == atan) {
+    res = 1 / (1 + a * a);
+  } else if (math_func == sqrt) {
+    res = 0.5 / value;
+  } else if (math_func == log10) {
+    res = 1 / (a * GRADIENT_LN10);
+  } else if (math_func == log) {
+    res = 1 / a;
+  }
+  return res;
+}
+
+/**
+ * @brief Apply an operator the way the evaluators do and compute its partial
+ * derivatives by the operands.
+ */
+static double s21_partials(int op, int func, double a, double b, double *da,
+                           double *db) {
+  double res = NAN;
+  *da = 0;
+  *db = 0;
+  if (op == OP_ADD) {
+    res = a + b;
+    *da = 1;
+    *db = 1;
+  } else if (op == OP_SUB) {
+    res = a - b;
+    *da = 1;
+    *db = -1;
+  } else if (op == OP_MUL) {
+    res = a * b;
+    *da = b;
+    *db = a;
+  } else if (op == OP_DIV) {
+    res = b ? a / b : NAN;
+    *da = b ? 1 / b : NAN;
+    *db = b ? -res / b : NAN;
+  } else if (op == OP_POW) {
+    res = pow(a, b);
+    *da = b == 2 ? 2 * a : b * pow(a, b - 1);
+    *db = res * log(a);
+  } else if (op == OP_NEG) {
+    res = -a;
+    *da = -1;
+  } else if (op == OP_FUNC) {
+    res = s21_compiled_func(func)(a);
+    *da = s21_func_derivative(func, a, res);
+  }
+  return res;
+}
+
+/**
+ * @brief The chain rule for one variable. A zero derivative of an operand
+ * contributes nothing even where its partial is infinite or NAN, so 0^3 or
+ * (-2)^3 with a constant exponent keep finite derivatives.
+ */
+static double s21_chain(double da, double ta, double db, double tb) {
+  return (ta ? da * ta : 0) + (tb ? db * tb : 0);
+}
+
+static int s21_gradient_check(const compiled_expr *compiled,
+                              const double *params, int params_count) {
+  int res = compiled && compiled->code && compiled->depth > 0 &&
+                    params_count >= 0 && params_count < GRADIENT_MAX_VARS &&
+                    (params || !params_count)
+                ? VALID_OK
+                : NULL_PTR;
+  for (int i = 0; res == VALID_OK && i < compiled->count; i++) {
+    if (compiled->code[i].op == OP_PARAM &&
+        compiled->code[i].func >= params_count) {
+      res = NULL_PTR;
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Size of the scratch memory of s21_eval_gradient_into().
+ *
+ * @param compiled The program.
+ * @param params_count Number of parameters.
+ * @return Number of doubles, 0 for invalid arguments.
+ */
+size_t s21_gradient_scratch(const compiled_expr *compiled, int params_count) {
+  return compiled && compiled->depth > 0 && params_count >= 0
+             ? (size_t)compiled->depth * (2 + params_count)
+             : 0;
+}
+
+/**
+ * @brief Evaluate a program and its gradient in one pass. Every value of
+ * the stack is a dual number whose derivatives are propagated through each
+ * operator and function by the chain rule, so the gradient is exact up to
+ * rounding, unlike finite differences.
+ *
+ * @param compiled The program, from s21_compile_expr() or
+ * s21_compile_body() with parameters.
+ * @param x Value of the variable.
+ * @param params Values of the parameters, may be NULL if there are none.
+ * @param params_count Number of parameters.
+ * @param value Output for the value.
+ * @param gradient Output for 1 + params_count derivatives: by x, then by
+ * every parameter.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_eval_gradient(const compiled_expr *compiled, double x,
+                      const double *params, int params_count, double *value,
+                      double *gradient) {
+  size_t size = s21_gradient_scratch(compiled, params_count);
+  double *scratch = size ? malloc(size * sizeof(double)) : NULL;
+  int res = scratch ? s21_eval_gradient_into(compiled, x, params, params_count,
+                                             value, gradient, scratch)
+                    : NULL_PTR;
+  free(scratch);
+  return res;
+}
+
+/**
+ * @brief s21_eval_gradient() in caller memory, for loops such as Newton's
+ * method that evaluate the same program many times.
+ *
+ * @param scratch Memory for s21_gradient_scratch() doubles.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments.
+ */
+int s21_eval_gradient_into(const compiled_expr *compiled, double x,
+                           const double *params, int params_count,
+                           double *value, double *gradient, double *scratch) {
+  if (!value || !gradient || !scratch) return NULL_PTR;
+  int res = s21_gradient_check(compiled, params, params_count);
+  int vars = 1 + params_count;
+  double *values = scratch;
+  double *tangents = values + (res == VALID_OK ? compiled->depth : 0);
+
+  for (int i = 0; res == VALID_OK && i < compiled->count; i++) {
+    expr_token token = compiled->code[i];
+    double *a = values + token.slot;
+    double *ta = tangents + token.slot * vars;
+    if (token.op == OP_CONST || token.op == OP_X || token.op == OP_PARAM) {
+      memset(ta, 0, vars * sizeof(double));
+    }
+    if (token.op == OP_CONST) {
+      *a = compiled->literals[token.literal];
+    } else if (token.op == OP_X) {
+      *a = x;
+      ta[0] = 1;
+    } else if (token.op == OP_PARAM) {
+      *a = params[token.func];
+      ta[1 + token.func] = 1;
+    } else {
+      int binary = token.op >= OP_ADD && token.op <= OP_POW;
+      const double *tb = ta + vars;
+      double da = 0;
+      double db = 0;
+      *a = s21_partials(token.op, token.func, *a, binary ? a[1] : 0, &da, &db);
+      for (int k = 0; k < vars; k++) {
+        ta[k] = s21_chain(da, ta[k], db, binary ? tb[k] : 0);
+      }
+    }
+  }
+
+  if (res == VALID_OK) {
+    *value = values[0];
+    memcpy(gradient, tangents, vars * sizeof(double));
+  }
+  return res;
+}
+
+/**
+ * @brief Run the program with derivatives over a block of x values. A slot
+ * is a value row followed by one tangent row per variable, and the chain
+ * rule is a loop over each tangent row, which the compiler vectorizes.
+ */
+static void s21_gradient_block(const compiled_expr *compiled,
+                               const double *params, int vars,
+                               double *stack, const double *x, size_t count) {
+  size_t slot_size = (size_t)(1 + vars) * EXPR_BLOCK;
+  double *da = stack + compiled->depth * slot_size;
+  double *db = da + EXPR_BLOCK;
+
+  for (int i = 0; i < compiled->count; i++) {
+    expr_token token = compiled->code[i];
+    double *a = stack + token.slot * slot_size;
+    double *tangents = a + EXPR_BLOCK;
+    if (token.op == OP_CONST || token.op == OP_X || token.op == OP_PARAM) {
+      memset(tangents, 0, vars * EXPR_BLOCK * sizeof(double));
+      if (token.op == OP_X) {
+        memcpy(a, x, count * sizeof(double));
+        for (size_t j = 0; j < count; j++) tangents[j] = 1;
+      } else {
+        double value = token.op == OP_CONST
+                           ? compiled->literals[token.literal]
+                           : params[token.func];
+        for (size_t j = 0; j < count; j++) a[j] = value;
+      }
+      if (token.op == OP_PARAM) {
+        double *tp = tangents + (1 + token.func) * EXPR_BLOCK;
+        for (size_t j = 0; j < count; j++) tp[j] = 1;
+      }
+      continue;
+    }
+
+    int binary = token.op >= OP_ADD && token.op <= OP_POW;
+    const double *b = a + slot_size;
+    for (size_t j = 0; j < count; j++) {
+      a[j] = s21_partials(token.op, token.func, a[j], binary ? b[j] : 0,
+                          &da[j], &db[j]);
+    }
+    for (int k = 0; k < vars; k++) {
+      double *ta = tangents + k * EXPR_BLOCK;
+      if (binary) {
+        const double *tb = b + (1 + k) * EXPR_BLOCK;
+        for (size_t j = 0; j < count; j++) {
+          ta[j] = s21_chain(da[j], ta[j], db[j], tb[j]);
+        }
+      } else {
+        for (size_t j = 0; j < count; j++) {
+          ta[j] = s21_chain(da[j], ta[j], 0, 0);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Evaluate a program and its gradient over an array of x values,
+ * EXPR_BLOCK values at a time, with the same parameters for every value.
+ *
+ * @param compiled The program.
+ * @param x Values of the variable.
+ * @param params Values of the parameters, may be NULL if there are none.
+ * @param params_count Number of parameters.
+ * @param y Output for the values.
+ * @param gradient Output for (1 + params_count) * count derivatives: the
+ * derivatives by x at gradient, by parameter k at gradient + (1 + k) *
+ * count.
+ * @param count Number of values.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_eval_gradient_batch(const compiled_expr *compiled, const double *x,
+                            const double *params, int params_count,
+                            double *y, double *gradient, size_t count) {
+  int res = s21_gradient_check(compiled, params, params_count);
+  if (res != VALID_OK || !count) return res;
+  if (!x || !y || !gradient) return NULL_PTR;
+
+  int vars = 1 + params_count;
+  size_t slot_size = (size_t)(1 + vars) * EXPR_BLOCK;
+  double *stack =
+      malloc((compiled->depth * slot_size + 2 * EXPR_BLOCK) * sizeof(double));
+  if (!stack) return NULL_PTR;
+  for (size_t i = 0; i < count; i += EXPR_BLOCK) {
+    size_t block = count - i < EXPR_BLOCK ? count - i : EXPR_BLOCK;
+    s21_gradient_block(compiled, params, vars, stack, x + i, block);
+    memcpy(y + i, stack, block * sizeof(double));
+    for (int k = 0; k < vars; k++) {
+      memcpy(gradient + k * count + i, stack + (1 + k) * EXPR_BLOCK,
+             block * sizeof(double));
+    }
+  }
+  free(stack);
+  return VALID_OK;
+}
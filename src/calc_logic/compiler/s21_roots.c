@@ -0,0 +1,446 @@
+/**
+ * @file
+ * @brief Contains roots and minima of compiled expressions of x: brackets
+ * come from a batch scan of the interval and are refined by Newton's method
+ * safeguarded by bisection, or by Brent's methods
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_roots.h"
+
+#include <float.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "include/s21_gradient.h"
+
+#define ROOTS_GOLDEN 0.3819660112501051518
+#define ROOTS_MIN_ABSOLUTE 1e-10
+
+/**
+ * @brief Problems of a batch solved by one thread: begin to end.
+ */
+typedef struct roots_worker {
+  const compiled_expr *programs;
+  const double *a;
+  const double *b;
+  double *roots;
+  size_t begin;
+  size_t end;
+  int status;
+} roots_worker;
+
+/**
+ * @brief Name of a solver the parser evaluates through compiled programs.
+ *
+ * @return ROOT_SOLVE, ROOT_MINIMIZE or ROOT_NONE.
+ */
+int s21_root_kind(const char *name) {
+  int res = ROOT_NONE;
+  if (name && !strcmp(name, "solve")) {
+    res = ROOT_SOLVE;
+  } else if (name && !strcmp(name, "minimize")) {
+    res = ROOT_MINIMIZE;
+  }
+  return res;
+}
+
+static int s21_same_sign(double a, double b) {
+  return (a > 0 && b > 0) || (a < 0 && b < 0);
+}
+
+/**
+ * @brief Evaluate the program at ROOTS_SCAN_POINTS equally spaced points
+ * from a to b with one batch evaluation.
+ */
+static int s21_roots_scan(const compiled_expr *compiled, double a, double b,
+                          double *x, double *y) {
+  double step = (b - a) / (ROOTS_SCAN_POINTS - 1);
+  for (int i = 0; i < ROOTS_SCAN_POINTS; i++) x[i] = a + step * i;
+  x[ROOTS_SCAN_POINTS - 1] = b;
+  return s21_eval_compiled_batch(compiled, x, y, ROOTS_SCAN_POINTS);
+}
+
+/**
+ * @brief Brent's root finder on a bracket, f(a) and f(b) being of opposite
+ * signs: inverse quadratic interpolation or secant steps while they shrink
+ * the bracket fast enough, bisection otherwise.
+ */
+static double s21_brent_root(const compiled_expr *compiled, double a,
+                             double b, double fa, double fb) {
+  double c = b;
+  double fc = fb;
+  double d = b - a;
+  double e = d;
+  for (int iter = 0; iter < ROOTS_MAX_ITER; iter++) {
+    if (s21_same_sign(fb, fc)) {
+      c = a;
+      fc = fa;
+      d = e = b - a;
+    }
+    if (fabs(fc) < fabs(fb)) {
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
+    }
+    double tol = 2 * DBL_EPSILON * fabs(b) + DBL_MIN;
+    double m = 0.5 * (c - b);
+    if (fabs(m) <= tol || fb == 0) break;
+    if (fabs(e) >= tol && fabs(fa) > fabs(fb)) {
+      double s = fb / fa;
+      double p = 0;
+      double q = 0;
+      if (a == c) {
+        p = 2 * m * s;
+        q = 1 - s;
+      } else {
+        double r = fb / fc;
+        q = fa / fc;
+        p = s * (2 * m * q * (q - r) - (b - a) * (r - 1));
+        q = (q - 1) * (r - 1) * (s - 1);
+      }
+      if (p > 0) q = -q;
+      p = fabs(p);
+      if (2 * p < fmin(3 * m * q - fabs(tol * q), fabs(e * q))) {
+        e = d;
+        d = p / q;
+      } else {
+        d = e = m;
+      }
+    } else {
+      d = e = m;
+    }
+    a = b;
+    fa = fb;
+    b += fabs(d) > tol ? d : copysign(tol, m);
+    fb = s21_eval_compiled(compiled, b);
+  }
+  return b;
+}
+
+/**
+ * @brief Newton's method on a bracket, falling back to bisection when a step
+ * leaves the bracket or shrinks it slower than bisection would, and to
+ * Brent's method where the derivative is not finite.
+ */
+static double s21_newton_root(const compiled_expr *compiled, double lo,
+                              double hi, double flo, double fhi,
+                              double *scratch) {
+  if (flo > 0) {
+    double t = lo;
+    lo = hi;
+    hi = t;
+    t = flo;
+    flo = fhi;
+    fhi = t;
+  }
+  double root = 0.5 * (lo + hi);
+  double dx = fabs(hi - lo);
+  double dx_old = dx;
+  double f = NAN;
+  double df = NAN;
+  int res =
+      s21_eval_gradient_into(compiled, root, NULL, 0, &f, &df, scratch);
+  for (int iter = 0; res == VALID_OK && iter < ROOTS_MAX_ITER; iter++) {
+    if (!isfinite(f) || !isfinite(df)) {
+      return s21_brent_root(compiled, lo, hi, flo, fhi);
+    }
+    if (((root - hi) * df - f) * ((root - lo) * df - f) > 0 ||
+        fabs(2 * f) > fabs(dx_old * df)) {
+      dx_old = dx;
+      dx = 0.5 * (hi - lo);
+      root = lo + dx;
+      if (root == lo) break;
+    } else {
+      double previous = root;
+      dx_old = dx;
+      dx = f / df;
+      root -= dx;
+      if (root == previous) break;
+    }
+    if (fabs(dx) <= 2 * DBL_EPSILON * fabs(root) + DBL_MIN || f == 0) break;
+    res = s21_eval_gradient_into(compiled, root, NULL, 0, &f, &df, scratch);
+    if (f < 0) {
+      lo = root;
+      flo = f;
+    } else {
+      hi = root;
+      fhi = f;
+    }
+  }
+  return root;
+}
+
+/**
+ * @brief Refine a bracket of the scan and reject poles: a sign change where
+ * the expression grows past its values at the ends of the bracket, as tan
+ * does at pi/2, is not a root. scratch holds s21_gradient_scratch() doubles,
+ * allocated once per solve.
+ */
+static int s21_refine_root(const compiled_expr *compiled, double lo,
+                           double hi, double flo, double fhi, double *scratch,
+                           double *root) {
+  *root = s21_newton_root(compiled, lo, hi, flo, fhi, scratch);
+  return fabs(s21_eval_compiled(compiled, *root)) <=
+         fmax(fabs(flo), fabs(fhi));
+}
+
+/**
+ * @brief Find the roots of a compiled expression of x from a to b.
+ *
+ * The interval is scanned at ROOTS_SCAN_POINTS points with one batch
+ * evaluation. Every sign change between neighbouring points is a bracket,
+ * refined by Newton's method with the exact derivative of
+ * s21_eval_gradient(), safeguarded by bisection, or by Brent's method where
+ * the derivative is not finite. Roots are found to a few ulps; roots where
+ * the expression touches zero without changing sign between two points of
+ * the scan are missed.
+ *
+ * @param compiled Program of x.
+ * @param a The lower bound.
+ * @param b The upper bound.
+ * @param roots Output for up to max_roots roots in ascending order.
+ * @param max_roots Size of roots.
+ * @param count Output for the number of roots found.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_solve_expr(const compiled_expr *compiled, double a, double b,
+                   double *roots, int max_roots, int *count) {
+  if (!compiled || !compiled->code || !count || max_roots < 0 ||
+      (!roots && max_roots)) {
+    return NULL_PTR;
+  }
+  *count = 0;
+  if (!isfinite(a) || !isfinite(b)) return VALID_OK;
+  if (a > b) {
+    double t = a;
+    a = b;
+    b = t;
+  }
+  size_t scratch_size = s21_gradient_scratch(compiled, 0);
+  double *x = malloc((2 * ROOTS_SCAN_POINTS + scratch_size) * sizeof(double));
+  if (!x) return NULL_PTR;
+  double *y = x + ROOTS_SCAN_POINTS;
+  double *scratch = y + ROOTS_SCAN_POINTS;
+
+  int res = s21_roots_scan(compiled, a, b, x, y);
+  int points = a == b ? 1 : ROOTS_SCAN_POINTS;
+  for (int i = 0; res == VALID_OK && *count < max_roots && i < points; i++) {
+    double root = x[i];
+    if (y[i] == 0 ||
+        (i + 1 < points && s21_same_sign(-y[i], y[i + 1]) &&
+         s21_refine_root(compiled, x[i], x[i + 1], y[i], y[i + 1], scratch,
+                         &root))) {
+      roots[(*count)++] = root;
+    }
+  }
+  free(x);
+  return res;
+}
+
+/**
+ * @brief Brent's minimizer on [lo, hi]: parabolic interpolation through the
+ * three best points while it converges, golden section otherwise.
+ */
+static double s21_brent_min(const compiled_expr *compiled, double lo,
+                            double hi, double *y) {
+  double x = lo + ROOTS_GOLDEN * (hi - lo);
+  double w = x;
+  double v = x;
+  double fx = s21_eval_compiled(compiled, x);
+  double fw = fx;
+  double fv = fx;
+  double d = 0;
+  double e = 0;
+  for (int iter = 0; iter < ROOTS_MAX_ITER; iter++) {
+    double middle = 0.5 * (lo + hi);
+    double tol = ROOTS_MIN_TOLERANCE * fabs(x) + ROOTS_MIN_ABSOLUTE;
+    if (fabs(x - middle) <= 2 * tol - 0.5 * (hi - lo)) break;
+    int golden = 1;
+    if (fabs(e) > tol) {
+      double r = (x - w) * (fx - fv);
+      double q = (x - v) * (fx - fw);
+      double p = (x - v) * q - (x - w) * r;
+      q = 2 * (q - r);
+      if (q > 0) p = -p;
+      q = fabs(q);
+      if (fabs(p) < fabs(0.5 * q * e) && p > q * (lo - x) &&
+          p < q * (hi - x)) {
+        e = d;
+        d = p / q;
+        golden = 0;
+        if (x + d - lo < 2 * tol || hi - x - d < 2 * tol) {
+          d = copysign(tol, middle - x);
+        }
+      }
+    }
+    if (golden) {
+      e = x >= middle ? lo - x : hi - x;
+      d = ROOTS_GOLDEN * e;
+    }
+    double u = fabs(d) >= tol ? x + d : x + copysign(tol, d);
+    double fu = s21_eval_compiled(compiled, u);
+    if (fu <= fx) {
+      if (u >= x) {
+        lo = x;
+      } else {
+        hi = x;
+      }
+      v = w;
+      w = x;
+      x = u;
+      fv = fw;
+      fw = fx;
+      fx = fu;
+    } else {
+      if (u < x) {
+        lo = u;
+      } else {
+        hi = u;
+      }
+      if (fu <= fw || w == x) {
+        v = w;
+        w = u;
+        fv = fw;
+        fw = fu;
+      } else if (fu <= fv || v == x || v == w) {
+        v = u;
+        fv = fu;
+      }
+    }
+  }
+  *y = fx;
+  return x;
+}
+
+/**
+ * @brief Find the smallest value of a compiled expression of x from a to b.
+ *
+ * The interval is scanned at ROOTS_SCAN_POINTS points with one batch
+ * evaluation, and Brent's minimizer refines the best point between its
+ * neighbours, so the minimum is global unless a narrower one falls between
+ * two points of the scan. The position is found to about
+ * ROOTS_MIN_TOLERANCE relative, the limit set by rounding of the values
+ * near a minimum.
+ *
+ * @param compiled Program of x.
+ * @param a The lower bound.
+ * @param b The upper bound.
+ * @param x Output for the position of the minimum, NAN if the expression is
+ * not defined on the interval.
+ * @param y Output for the minimum, may be NULL.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_minimize_expr(const compiled_expr *compiled, double a, double b,
+                      double *x, double *y) {
+  if (!compiled || !compiled->code || !x) return NULL_PTR;
+  double value = NAN;
+  *x = NAN;
+  if (!isfinite(a) || !isfinite(b)) {
+    if (y) *y = value;
+    return VALID_OK;
+  }
+  if (a > b) {
+    double t = a;
+    a = b;
+    b = t;
+  }
+  double *points = malloc(2 * ROOTS_SCAN_POINTS * sizeof(double));
+  if (!points) return NULL_PTR;
+  double *values = points + ROOTS_SCAN_POINTS;
+
+  int res = s21_roots_scan(compiled, a, b, points, values);
+  int best = -1;
+  for (int i = 0; res == VALID_OK && i < ROOTS_SCAN_POINTS; i++) {
+    if (!isnan(values[i]) && (best < 0 || values[i] < values[best])) best = i;
+  }
+  if (best >= 0) {
+    double lo = points[best > 0 ? best - 1 : 0];
+    double hi = points[best < ROOTS_SCAN_POINTS - 1 ? best + 1 : best];
+    *x = s21_brent_min(compiled, lo, hi, &value);
+    if (!(value <= values[best])) {
+      *x = points[best];
+      value = values[best];
+    }
+  }
+  if (y) *y = value;
+  free(points);
+  return res;
+}
+
+static void *s21_roots_worker(void *arg) {
+  roots_worker *worker = arg;
+  for (size_t i = worker->begin;
+       worker->status == VALID_OK && i < worker->end; i++) {
+    int count = 0;
+    worker->roots[i] = NAN;
+    worker->status = s21_solve_expr(&worker->programs[i], worker->a[i],
+                                    worker->b[i], &worker->roots[i], 1,
+                                    &count);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Find the first root of many independent problems, split between
+ * threads in contiguous ranges.
+ *
+ * @param programs Programs of x, one per problem; the same program may be
+ * repeated with different intervals.
+ * @param a The lower bounds.
+ * @param b The upper bounds.
+ * @param roots Output for the smallest root of every problem, NAN where
+ * there is none.
+ * @param count Number of problems.
+ * @param threads Maximum number of threads, <= 0 uses all cores; fewer than
+ * ROOTS_PARALLEL_MIN problems run on the calling thread.
+ * @return VALID_OK on success, NULL_PTR on invalid arguments or allocation
+ * failure.
+ */
+int s21_solve_batch(const compiled_expr *programs, const double *a,
+                    const double *b, double *roots, size_t count,
+                    int threads) {
+  if (!count) return VALID_OK;
+  if (!programs || !a || !b || !roots) return NULL_PTR;
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads <= 0 || count < ROOTS_PARALLEL_MIN) threads = 1;
+  if ((size_t)threads > count) threads = (int)count;
+  roots_worker *workers = calloc(threads, sizeof(roots_worker));
+  if (!workers) return NULL_PTR;
+
+  pthread_t ids[threads];
+  int created[threads];
+  for (int i = 0; i < threads; i++) {
+    workers[i] = (roots_worker){programs,
+                                a,
+                                b,
+                                roots,
+                                count * i / threads,
+                                count * (i + 1) / threads,
+                                VALID_OK};
+    if (i) {
+      created[i] = !pthread_create(&ids[i], NULL, s21_roots_worker,
+                                   &workers[i]);
+    }
+  }
+  s21_roots_worker(&workers[0]);
+  int res = workers[0].status;
+  for (int i = 1; i < threads; i++) {
+    if (created[i]) {
+      pthread_join(ids[i], NULL);
+    } else {
+      s21_roots_worker(&workers[i]);
+    }
+    if (res == VALID_OK) res = workers[i].status;
+  }
+  free(workers);
+  return res;
+}
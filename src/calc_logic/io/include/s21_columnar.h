@@ -0,0 +1,81 @@
+#ifndef S21_COLUMNAR_H
+#define S21_COLUMNAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../bank_calc/include/s21_credit_calc.h"
+#include "../../bank_calc/include/s21_credit_schedule.h"
+
+#define COLUMNAR_MAGIC "S21C"
+#define COLUMNAR_VERSION 1
+#define COLUMNAR_ALIGN 64
+#define COLUMNAR_NAME_SIZE 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum columnar_return_codes { COLUMNAR_OK, COLUMNAR_ERROR };
+enum columnar_type { COL_F64, COL_I64, COL_I32 };
+enum columnar_encoding { COL_RAW, COL_DELTA };
+
+/**
+ * @brief File header, stored little-endian at offset 0.
+ */
+typedef struct columnar_header {
+  char magic[4];
+  uint16_t version;
+  uint16_t columns;
+  uint32_t flags;
+  uint32_t reserved;
+  uint64_t rows;
+  uint8_t padding[40];
+} columnar_header;
+
+/**
+ * @brief Column descriptor, stored right after the header.
+ */
+typedef struct columnar_column {
+  char name[COLUMNAR_NAME_SIZE];
+  uint8_t type;
+  uint8_t encoding;
+  uint16_t reserved;
+  uint32_t width;
+  uint64_t offset;
+  uint64_t size;
+  uint64_t padding;
+} columnar_column;
+
+typedef struct columnar_spec {
+  const char *name;
+  int type;
+  int encoding;
+  const void *data;
+} columnar_spec;
+
+typedef struct columnar_file {
+  void *map;
+  size_t size;
+  uint64_t rows;
+  int columns;
+  const columnar_column *desc;
+} columnar_file;
+
+int s21_columnar_write(const char *path, const columnar_spec *columns,
+                       int count, uint64_t rows);
+int s21_columnar_open(const char *path, columnar_file *file);
+int s21_columnar_find(const columnar_file *file, const char *name);
+const void *s21_columnar_data(const columnar_file *file, int column);
+int s21_columnar_read(const columnar_file *file, int column, void *out);
+void s21_columnar_close(columnar_file *file);
+
+int s21_columnar_write_schedule(const char *path,
+                                const credit_schedule *schedule);
+int s21_columnar_write_credit_batch(const char *path, credit_batch batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_COLUMNAR_H
@@ -0,0 +1,76 @@
+#ifndef S21_FORMULA_FILE_H
+#define S21_FORMULA_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../compiler/include/s21_compiler.h"
+
+#define FORMULA_MAGIC "S21F"
+#define FORMULA_VERSION 1
+#define FORMULA_ALIGN 64
+#define FORMULA_FUNC_NAME 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum formula_return_codes { FORMULA_OK, FORMULA_ERROR };
+
+/**
+ * @brief File header, stored little-endian at offset 0. The checksum covers
+ * everything after the header.
+ */
+typedef struct formula_header {
+  char magic[4];
+  uint16_t version;
+  uint16_t funcs;
+  uint32_t count;
+  uint32_t reserved;
+  uint64_t size;
+  uint64_t checksum;
+  uint64_t index_offset;
+  uint64_t literals_offset;
+  uint64_t code_offset;
+  uint64_t padding;
+} formula_header;
+
+/**
+ * @brief Index entry of a formula. code and literals are positions in the
+ * shared instruction stream and literal pool.
+ */
+typedef struct formula_entry {
+  uint32_t code;
+  uint16_t count;
+  uint16_t depth;
+  uint32_t literals;
+  uint32_t literals_count;
+} formula_entry;
+
+/**
+ * @brief Precompiled formulas read in place through a memory mapping.
+ */
+typedef struct formula_file {
+  void *map;
+  size_t size;
+  uint32_t count;
+  int funcs;
+  const formula_entry *index;
+  const double *literals;
+  uint64_t literals_count;
+  const expr_token *code;
+  uint64_t code_count;
+} formula_file;
+
+int s21_formula_write(const char *path, const compiled_expr *programs,
+                      uint32_t count);
+int s21_formula_open(const char *path, formula_file *file);
+int s21_formula_get(const formula_file *file, uint32_t id,
+                    compiled_expr *program);
+void s21_formula_close(formula_file *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_FORMULA_FILE_H
@@ -0,0 +1,85 @@
+#ifndef S21_HISTORY_H
+#define S21_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HISTORY_MAGIC "S21H"
+#define HISTORY_VERSION 1
+#define HISTORY_MAX_LEN 255
+#define HISTORY_ALPHABET 64
+#define HISTORY_TRIGRAMS \
+  (HISTORY_ALPHABET * HISTORY_ALPHABET * HISTORY_ALPHABET)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum history_return_codes { HISTORY_OK, HISTORY_ERROR };
+enum history_search_mode { HISTORY_SUBSTRING, HISTORY_PREFIX };
+
+/**
+ * @brief File header, followed by the records.
+ */
+typedef struct history_header {
+  char magic[4];
+  uint32_t version;
+  uint64_t reserved;
+} history_header;
+
+/**
+ * @brief Record header, followed by the null-terminated expression and
+ * padding to 8 bytes.
+ */
+typedef struct history_record {
+  uint32_t length;
+  uint32_t reserved;
+  int64_t timestamp;
+  double result;
+} history_record;
+
+typedef struct history_entry {
+  int64_t timestamp;
+  double result;
+  const char *expr;
+  size_t length;
+} history_entry;
+
+typedef struct history_postings {
+  uint32_t *ids;
+  uint32_t count;
+  uint32_t capacity;
+} history_postings;
+
+/**
+ * @brief Append-only calculation history read through a memory mapping.
+ * Record offsets and the trigram index are built on first use and then
+ * extended with the appended records only.
+ */
+typedef struct calc_history {
+  int fd;
+  const char *map;
+  size_t map_size;
+  size_t file_size;
+  uint64_t *offsets;
+  size_t count;
+  size_t capacity;
+  size_t scanned;
+  history_postings *index;
+  size_t indexed;
+} calc_history;
+
+int s21_history_open(const char *path, calc_history *history);
+int s21_history_append(calc_history *history, const char *expr, double result,
+                       int64_t timestamp);
+size_t s21_history_count(calc_history *history);
+int s21_history_get(calc_history *history, size_t id, history_entry *entry);
+size_t s21_history_search(calc_history *history, const char *query, int mode,
+                          size_t *ids, size_t max);
+void s21_history_close(calc_history *history);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_HISTORY_H
@@ -0,0 +1,33 @@
+#ifndef S21_LOAN_BOOK_H
+#define S21_LOAN_BOOK_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum loan_book_return_codes { LOAN_BOOK_OK, LOAN_BOOK_ERROR };
+
+/**
+ * @brief Columns of a loan book, ready for s21_credit_calc_batch().
+ */
+typedef struct loan_book {
+  size_t count;
+  size_t bad_rows;
+  double *amount;
+  double *term;
+  double *rate;
+  int *type;
+} loan_book;
+
+int s21_load_loan_book(const char *path, int threads, loan_book *book);
+int s21_parse_loan_book(const char *data, size_t size, int threads,
+                        loan_book *book);
+void s21_clear_loan_book(loan_book *book);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_LOAN_BOOK_H
@@ -0,0 +1,86 @@
+#ifndef S21_PROTOCOL_H
+#define S21_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROTO_MAX_EXPR 255
+#define PROTO_MAX_BODY 256
+#define PROTO_MAX_VALUES 3
+#define PROTO_MAX_FRAME (sizeof(proto_header) + PROTO_MAX_BODY)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum proto_return_codes { PROTO_OK, PROTO_INCOMPLETE, PROTO_ERROR };
+enum proto_request_type { PROTO_EXPR = 1, PROTO_CREDIT, PROTO_DEPOSIT };
+enum proto_status {
+  PROTO_STATUS_OK,
+  PROTO_STATUS_BAD_REQUEST,
+  PROTO_STATUS_INVALID_EXPR
+};
+
+/**
+ * @brief Header of every frame, in host byte order since the socket is local.
+ * A request is followed by length bytes of arguments, a response by length
+ * bytes of double results. A response with PROTO_STATUS_INVALID_EXPR holds
+ * the validation error code of the expression instead of a result.
+ */
+typedef struct proto_header {
+  uint32_t length;
+  uint32_t id;
+  uint16_t type;
+  uint16_t status;
+} proto_header;
+
+/**
+ * @brief Arguments of a credit request.
+ */
+typedef struct proto_credit {
+  double amount;
+  double term;
+  double rate;
+  int32_t type;
+  int32_t reserved;
+} proto_credit;
+
+/**
+ * @brief Arguments of a deposit request.
+ */
+typedef struct proto_deposit {
+  double amount;
+  double term;
+  double rate;
+  double tax;
+  double pay_frequency;
+  double replen;
+  double withdrawals;
+  int32_t capital_percent;
+  int32_t reserved;
+} proto_deposit;
+
+/**
+ * @brief A decoded frame. The body points into the parsed buffer.
+ */
+typedef struct proto_frame {
+  proto_header header;
+  const char *body;
+  size_t size;
+} proto_frame;
+
+size_t s21_proto_expr(char *buffer, size_t capacity, uint32_t id,
+                      const char *expr);
+size_t s21_proto_credit(char *buffer, size_t capacity, uint32_t id,
+                        proto_credit credit);
+size_t s21_proto_deposit(char *buffer, size_t capacity, uint32_t id,
+                         proto_deposit deposit);
+int s21_proto_next(const char *data, size_t size, proto_frame *frame);
+size_t s21_proto_execute(const proto_frame *request, char *response);
+size_t s21_proto_values(const proto_frame *response, double *values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_PROTOCOL_H
@@ -0,0 +1,89 @@
+#ifndef S21_SHM_RING_H
+#define S21_SHM_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../translator/include/translator.h"
+
+#define SHM_MAGIC "S21R"
+#define SHM_VERSION 1
+#define SHM_RING_SIZE 1024
+#define SHM_MAX_EXPRS 256
+#define SHM_EXPR_SIZE 256
+#define SHM_SPINS 20000
+#define SHM_CACHE_LINE 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum shm_return_codes { SHM_OK, SHM_EMPTY, SHM_FULL, SHM_ERROR };
+enum shm_message_type { SHM_COMPILE = 1, SHM_EVAL, SHM_STOP };
+
+/**
+ * @brief A request or a response. Requests name a compiled expression and
+ * the value of x, responses carry the result and a validation code.
+ */
+typedef struct shm_message {
+  uint32_t id;
+  uint32_t type;
+  uint32_t expr;
+  int32_t status;
+  double x;
+  double result;
+} shm_message;
+
+/**
+ * @brief Single-producer single-consumer ring. The producer only writes head,
+ * the consumer only writes tail, and each lives on its own cache line. The
+ * consumer sets sleeping before it waits on the futex, so the producer makes
+ * a syscall only when the consumer is actually asleep.
+ */
+typedef struct shm_ring {
+  _Alignas(SHM_CACHE_LINE) _Atomic uint32_t head;
+  _Alignas(SHM_CACHE_LINE) _Atomic uint32_t tail;
+  _Alignas(SHM_CACHE_LINE) _Atomic uint32_t sleeping;
+  _Alignas(SHM_CACHE_LINE) shm_message slots[SHM_RING_SIZE];
+} shm_ring;
+
+/**
+ * @brief Layout of the shared file: requests from the client, responses from
+ * the server, and the text of the registered expressions.
+ */
+typedef struct shm_region {
+  char magic[4];
+  uint32_t version;
+  shm_ring requests;
+  shm_ring responses;
+  char exprs[SHM_MAX_EXPRS][SHM_EXPR_SIZE];
+} shm_region;
+
+typedef struct shm_channel {
+  shm_region *region;
+  uint32_t next_id;
+  uint32_t exprs;
+  int spins;
+} shm_channel;
+
+int s21_shm_create(const char *path, shm_channel *channel);
+int s21_shm_attach(const char *path, shm_channel *channel);
+void s21_shm_detach(shm_channel *channel);
+
+int s21_ring_push(shm_ring *ring, const shm_message *message);
+int s21_ring_pop(shm_ring *ring, shm_message *message);
+int s21_ring_wait(shm_ring *ring, int spins, const struct timespec *timeout);
+
+int s21_shm_register(shm_channel *channel, const char *expr, uint32_t *id);
+int s21_shm_eval(shm_channel *channel, uint32_t expr, double x,
+                 double *result);
+int s21_shm_stop(shm_channel *channel);
+int s21_shm_serve(shm_channel *channel, const volatile int *stop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_SHM_RING_H
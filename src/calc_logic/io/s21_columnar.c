@@ -0,0 +1,371 @@
+/**
+ * @file
+ * @brief Contains columnar binary format for schedules and batch results
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_columnar.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define COLUMNAR_BLOCK_ROWS 65536
+#define COLUMNAR_MAX_WRITE (1 << 30)
+
+/* The format is little-endian and read in place, so only such hosts work. */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define COLUMNAR_NATIVE 0
+#else
+#define COLUMNAR_NATIVE 1
+#endif
+
+_Static_assert(sizeof(columnar_header) == COLUMNAR_ALIGN, "header layout");
+_Static_assert(sizeof(columnar_column) == COLUMNAR_ALIGN, "column layout");
+
+static uint64_t s21_align(uint64_t value) {
+  return (value + COLUMNAR_ALIGN - 1) / COLUMNAR_ALIGN * COLUMNAR_ALIGN;
+}
+
+static uint32_t s21_type_width(int type) { return type == COL_I32 ? 4 : 8; }
+
+/**
+ * @brief Write the whole buffer, retrying partial writes.
+ */
+static int s21_write_all(int fd, const void *data, size_t size) {
+  const char *p = data;
+  while (size) {
+    size_t part = size < COLUMNAR_MAX_WRITE ? size : COLUMNAR_MAX_WRITE;
+    ssize_t done = write(fd, p, part);
+    if (done <= 0) return COLUMNAR_ERROR;
+    p += done;
+    size -= (size_t)done;
+  }
+  return COLUMNAR_OK;
+}
+
+/**
+ * @brief Delta-encode values of the given width. Deltas are taken in unsigned
+ * integer arithmetic on the raw bits, so doubles round-trip exactly too.
+ */
+static void s21_delta_encode(const void *src, void *dst, size_t count,
+                             uint32_t width, uint64_t *prev) {
+  for (size_t i = 0; i < count; i++) {
+    if (width == 8) {
+      uint64_t cur = 0;
+      memcpy(&cur, (const char *)src + i * 8, 8);
+      uint64_t delta = cur - *prev;
+      memcpy((char *)dst + i * 8, &delta, 8);
+      *prev = cur;
+    } else {
+      uint32_t cur = 0;
+      memcpy(&cur, (const char *)src + i * 4, 4);
+      uint32_t delta = cur - (uint32_t)*prev;
+      memcpy((char *)dst + i * 4, &delta, 4);
+      *prev = cur;
+    }
+  }
+}
+
+/**
+ * @brief Write one column at the current file position.
+ */
+static int s21_write_column(int fd, const columnar_spec *spec, uint64_t rows) {
+  uint32_t width = s21_type_width(spec->type);
+  if (spec->encoding == COL_RAW) {
+    return s21_write_all(fd, spec->data, rows * width);
+  }
+
+  int res = COLUMNAR_ERROR;
+  char *block = malloc((size_t)COLUMNAR_BLOCK_ROWS * width);
+  if (block) {
+    uint64_t prev = 0;
+    res = COLUMNAR_OK;
+    for (uint64_t row = 0; row < rows && res == COLUMNAR_OK;
+         row += COLUMNAR_BLOCK_ROWS) {
+      size_t count = rows - row < COLUMNAR_BLOCK_ROWS ? (size_t)(rows - row)
+                                                      : COLUMNAR_BLOCK_ROWS;
+      s21_delta_encode((const char *)spec->data + row * width, block, count,
+                       width, &prev);
+      res = s21_write_all(fd, block, count * width);
+    }
+    free(block);
+  }
+  return res;
+}
+
+/**
+ * @brief Write columns into a columnar file: a 64-byte header, one 64-byte
+ * descriptor per column and 64-byte aligned fixed-width column data.
+ *
+ * @param path Path to the output file.
+ * @param columns Column specs, data must hold rows values of the type.
+ * @param count Number of columns.
+ * @param rows Number of rows.
+ * @return COLUMNAR_OK on success, COLUMNAR_ERROR otherwise.
+ */
+int s21_columnar_write(const char *path, const columnar_spec *columns,
+                       int count, uint64_t rows) {
+  if (!COLUMNAR_NATIVE || !path || !columns || count <= 0 ||
+      count > UINT16_MAX) {
+    return COLUMNAR_ERROR;
+  }
+
+  size_t meta_size = s21_align(sizeof(columnar_header) +
+                               (size_t)count * sizeof(columnar_column));
+  char *meta = calloc(1, meta_size);
+  if (!meta) return COLUMNAR_ERROR;
+
+  columnar_header *header = (columnar_header *)meta;
+  columnar_column *desc = (columnar_column *)(header + 1);
+  memcpy(header->magic, COLUMNAR_MAGIC, 4);
+  header->version = COLUMNAR_VERSION;
+  header->columns = (uint16_t)count;
+  header->rows = rows;
+
+  int res = COLUMNAR_OK;
+  uint64_t offset = meta_size;
+  for (int i = 0; i < count && res == COLUMNAR_OK; i++) {
+    const columnar_spec *spec = &columns[i];
+    if (!spec->name || strlen(spec->name) >= COLUMNAR_NAME_SIZE ||
+        (!spec->data && rows) || spec->type < COL_F64 ||
+        spec->type > COL_I32 || spec->encoding < COL_RAW ||
+        spec->encoding > COL_DELTA) {
+      res = COLUMNAR_ERROR;
+    } else {
+      strcpy(desc[i].name, spec->name);
+      desc[i].type = (uint8_t)spec->type;
+      desc[i].encoding = (uint8_t)spec->encoding;
+      desc[i].width = s21_type_width(spec->type);
+      desc[i].offset = offset;
+      desc[i].size = rows * desc[i].width;
+      offset = s21_align(offset + desc[i].size);
+    }
+  }
+
+  int fd = res == COLUMNAR_OK ? open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+                              : -1;
+  if (fd < 0) res = COLUMNAR_ERROR;
+  if (res == COLUMNAR_OK) res = s21_write_all(fd, meta, meta_size);
+
+  char zeros[COLUMNAR_ALIGN] = {0};
+  for (int i = 0; i < count && res == COLUMNAR_OK; i++) {
+    res = s21_write_column(fd, &columns[i], rows);
+    uint64_t pad = s21_align(desc[i].size) - desc[i].size;
+    if (res == COLUMNAR_OK && pad) res = s21_write_all(fd, zeros, pad);
+  }
+
+  if (fd >= 0 && close(fd)) res = COLUMNAR_ERROR;
+  free(meta);
+  return res;
+}
+
+/**
+ * @brief Open a columnar file through a read-only memory mapping.
+ *
+ * @param path Path to the file.
+ * @param file Output for the opened file, to be closed with
+ * s21_columnar_close().
+ * @return COLUMNAR_OK on success, COLUMNAR_ERROR on I/O error or invalid file.
+ * A file without columns, as s21_columnar_write() never writes, is invalid,
+ * and the rows of every column must fit into the file.
+ */
+int s21_columnar_open(const char *path, columnar_file *file) {
+  if (!COLUMNAR_NATIVE || !path || !file) return COLUMNAR_ERROR;
+  memset(file, 0, sizeof(columnar_file));
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return COLUMNAR_ERROR;
+
+  struct stat info = {0};
+  void *map = MAP_FAILED;
+  size_t size = 0;
+  if (!fstat(fd, &info) && (size_t)info.st_size >= sizeof(columnar_header)) {
+    size = (size_t)info.st_size;
+    map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (map == MAP_FAILED) return COLUMNAR_ERROR;
+
+  const columnar_header *header = map;
+  const columnar_column *desc = (const columnar_column *)(header + 1);
+  int res = COLUMNAR_OK;
+  if (memcmp(header->magic, COLUMNAR_MAGIC, 4) ||
+      header->version != COLUMNAR_VERSION || !header->columns ||
+      sizeof(columnar_header) + header->columns * sizeof(columnar_column) >
+          size) {
+    res = COLUMNAR_ERROR;
+  }
+  for (int i = 0; res == COLUMNAR_OK && i < header->columns; i++) {
+    const columnar_column *col = &desc[i];
+    if (col->type > COL_I32 || col->encoding > COL_DELTA ||
+        col->width != s21_type_width(col->type) ||
+        col->offset % COLUMNAR_ALIGN || col->offset > size ||
+        col->size > size - col->offset ||
+        header->rows > (size - col->offset) / col->width ||
+        col->size != header->rows * col->width ||
+        memchr(col->name, '\0', COLUMNAR_NAME_SIZE) == NULL) {
+      res = COLUMNAR_ERROR;
+    }
+  }
+
+  if (res == COLUMNAR_OK) {
+    file->map = map;
+    file->size = size;
+    file->rows = header->rows;
+    file->columns = header->columns;
+    file->desc = desc;
+  } else {
+    munmap(map, size);
+  }
+  return res;
+}
+
+/**
+ * @brief Find a column by name.
+ *
+ * @return Index of the column or -1 if there is no such column.
+ */
+int s21_columnar_find(const columnar_file *file, const char *name) {
+  int res = -1;
+  for (int i = 0; file && name && res < 0 && i < file->columns; i++) {
+    if (!strcmp(file->desc[i].name, name)) res = i;
+  }
+  return res;
+}
+
+/**
+ * @brief Get a zero-copy pointer to the column values inside the mapping.
+ *
+ * @return Pointer valid until s21_columnar_close(), or NULL for invalid
+ * columns and delta-encoded ones (use s21_columnar_read() for them).
+ */
+const void *s21_columnar_data(const columnar_file *file, int column) {
+  if (!file || !file->map || column < 0 || column >= file->columns) {
+    return NULL;
+  }
+  const columnar_column *col = &file->desc[column];
+  if (col->encoding != COL_RAW) return NULL;
+  return (const char *)file->map + col->offset;
+}
+
+/**
+ * @brief Decode the column values into a buffer.
+ *
+ * @param file The columnar file.
+ * @param column Index of the column.
+ * @param out Buffer for rows values of the column type.
+ * @return COLUMNAR_OK on success, COLUMNAR_ERROR otherwise.
+ */
+int s21_columnar_read(const columnar_file *file, int column, void *out) {
+  if (!file || !file->map || !out || column < 0 || column >= file->columns) {
+    return COLUMNAR_ERROR;
+  }
+
+  const columnar_column *col = &file->desc[column];
+  const char *src = (const char *)file->map + col->offset;
+  memcpy(out, src, col->size);
+  if (col->encoding == COL_DELTA) {
+    uint64_t prev = 0;
+    for (uint64_t i = 0; i < file->rows; i++) {
+      if (col->width == 8) {
+        uint64_t cur = 0;
+        memcpy(&cur, (char *)out + i * 8, 8);
+        prev += cur;
+        memcpy((char *)out + i * 8, &prev, 8);
+      } else {
+        uint32_t cur = 0;
+        memcpy(&cur, (char *)out + i * 4, 4);
+        uint32_t value = (uint32_t)prev + cur;
+        memcpy((char *)out + i * 4, &value, 4);
+        prev = value;
+      }
+    }
+  }
+  return COLUMNAR_OK;
+}
+
+/**
+ * @brief Unmap the columnar file.
+ *
+ * @param file The columnar file.
+ */
+void s21_columnar_close(columnar_file *file) {
+  if (file) {
+    if (file->map) munmap(file->map, file->size);
+    memset(file, 0, sizeof(columnar_file));
+  }
+}
+
+/**
+ * @brief Write the current credit schedule with columns month (delta-encoded),
+ * payment, interest, principal, prepayment and balance.
+ *
+ * @param path Path to the output file.
+ * @param schedule The credit schedule.
+ * @return COLUMNAR_OK on success, COLUMNAR_ERROR otherwise.
+ */
+int s21_columnar_write_schedule(const char *path,
+                                const credit_schedule *schedule) {
+  if (!schedule) return COLUMNAR_ERROR;
+
+  int rows = s21_schedule_term(schedule);
+  schedule_row *table = malloc((size_t)rows * sizeof(schedule_row));
+  char *block = malloc((size_t)rows * (5 * sizeof(double) + sizeof(int32_t)));
+  int res = COLUMNAR_ERROR;
+
+  if (table && block) {
+    double *payment = (double *)block;
+    double *interest = payment + rows;
+    double *principal = interest + rows;
+    double *prepayment = principal + rows;
+    double *balance = prepayment + rows;
+    int32_t *month = (int32_t *)(balance + rows);
+
+    s21_schedule_fill(schedule, 1, table, rows);
+    for (int i = 0; i < rows; i++) {
+      month[i] = i + 1;
+      payment[i] = (double)table[i].payment;
+      interest[i] = (double)table[i].interest;
+      principal[i] = (double)table[i].principal;
+      prepayment[i] = (double)table[i].prepayment;
+      balance[i] = (double)table[i].balance;
+    }
+
+    columnar_spec columns[] = {{"month", COL_I32, COL_DELTA, month},
+                               {"payment", COL_F64, COL_RAW, payment},
+                               {"interest", COL_F64, COL_RAW, interest},
+                               {"principal", COL_F64, COL_RAW, principal},
+                               {"prepayment", COL_F64, COL_RAW, prepayment},
+                               {"balance", COL_F64, COL_RAW, balance}};
+    res = s21_columnar_write(path, columns, 6, rows);
+  }
+
+  free(table);
+  free(block);
+  return res;
+}
+
+/**
+ * @brief Write inputs and results of a batch credit calculation. The columns
+ * are written straight from the batch buffers.
+ *
+ * @param path Path to the output file.
+ * @param batch Calculated batch.
+ * @return COLUMNAR_OK on success, COLUMNAR_ERROR otherwise.
+ */
+int s21_columnar_write_credit_batch(const char *path, credit_batch batch) {
+  columnar_spec columns[] = {
+      {"amount", COL_F64, COL_RAW, batch.amount},
+      {"term", COL_F64, COL_RAW, batch.term},
+      {"rate", COL_F64, COL_RAW, batch.rate},
+      {"type", COL_I32, COL_RAW, batch.type},
+      {"monthly_payment", COL_F64, COL_RAW, batch.monthly_payment},
+      {"overpayment", COL_F64, COL_RAW, batch.overpayment},
+      {"total_payment", COL_F64, COL_RAW, batch.total_payment}};
+  return s21_columnar_write(path, columns, 7, batch.count);
+}
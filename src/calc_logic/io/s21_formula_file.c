@@ -0,0 +1,279 @@
+/**
+ * @file
+ * @brief Contains the precompiled formula format: compiled programs written
+ * once and evaluated in place from a memory mapping
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_formula_file.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FORMULA_MAX_WRITE (1 << 30)
+#define FORMULA_FNV_OFFSET 14695981039346656037ULL
+#define FORMULA_FNV_PRIME 1099511628211ULL
+
+/* The format is little-endian and read in place, so only such hosts work. */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define FORMULA_NATIVE 0
+#else
+#define FORMULA_NATIVE 1
+#endif
+
+_Static_assert(sizeof(formula_header) == FORMULA_ALIGN, "header layout");
+_Static_assert(sizeof(formula_entry) == 16, "entry layout");
+
+static uint64_t s21_formula_align(uint64_t value) {
+  return (value + FORMULA_ALIGN - 1) / FORMULA_ALIGN * FORMULA_ALIGN;
+}
+
+/**
+ * @brief FNV-1a over 8-byte words. Sections are 64-byte aligned, so the
+ * checksummed part of a file is always a whole number of words.
+ */
+static uint64_t s21_formula_checksum(const uint64_t *words, size_t count) {
+  uint64_t res = FORMULA_FNV_OFFSET;
+  for (size_t i = 0; i < count; i++) {
+    res = (res ^ words[i]) * FORMULA_FNV_PRIME;
+  }
+  return res;
+}
+
+static int s21_formula_write_all(int fd, const void *data, size_t size) {
+  const char *p = data;
+  while (size) {
+    size_t part = size < FORMULA_MAX_WRITE ? size : FORMULA_MAX_WRITE;
+    ssize_t done = write(fd, p, part);
+    if (done <= 0) return FORMULA_ERROR;
+    p += done;
+    size -= (size_t)done;
+  }
+  return FORMULA_OK;
+}
+
+/**
+ * @brief Write programs to a precompiled file: a 64-byte header, the names
+ * of the function table, the index, the literal pool and the instruction
+ * stream, every section 64-byte aligned. The file is written next to the
+ * target and renamed over it, so processes that map the old file keep
+ * working.
+ *
+ * @param path Path to the output file.
+ * @param programs Programs from s21_compile_expr().
+ * @param count Number of programs.
+ * @return FORMULA_OK on success, FORMULA_ERROR otherwise.
+ */
+int s21_formula_write(const char *path, const compiled_expr *programs,
+                      uint32_t count) {
+  if (!FORMULA_NATIVE || !path || (!programs && count)) return FORMULA_ERROR;
+
+  uint64_t literals_count = 0;
+  uint64_t code_count = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (!programs[i].code || programs[i].depth <= 0) return FORMULA_ERROR;
+    literals_count += programs[i].literals_count;
+    code_count += programs[i].count;
+  }
+  if (literals_count > UINT32_MAX || code_count > UINT32_MAX) {
+    return FORMULA_ERROR;
+  }
+
+  formula_header header = {0};
+  memcpy(header.magic, FORMULA_MAGIC, 4);
+  header.version = FORMULA_VERSION;
+  header.funcs = EXPR_FUNC_COUNT;
+  header.count = count;
+  header.index_offset = s21_formula_align(
+      sizeof(formula_header) + EXPR_FUNC_COUNT * FORMULA_FUNC_NAME);
+  header.literals_offset = s21_formula_align(
+      header.index_offset + (uint64_t)count * sizeof(formula_entry));
+  header.code_offset = s21_formula_align(header.literals_offset +
+                                         literals_count * sizeof(double));
+  header.size =
+      s21_formula_align(header.code_offset + code_count * sizeof(expr_token));
+
+  char *data = calloc(1, header.size);
+  if (!data) return FORMULA_ERROR;
+  for (int i = 0; i < EXPR_FUNC_COUNT; i++) {
+    strncpy(data + sizeof(formula_header) + i * FORMULA_FUNC_NAME,
+            s21_compiled_func_name(i), FORMULA_FUNC_NAME - 1);
+  }
+  formula_entry *index = (formula_entry *)(data + header.index_offset);
+  double *literals = (double *)(data + header.literals_offset);
+  expr_token *code = (expr_token *)(data + header.code_offset);
+  uint32_t next_literal = 0;
+  uint32_t next_token = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const compiled_expr *program = &programs[i];
+    index[i] = (formula_entry){next_token, program->count, program->depth,
+                               next_literal, program->literals_count};
+    memcpy(literals + next_literal, program->literals,
+           program->literals_count * sizeof(double));
+    memcpy(code + next_token, program->code,
+           program->count * sizeof(expr_token));
+    next_literal += program->literals_count;
+    next_token += program->count;
+  }
+  header.checksum =
+      s21_formula_checksum((const uint64_t *)(data + sizeof(formula_header)),
+                           (header.size - sizeof(formula_header)) / 8);
+  memcpy(data, &header, sizeof(formula_header));
+
+  char tmp[4096] = {0};
+  int res = snprintf(tmp, sizeof(tmp), "%s.tmp", path) < (int)sizeof(tmp)
+                ? FORMULA_OK
+                : FORMULA_ERROR;
+  int fd = res == FORMULA_OK ? open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+                             : -1;
+  if (fd < 0) res = FORMULA_ERROR;
+  if (res == FORMULA_OK) res = s21_formula_write_all(fd, data, header.size);
+  if (fd >= 0 && close(fd)) res = FORMULA_ERROR;
+  if (res == FORMULA_OK && rename(tmp, path)) res = FORMULA_ERROR;
+  if (res != FORMULA_OK && fd >= 0) unlink(tmp);
+  free(data);
+  return res;
+}
+
+/**
+ * @brief Check the header, the checksum and that the function table matches
+ * the one of this build.
+ */
+static int s21_formula_check(const char *map, size_t size) {
+  const formula_header *header = (const formula_header *)map;
+  if (memcmp(header->magic, FORMULA_MAGIC, 4) ||
+      header->version != FORMULA_VERSION || header->size != size ||
+      size % 8 || header->funcs > EXPR_FUNC_COUNT ||
+      header->index_offset < sizeof(formula_header) +
+                                 header->funcs * FORMULA_FUNC_NAME ||
+      header->index_offset % FORMULA_ALIGN ||
+      header->literals_offset % FORMULA_ALIGN ||
+      header->code_offset % FORMULA_ALIGN ||
+      header->index_offset > header->literals_offset ||
+      header->literals_offset > header->code_offset ||
+      header->code_offset > size ||
+      (header->literals_offset - header->index_offset) /
+              sizeof(formula_entry) <
+          header->count) {
+    return FORMULA_ERROR;
+  }
+
+  for (int i = 0; i < header->funcs; i++) {
+    const char *name = map + sizeof(formula_header) + i * FORMULA_FUNC_NAME;
+    if (strncmp(name, s21_compiled_func_name(i), FORMULA_FUNC_NAME)) {
+      return FORMULA_ERROR;
+    }
+  }
+
+  uint64_t checksum =
+      s21_formula_checksum((const uint64_t *)(map + sizeof(formula_header)),
+                           (size - sizeof(formula_header)) / 8);
+  return checksum == header->checksum ? FORMULA_OK : FORMULA_ERROR;
+}
+
+/**
+ * @brief Open a precompiled file through a read-only memory mapping. Nothing
+ * is parsed or copied, the cost is one pass over the file for the checksum.
+ *
+ * @param path Path to the file.
+ * @param file Output for the opened file, to be closed with
+ * s21_formula_close().
+ * @return FORMULA_OK on success, FORMULA_ERROR on I/O error, a corrupted
+ * file or a file written with another version or function table.
+ */
+int s21_formula_open(const char *path, formula_file *file) {
+  if (!FORMULA_NATIVE || !path || !file) return FORMULA_ERROR;
+  memset(file, 0, sizeof(formula_file));
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return FORMULA_ERROR;
+
+  struct stat info = {0};
+  void *map = MAP_FAILED;
+  size_t size = 0;
+  if (!fstat(fd, &info) && (size_t)info.st_size >= sizeof(formula_header)) {
+    size = (size_t)info.st_size;
+    map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (map == MAP_FAILED) return FORMULA_ERROR;
+
+  int res = s21_formula_check(map, size);
+  if (res == FORMULA_OK) {
+    const formula_header *header = map;
+    file->map = map;
+    file->size = size;
+    file->count = header->count;
+    file->funcs = header->funcs;
+    file->index = (const formula_entry *)((char *)map + header->index_offset);
+    file->literals = (const double *)((char *)map + header->literals_offset);
+    file->literals_count = (header->code_offset - header->literals_offset) / 8;
+    file->code = (const expr_token *)((char *)map + header->code_offset);
+    file->code_count = (size - header->code_offset) / sizeof(expr_token);
+  } else {
+    munmap(map, size);
+  }
+  return res;
+}
+
+/**
+ * @brief Get a formula as a program that points into the mapping. Its tokens
+ * are checked first, so a file with a forged checksum can not make the
+ * evaluator read outside the mapping or its stack.
+ *
+ * @param file The precompiled file.
+ * @param id Index of the formula, its position at s21_formula_write().
+ * @param program Output for the program, valid until s21_formula_close()
+ * and not to be freed.
+ * @return FORMULA_OK on success, FORMULA_ERROR otherwise.
+ */
+int s21_formula_get(const formula_file *file, uint32_t id,
+                    compiled_expr *program) {
+  if (!file || !file->map || !program || id >= file->count) {
+    return FORMULA_ERROR;
+  }
+
+  formula_entry entry = file->index[id];
+  if (!entry.count || !entry.depth || entry.code > file->code_count ||
+      entry.count > file->code_count - entry.code ||
+      entry.literals > file->literals_count ||
+      entry.literals_count > file->literals_count - entry.literals) {
+    return FORMULA_ERROR;
+  }
+  const expr_token *code = file->code + entry.code;
+  for (uint32_t i = 0; i < entry.count; i++) {
+    expr_token token = code[i];
+    int binary = token.op >= OP_ADD && token.op <= OP_POW;
+    if (token.op > OP_FUNC || token.slot + binary >= entry.depth ||
+        (token.op == OP_FUNC && token.func >= file->funcs) ||
+        (token.op == OP_CONST && token.literal >= entry.literals_count)) {
+      return FORMULA_ERROR;
+    }
+  }
+
+  program->count = entry.count;
+  program->depth = entry.depth;
+  program->literals_count = (int)entry.literals_count;
+  program->fast_math_ulps = 0;
+  program->code = code;
+  program->literals = file->literals + entry.literals;
+  return FORMULA_OK;
+}
+
+/**
+ * @brief Unmap the precompiled file.
+ *
+ * @param file The precompiled file.
+ */
+void s21_formula_close(formula_file *file) {
+  if (file) {
+    if (file->map) munmap(file->map, file->size);
+    memset(file, 0, sizeof(formula_file));
+  }
+}
@@ -0,0 +1,324 @@
+/**
+ * @file
+ * @brief Contains memory-mapped calculation history with trigram search
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_history.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HISTORY_ALIGN 8
+
+_Static_assert(sizeof(history_header) == 16, "header layout");
+_Static_assert(sizeof(history_record) == 24, "record layout");
+
+static size_t s21_record_size(size_t length) {
+  size_t size = sizeof(history_record) + length + 1;
+  return (size + HISTORY_ALIGN - 1) / HISTORY_ALIGN * HISTORY_ALIGN;
+}
+
+/**
+ * @brief Code of a character in the trigram alphabet. Digits and letters get
+ * their own codes, the rest share the remaining ones, which only makes the
+ * index less selective since every candidate is verified.
+ */
+static uint32_t s21_char_code(unsigned char c) {
+  uint32_t res = 37 + c % 26;
+  if (c >= '0' && c <= '9') {
+    res = 1 + c - '0';
+  } else if (c >= 'a' && c <= 'z') {
+    res = 11 + c - 'a';
+  } else if (c >= 'A' && c <= 'Z') {
+    res = 11 + c - 'A';
+  }
+  return res;
+}
+
+static uint32_t s21_trigram(const char *p) {
+  return (s21_char_code(p[0]) * HISTORY_ALPHABET + s21_char_code(p[1])) *
+             HISTORY_ALPHABET +
+         s21_char_code(p[2]);
+}
+
+/**
+ * @brief Extend the mapping to the current end of the file.
+ */
+static int s21_history_map(calc_history *history) {
+  if (history->map_size == history->file_size) return HISTORY_OK;
+
+  void *map = mmap(NULL, history->file_size, PROT_READ, MAP_SHARED,
+                   history->fd, 0);
+  if (map == MAP_FAILED) return HISTORY_ERROR;
+  if (history->map) munmap((void *)history->map, history->map_size);
+  history->map = map;
+  history->map_size = history->file_size;
+  return HISTORY_OK;
+}
+
+/**
+ * @brief Find the offsets of the records that were not scanned yet. Only the
+ * record headers are read, and a torn record at the end stops the scan. The
+ * size is taken from the file, so records appended by other processes are
+ * found too.
+ */
+static int s21_history_scan(calc_history *history) {
+  struct stat info = {0};
+  if (fstat(history->fd, &info)) return HISTORY_ERROR;
+  history->file_size = (size_t)info.st_size;
+  if (s21_history_map(history) != HISTORY_OK) return HISTORY_ERROR;
+
+  size_t offset = history->scanned;
+  while (offset + sizeof(history_record) <= history->file_size) {
+    history_record record;
+    memcpy(&record, history->map + offset, sizeof(history_record));
+    size_t size = s21_record_size(record.length);
+    if (record.length > HISTORY_MAX_LEN ||
+        offset + size > history->file_size) {
+      break;
+    }
+    if (history->count == history->capacity) {
+      size_t capacity = history->capacity ? history->capacity * 2 : 1024;
+      uint64_t *offsets =
+          realloc(history->offsets, capacity * sizeof(uint64_t));
+      if (!offsets) return HISTORY_ERROR;
+      history->offsets = offsets;
+      history->capacity = capacity;
+    }
+    history->offsets[history->count++] = offset;
+    offset += size;
+  }
+  history->scanned = offset;
+  return HISTORY_OK;
+}
+
+/**
+ * @brief Scan the history and cut off a torn record at its end.
+ */
+static int s21_history_trim(calc_history *history) {
+  int res = s21_history_scan(history);
+  if (res == HISTORY_OK && history->scanned < history->file_size) {
+    if (ftruncate(history->fd, (off_t)history->scanned)) res = HISTORY_ERROR;
+  }
+  return res;
+}
+
+static int s21_add_posting(history_postings *list, uint32_t id) {
+  if (list->count && list->ids[list->count - 1] == id) return HISTORY_OK;
+  if (list->count == list->capacity) {
+    uint32_t capacity = list->capacity ? list->capacity * 2 : 4;
+    uint32_t *ids = realloc(list->ids, capacity * sizeof(uint32_t));
+    if (!ids) return HISTORY_ERROR;
+    list->ids = ids;
+    list->capacity = capacity;
+  }
+  list->ids[list->count++] = id;
+  return HISTORY_OK;
+}
+
+/**
+ * @brief Add the records that are not indexed yet to the trigram index.
+ * Posting lists stay sorted because records are indexed in order.
+ */
+static int s21_history_index(calc_history *history) {
+  if (!history->index) {
+    history->index = calloc(HISTORY_TRIGRAMS, sizeof(history_postings));
+    if (!history->index) return HISTORY_ERROR;
+  }
+
+  int res = HISTORY_OK;
+  for (; history->indexed < history->count && res == HISTORY_OK;
+       history->indexed++) {
+    history_entry entry = {0};
+    s21_history_get(history, history->indexed, &entry);
+    for (size_t i = 0; i + 3 <= entry.length && res == HISTORY_OK; i++) {
+      res = s21_add_posting(&history->index[s21_trigram(entry.expr + i)],
+                            (uint32_t)history->indexed);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Open or create a history file. Only the record headers are read, the
+ * records are reached through the mapping when they are needed. A torn record
+ * left by a crash during an append is cut off, otherwise the records appended
+ * after it could never be reached.
+ *
+ * @param path Path to the history file.
+ * @param history The history, to be closed with s21_history_close().
+ * @return HISTORY_OK on success, HISTORY_ERROR otherwise.
+ */
+int s21_history_open(const char *path, calc_history *history) {
+  if (!path || !history) return HISTORY_ERROR;
+  memset(history, 0, sizeof(calc_history));
+  history->fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (history->fd < 0) return HISTORY_ERROR;
+
+  int res = HISTORY_ERROR;
+  struct stat info = {0};
+  history_header header = {{0}, 0, 0};
+  if (!fstat(history->fd, &info)) {
+    if (!info.st_size) {
+      memcpy(header.magic, HISTORY_MAGIC, 4);
+      header.version = HISTORY_VERSION;
+      if (write(history->fd, &header, sizeof(header)) == sizeof(header)) {
+        res = HISTORY_OK;
+      }
+    } else if (pread(history->fd, &header, sizeof(header), 0) ==
+                   sizeof(header) &&
+               !memcmp(header.magic, HISTORY_MAGIC, 4) &&
+               header.version == HISTORY_VERSION) {
+      res = HISTORY_OK;
+    }
+  }
+
+  if (res == HISTORY_OK) {
+    history->scanned = sizeof(header);
+    res = s21_history_trim(history);
+  }
+  if (res != HISTORY_OK) {
+    s21_history_close(history);
+  }
+  return res;
+}
+
+/**
+ * @brief Append a calculation to the history. The record is written with a
+ * single write, so readers never see a part of it in the middle of the file.
+ *
+ * @param history The history.
+ * @param expr The expression, at most HISTORY_MAX_LEN characters.
+ * @param result The result.
+ * @param timestamp Time of the calculation, seconds since the epoch.
+ * @return HISTORY_OK on success, HISTORY_ERROR otherwise.
+ */
+int s21_history_append(calc_history *history, const char *expr, double result,
+                       int64_t timestamp) {
+  if (!history || history->fd < 0 || !expr) return HISTORY_ERROR;
+  size_t length = strlen(expr);
+  if (length > HISTORY_MAX_LEN) return HISTORY_ERROR;
+
+  char buffer[s21_record_size(HISTORY_MAX_LEN)];
+  size_t size = s21_record_size(length);
+  history_record record = {(uint32_t)length, 0, timestamp, result};
+  memset(buffer, 0, size);
+  memcpy(buffer, &record, sizeof(record));
+  memcpy(buffer + sizeof(record), expr, length);
+
+  int res = HISTORY_ERROR;
+  ssize_t done = write(history->fd, buffer, size);
+  if (done == (ssize_t)size) {
+    res = HISTORY_OK;
+  } else if (done > 0) {
+    s21_history_trim(history);
+  }
+  return res;
+}
+
+/**
+ * @brief Number of records in the history.
+ *
+ * @param history The history.
+ * @return The number of records.
+ */
+size_t s21_history_count(calc_history *history) {
+  size_t res = 0;
+  if (history && history->fd >= 0 && s21_history_scan(history) == HISTORY_OK) {
+    res = history->count;
+  }
+  return res;
+}
+
+/**
+ * @brief Get a record. The expression points into the mapping and stays valid
+ * until the next append or s21_history_close().
+ *
+ * @param history The history.
+ * @param id Number of the record, 0 is the oldest.
+ * @param entry Output for the record.
+ * @return HISTORY_OK on success, HISTORY_ERROR otherwise.
+ */
+int s21_history_get(calc_history *history, size_t id, history_entry *entry) {
+  if (!entry || id >= s21_history_count(history)) return HISTORY_ERROR;
+
+  history_record record;
+  const char *p = history->map + history->offsets[id];
+  memcpy(&record, p, sizeof(history_record));
+  entry->timestamp = record.timestamp;
+  entry->result = record.result;
+  entry->expr = p + sizeof(history_record);
+  entry->length = record.length;
+  return HISTORY_OK;
+}
+
+static int s21_history_match(calc_history *history, size_t id,
+                             const char *query, size_t length, int mode) {
+  history_entry entry = {0};
+  s21_history_get(history, id, &entry);
+  return mode == HISTORY_PREFIX ? !strncmp(entry.expr, query, length)
+                                : strstr(entry.expr, query) != NULL;
+}
+
+/**
+ * @brief Find the records containing or starting with the query, newest
+ * first. Queries of three and more characters are looked up in the trigram
+ * index: only the records of the rarest trigram of the query are checked.
+ *
+ * @param history The history.
+ * @param query Text to search for, an empty query matches every record.
+ * @param mode HISTORY_SUBSTRING or HISTORY_PREFIX.
+ * @param ids Output for the numbers of the found records.
+ * @param max Size of ids.
+ * @return Number of found records written to ids.
+ */
+size_t s21_history_search(calc_history *history, const char *query, int mode,
+                          size_t *ids, size_t max) {
+  size_t count = s21_history_count(history);
+  if (!query || !ids || !count) return 0;
+
+  size_t length = strlen(query);
+  const history_postings *rarest = NULL;
+  if (length >= 3) {
+    if (s21_history_index(history) != HISTORY_OK) return 0;
+    for (size_t i = 0; i + 3 <= length; i++) {
+      const history_postings *list = &history->index[s21_trigram(query + i)];
+      if (!rarest || list->count < rarest->count) rarest = list;
+    }
+  }
+
+  size_t res = 0;
+  size_t candidates = rarest ? rarest->count : count;
+  for (size_t i = candidates; i > 0 && res < max; i--) {
+    size_t id = rarest ? rarest->ids[i - 1] : i - 1;
+    if (s21_history_match(history, id, query, length, mode)) ids[res++] = id;
+  }
+  return res;
+}
+
+/**
+ * @brief Close a history and free its index.
+ *
+ * @param history The history.
+ */
+void s21_history_close(calc_history *history) {
+  if (history) {
+    if (history->map) munmap((void *)history->map, history->map_size);
+    if (history->fd >= 0) close(history->fd);
+    if (history->index) {
+      for (size_t i = 0; i < HISTORY_TRIGRAMS; i++) {
+        free(history->index[i].ids);
+      }
+    }
+    free(history->index);
+    free(history->offsets);
+    memset(history, 0, sizeof(calc_history));
+    history->fd = -1;
+  }
+}
@@ -0,0 +1,350 @@
+/**
+ * @file
+ * @brief Contains memory-mapped loader of loan book CSV files
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_loan_book.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define LOAN_BOOK_FIELDS 4
+#define LOAN_BOOK_MIN_CHUNK (1 << 20)
+#define LOAN_BOOK_MAX_DIGITS 19
+
+typedef struct csv_chunk {
+  const char *begin;
+  const char *end;
+  size_t lines;
+  size_t first_row;
+  size_t rows;
+  size_t bad_rows;
+  loan_book *book;
+} csv_chunk;
+
+static const double s21_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                   1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                   1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * @brief Count occurrences of a byte, 16 bytes per step with SSE2.
+ */
+static size_t s21_count_byte(const char *p, const char *end, char c) {
+  size_t res = 0;
+#ifdef __SSE2__
+  __m128i needle = _mm_set1_epi8(c);
+  for (; end - p >= 16; p += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)p);
+    res += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+  }
+#endif
+  for (; p < end; p++) res += *p == c;
+  return res;
+}
+
+/**
+ * @brief Find the first occurrence of a byte, 16 bytes per step with SSE2.
+ *
+ * @return Pointer to the byte or end if it is not found.
+ */
+static const char *s21_find_byte(const char *p, const char *end, char c) {
+#ifdef __SSE2__
+  __m128i needle = _mm_set1_epi8(c);
+  for (; end - p >= 16; p += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)p);
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    if (mask) return p + __builtin_ctz(mask);
+  }
+#endif
+  for (; p < end && *p != c; p++) {
+  }
+  return p;
+}
+
+static int s21_is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '"';
+}
+
+/**
+ * @brief Parse a decimal field in place, without copying or terminating it.
+ *
+ * @param p Start of the field.
+ * @param end End of the line.
+ * @param value Output for the parsed value.
+ * @return Pointer past the field separator, or NULL if the field is invalid.
+ */
+static const char *s21_parse_field(const char *p, const char *end,
+                                   double *value) {
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  int digits = 0;
+  int negative = 0;
+
+  while (p < end && s21_is_blank(*p)) p++;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+    if (digits < LOAN_BOOK_MAX_DIGITS) {
+      mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+    } else {
+      exponent++;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+      if (digits < LOAN_BOOK_MAX_DIGITS) {
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        exponent--;
+      }
+    }
+  }
+  if (digits && p < end && (*p == 'e' || *p == 'E')) {
+    const char *save = p++;
+    int sign = 1;
+    int power = 0;
+    if (p < end && (*p == '-' || *p == '+')) sign = *p++ == '-' ? -1 : 1;
+    if (p < end && *p >= '0' && *p <= '9') {
+      for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (power < 10000) power = power * 10 + (*p - '0');
+      }
+      exponent += sign * power;
+    } else {
+      p = save;
+    }
+  }
+  while (p < end && s21_is_blank(*p)) p++;
+  if (!digits || (p < end && *p != ',')) return NULL;
+
+  double res = (double)mantissa;
+  if (exponent < 0 && exponent >= -22) {
+    res /= s21_pow10[-exponent];
+  } else if (exponent > 0 && exponent <= 22) {
+    res *= s21_pow10[exponent];
+  } else if (exponent) {
+    res *= pow(10, exponent);
+  }
+  *value = negative ? -res : res;
+  return p < end ? p + 1 : p;
+}
+
+/**
+ * @brief Parse one line into the given row of the book.
+ *
+ * @return 1 if the row is valid, 0 otherwise.
+ */
+static int s21_parse_row(const char *p, const char *end, loan_book *book,
+                         size_t row) {
+  double fields[LOAN_BOOK_FIELDS] = {0};
+  for (int i = 0; i < LOAN_BOOK_FIELDS && p; i++) {
+    if (i && p == end) p = NULL;
+    if (p) p = s21_parse_field(p, end, &fields[i]);
+  }
+  if (p && p != end) p = NULL;
+
+  if (p) {
+    book->amount[row] = fields[0];
+    book->term[row] = fields[1];
+    book->rate[row] = fields[2];
+    book->type[row] = (int)fields[3];
+  }
+  return p != NULL;
+}
+
+/**
+ * @brief First pass: count the lines of a chunk.
+ */
+static void *s21_count_chunk(void *arg) {
+  csv_chunk *chunk = arg;
+  chunk->lines = s21_count_byte(chunk->begin, chunk->end, '\n');
+  if (chunk->begin < chunk->end && chunk->end[-1] != '\n') chunk->lines++;
+  return NULL;
+}
+
+/**
+ * @brief Second pass: parse the lines of a chunk into its own row range.
+ */
+static void *s21_parse_chunk(void *arg) {
+  csv_chunk *chunk = arg;
+  const char *p = chunk->begin;
+
+  while (p < chunk->end) {
+    const char *line_end = s21_find_byte(p, chunk->end, '\n');
+    const char *content = p;
+    while (content < line_end && s21_is_blank(*content)) content++;
+    if (content < line_end) {
+      if (s21_parse_row(p, line_end, chunk->book,
+                        chunk->first_row + chunk->rows)) {
+        chunk->rows++;
+      } else {
+        chunk->bad_rows++;
+      }
+    }
+    p = line_end < chunk->end ? line_end + 1 : line_end;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Run a pass over all chunks, one thread per chunk.
+ */
+static void s21_run_chunks(csv_chunk *chunks, int count,
+                           void *(*pass)(void *)) {
+  pthread_t ids[count];
+  int created[count];
+
+  for (int i = 1; i < count; i++) {
+    created[i] = !pthread_create(&ids[i], NULL, pass, &chunks[i]);
+  }
+  pass(&chunks[0]);
+  for (int i = 1; i < count; i++) {
+    if (created[i]) {
+      pthread_join(ids[i], NULL);
+    } else {
+      pass(&chunks[i]);
+    }
+  }
+}
+
+/**
+ * @brief Allocate all columns of the book in one block.
+ */
+static int s21_alloc_loan_book(loan_book *book, size_t rows) {
+  size_t size = rows ? rows : 1;
+  char *block = malloc(size * (3 * sizeof(double) + sizeof(int)));
+  if (!block) return LOAN_BOOK_ERROR;
+
+  book->amount = (double *)block;
+  book->term = book->amount + size;
+  book->rate = book->term + size;
+  book->type = (int *)(book->rate + size);
+  return LOAN_BOOK_OK;
+}
+
+/**
+ * @brief Parse a loan book from memory. Rows are "amount,term,rate,type", an
+ * optional non-numeric header line is skipped and invalid rows are counted in
+ * bad_rows. The data is split at line boundaries and parsed in parallel.
+ *
+ * @param data CSV data, not necessarily null-terminated.
+ * @param size Size of the data in bytes.
+ * @param threads Number of threads, <= 0 uses all cores.
+ * @param book Output for the columns, to be freed with s21_clear_loan_book().
+ * @return LOAN_BOOK_OK on success, LOAN_BOOK_ERROR otherwise.
+ */
+int s21_parse_loan_book(const char *data, size_t size, int threads,
+                        loan_book *book) {
+  if (!book || (!data && size)) return LOAN_BOOK_ERROR;
+  memset(book, 0, sizeof(loan_book));
+
+  const char *begin = data;
+  const char *end = data + size;
+  while (begin < end && s21_is_blank(*begin)) begin++;
+  if (begin < end && !strchr("0123456789.-+", *begin)) {
+    begin = s21_find_byte(begin, end, '\n');
+    if (begin < end) begin++;
+  }
+
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if ((size_t)threads > size / LOAN_BOOK_MIN_CHUNK + 1) {
+    threads = (int)(size / LOAN_BOOK_MIN_CHUNK + 1);
+  }
+  if (threads <= 0) threads = 1;
+
+  csv_chunk chunks[threads];
+  const char *cur = begin;
+  for (int i = 0; i < threads; i++) {
+    const char *split = begin + (size_t)(end - begin) * (i + 1) / threads;
+    if (split < cur) split = cur;
+    if (i + 1 < threads) {
+      split = s21_find_byte(split, end, '\n');
+      if (split < end) split++;
+    }
+    chunks[i] = (csv_chunk){cur, i + 1 < threads ? split : end, 0, 0, 0, 0,
+                            book};
+    cur = chunks[i].end;
+  }
+
+  s21_run_chunks(chunks, threads, s21_count_chunk);
+  size_t lines = 0;
+  for (int i = 0; i < threads; i++) {
+    chunks[i].first_row = lines;
+    lines += chunks[i].lines;
+  }
+  if (s21_alloc_loan_book(book, lines) != LOAN_BOOK_OK) return LOAN_BOOK_ERROR;
+  s21_run_chunks(chunks, threads, s21_parse_chunk);
+
+  for (int i = 0; i < threads; i++) {
+    size_t from = chunks[i].first_row;
+    size_t rows = chunks[i].rows;
+    if (from != book->count) {
+      memmove(book->amount + book->count, book->amount + from,
+              rows * sizeof(double));
+      memmove(book->term + book->count, book->term + from,
+              rows * sizeof(double));
+      memmove(book->rate + book->count, book->rate + from,
+              rows * sizeof(double));
+      memmove(book->type + book->count, book->type + from, rows * sizeof(int));
+    }
+    book->count += rows;
+    book->bad_rows += chunks[i].bad_rows;
+  }
+  return LOAN_BOOK_OK;
+}
+
+/**
+ * @brief Load a loan book CSV file through a read-only memory mapping.
+ *
+ * @param path Path to the CSV file.
+ * @param threads Number of threads, <= 0 uses all cores.
+ * @param book Output for the columns, to be freed with s21_clear_loan_book().
+ * @return LOAN_BOOK_OK on success, LOAN_BOOK_ERROR otherwise.
+ */
+int s21_load_loan_book(const char *path, int threads, loan_book *book) {
+  if (!path || !book) return LOAN_BOOK_ERROR;
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return LOAN_BOOK_ERROR;
+
+  int res = LOAN_BOOK_ERROR;
+  struct stat info = {0};
+  if (!fstat(fd, &info)) {
+    size_t size = (size_t)info.st_size;
+    if (!size) {
+      res = s21_parse_loan_book(NULL, 0, threads, book);
+    } else {
+      void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+        res = s21_parse_loan_book(map, size, threads, book);
+        munmap(map, size);
+      }
+    }
+  }
+  close(fd);
+  return res;
+}
+
+/**
+ * @brief Free the columns of a loan book.
+ *
+ * @param book The loan book.
+ */
+void s21_clear_loan_book(loan_book *book) {
+  if (book) {
+    free(book->amount);
+    memset(book, 0, sizeof(loan_book));
+  }
+}
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief Contains the binary protocol of the evaluation daemon
+ */
+
+#include "include/s21_protocol.h"
+
+#include <string.h>
+
+#include "../bank_calc/include/s21_credit_calc.h"
+#include "../bank_calc/include/s21_deposit_calc.h"
+#include "../s21_calc.h"
+
+_Static_assert(sizeof(proto_header) == 12, "header layout");
+_Static_assert(sizeof(proto_credit) == 32, "credit layout");
+_Static_assert(sizeof(proto_deposit) == 64, "deposit layout");
+
+/**
+ * @brief Write a frame into the buffer.
+ *
+ * @return Size of the frame or 0 if it does not fit.
+ */
+static size_t s21_proto_frame(char *buffer, size_t capacity,
+                              proto_header header, const void *body) {
+  size_t size = sizeof(proto_header) + header.length;
+  if (!buffer || capacity < size || header.length > PROTO_MAX_BODY) return 0;
+  memcpy(buffer, &header, sizeof(proto_header));
+  memcpy(buffer + sizeof(proto_header), body, header.length);
+  return size;
+}
+
+/**
+ * @brief Encode an expression request.
+ *
+ * @param buffer Output for the frame.
+ * @param capacity Size of buffer.
+ * @param id Request id, returned with the response.
+ * @param expr The expression, at most PROTO_MAX_EXPR characters.
+ * @return Size of the frame or 0 if it does not fit.
+ */
+size_t s21_proto_expr(char *buffer, size_t capacity, uint32_t id,
+                      const char *expr) {
+  if (!expr || strlen(expr) > PROTO_MAX_EXPR) return 0;
+  proto_header header = {(uint32_t)strlen(expr), id, PROTO_EXPR, 0};
+  return s21_proto_frame(buffer, capacity, header, expr);
+}
+
+/**
+ * @brief Encode a credit request.
+ *
+ * @param buffer Output for the frame.
+ * @param capacity Size of buffer.
+ * @param id Request id, returned with the response.
+ * @param credit Arguments of s21_credit_calc().
+ * @return Size of the frame or 0 if it does not fit.
+ */
+size_t s21_proto_credit(char *buffer, size_t capacity, uint32_t id,
+                        proto_credit credit) {
+  proto_header header = {sizeof(credit), id, PROTO_CREDIT, 0};
+  return s21_proto_frame(buffer, capacity, header, &credit);
+}
+
+/**
+ * @brief Encode a deposit request.
+ *
+ * @param buffer Output for the frame.
+ * @param capacity Size of buffer.
+ * @param id Request id, returned with the response.
+ * @param deposit Arguments of s21_deposit_calc().
+ * @return Size of the frame or 0 if it does not fit.
+ */
+size_t s21_proto_deposit(char *buffer, size_t capacity, uint32_t id,
+                         proto_deposit deposit) {
+  proto_header header = {sizeof(deposit), id, PROTO_DEPOSIT, 0};
+  return s21_proto_frame(buffer, capacity, header, &deposit);
+}
+
+/**
+ * @brief Decode the first frame of the received data.
+ *
+ * @param data Received data.
+ * @param size Size of data.
+ * @param frame Output for the frame, frame->size is the number of bytes to
+ * skip to the next one.
+ * @return PROTO_OK, PROTO_INCOMPLETE if more data is needed or PROTO_ERROR if
+ * the frame is too long, in which case the stream can not be resynchronized.
+ */
+int s21_proto_next(const char *data, size_t size, proto_frame *frame) {
+  if (!data || !frame) return PROTO_ERROR;
+  if (size < sizeof(proto_header)) return PROTO_INCOMPLETE;
+
+  memcpy(&frame->header, data, sizeof(proto_header));
+  if (frame->header.length > PROTO_MAX_BODY) return PROTO_ERROR;
+  frame->size = sizeof(proto_header) + frame->header.length;
+  frame->body = data + sizeof(proto_header);
+  return size < frame->size ? PROTO_INCOMPLETE : PROTO_OK;
+}
+
+/**
+ * @brief Evaluate a request and encode its response. Results are the same
+ * values the library functions return. An expression that does not validate
+ * gets PROTO_STATUS_INVALID_EXPR and its error code as the only value, a
+ * request that can not be decoded gets PROTO_STATUS_BAD_REQUEST and no
+ * values.
+ *
+ * @param request The request.
+ * @param response Output for the response, at least PROTO_MAX_FRAME bytes.
+ * @return Size of the response.
+ */
+size_t s21_proto_execute(const proto_frame *request, char *response) {
+  proto_header header = {0, request->header.id, request->header.type,
+                         PROTO_STATUS_OK};
+  double values[PROTO_MAX_VALUES] = {0};
+  uint32_t length = request->header.length;
+
+  if (request->header.type == PROTO_EXPR && length <= PROTO_MAX_EXPR) {
+    char expr[PROTO_MAX_EXPR + 1] = {0};
+    memcpy(expr, request->body, length);
+    long double res = 0;
+    int status = s21_calc_eval(expr, &res);
+    if (status != VALID_OK) header.status = PROTO_STATUS_INVALID_EXPR;
+    values[0] = status == VALID_OK ? (double)res : status;
+    header.length = sizeof(double);
+  } else if (request->header.type == PROTO_CREDIT &&
+             length == sizeof(proto_credit)) {
+    proto_credit args;
+    memcpy(&args, request->body, sizeof(args));
+    credit_data res =
+        s21_credit_calc(args.amount, args.term, args.rate, args.type);
+    values[0] = (double)res.monthly_payment;
+    values[1] = (double)res.overpayment;
+    values[2] = (double)res.total_payment;
+    header.length = 3 * sizeof(double);
+  } else if (request->header.type == PROTO_DEPOSIT &&
+             length == sizeof(proto_deposit)) {
+    proto_deposit args;
+    memcpy(&args, request->body, sizeof(args));
+    deposit_data res = s21_deposit_calc(
+        args.amount, args.term, args.rate, args.tax, args.pay_frequency,
+        args.replen, args.withdrawals, args.capital_percent);
+    values[0] = (double)res.acc_interest;
+    values[1] = (double)res.tax_total;
+    values[2] = (double)res.dep_total;
+    header.length = 3 * sizeof(double);
+  } else {
+    header.status = PROTO_STATUS_BAD_REQUEST;
+  }
+  return s21_proto_frame(response, PROTO_MAX_FRAME, header, values);
+}
+
+/**
+ * @brief Decode the results of a response.
+ *
+ * @param response The response.
+ * @param values Output for at least PROTO_MAX_VALUES results.
+ * @return Number of results.
+ */
+size_t s21_proto_values(const proto_frame *response, double *values) {
+  size_t count = response->header.length / sizeof(double);
+  if (count > PROTO_MAX_VALUES) count = PROTO_MAX_VALUES;
+  memcpy(values, response->body, count * sizeof(double));
+  return count;
+}
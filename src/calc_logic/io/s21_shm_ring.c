@@ -0,0 +1,303 @@
+/**
+ * @file
+ * @brief Contains the shared-memory transport: lock-free rings with futex
+ * wakeups between a client and an evaluation server
+ */
+
+#define _GNU_SOURCE
+
+#include "include/s21_shm_ring.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../compiler/include/s21_compiler.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+_Static_assert(sizeof(shm_message) == 32, "message layout");
+
+static void s21_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+/**
+ * @brief Sleep while *word equals value. Without futexes the caller just
+ * keeps polling.
+ */
+static void s21_futex_wait(_Atomic uint32_t *word, uint32_t value,
+                           const struct timespec *timeout) {
+#ifdef __linux__
+  syscall(SYS_futex, word, FUTEX_WAIT, value, timeout, NULL, 0);
+#else
+  (void)word;
+  (void)value;
+  (void)timeout;
+  usleep(50);
+#endif
+}
+
+static void s21_futex_wake(_Atomic uint32_t *word) {
+#ifdef __linux__
+  syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+#else
+  (void)word;
+#endif
+}
+
+static int s21_shm_map(int fd, shm_channel *channel) {
+  void *map = MAP_FAILED;
+  if (fd >= 0) {
+    map = mmap(NULL, sizeof(shm_region), PROT_READ | PROT_WRITE, MAP_SHARED,
+               fd, 0);
+    close(fd);
+  }
+  memset(channel, 0, sizeof(shm_channel));
+  if (map != MAP_FAILED) channel->region = map;
+  channel->spins = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_SPINS : 0;
+  return map != MAP_FAILED ? SHM_OK : SHM_ERROR;
+}
+
+/**
+ * @brief Create the shared file of a channel, normally under /dev/shm so it
+ * never reaches the disk. Called by the server.
+ *
+ * @param path Path to the file.
+ * @param channel Output for the channel, to be freed with s21_shm_detach().
+ * @return SHM_OK on success, SHM_ERROR otherwise.
+ */
+int s21_shm_create(const char *path, shm_channel *channel) {
+  if (!path || !channel) return SHM_ERROR;
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd >= 0 && ftruncate(fd, sizeof(shm_region))) {
+    close(fd);
+    fd = -1;
+  }
+  int res = s21_shm_map(fd, channel);
+  if (res == SHM_OK) {
+    memcpy(channel->region->magic, SHM_MAGIC, 4);
+    channel->region->version = SHM_VERSION;
+  }
+  return res;
+}
+
+/**
+ * @brief Attach to a channel the server has created. Only one client may use
+ * a channel at a time.
+ *
+ * @param path Path to the file.
+ * @param channel Output for the channel, to be freed with s21_shm_detach().
+ * @return SHM_OK on success, SHM_ERROR otherwise.
+ */
+int s21_shm_attach(const char *path, shm_channel *channel) {
+  if (!path || !channel) return SHM_ERROR;
+  int res = s21_shm_map(open(path, O_RDWR), channel);
+  if (res == SHM_OK && (memcmp(channel->region->magic, SHM_MAGIC, 4) ||
+                        channel->region->version != SHM_VERSION)) {
+    s21_shm_detach(channel);
+    res = SHM_ERROR;
+  }
+  return res;
+}
+
+/**
+ * @brief Unmap a channel.
+ *
+ * @param channel The channel.
+ */
+void s21_shm_detach(shm_channel *channel) {
+  if (channel && channel->region) {
+    munmap(channel->region, sizeof(shm_region));
+    memset(channel, 0, sizeof(shm_channel));
+  }
+}
+
+/**
+ * @brief Publish a message and wake the consumer if it sleeps.
+ *
+ * @param ring The ring, written by this thread only.
+ * @param message The message.
+ * @return SHM_OK or SHM_FULL.
+ */
+int s21_ring_push(shm_ring *ring, const shm_message *message) {
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  if (head - tail == SHM_RING_SIZE) return SHM_FULL;
+
+  ring->slots[head % SHM_RING_SIZE] = *message;
+  atomic_store(&ring->head, head + 1);
+  if (atomic_load(&ring->sleeping) && atomic_exchange(&ring->sleeping, 0)) {
+    s21_futex_wake(&ring->sleeping);
+  }
+  return SHM_OK;
+}
+
+/**
+ * @brief Take the oldest message.
+ *
+ * @param ring The ring, read by this thread only.
+ * @param message Output for the message.
+ * @return SHM_OK or SHM_EMPTY.
+ */
+int s21_ring_pop(shm_ring *ring, shm_message *message) {
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  if (head == tail) return SHM_EMPTY;
+
+  *message = ring->slots[tail % SHM_RING_SIZE];
+  atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+  return SHM_OK;
+}
+
+static int s21_ring_ready(shm_ring *ring) {
+  return atomic_load(&ring->head) !=
+         atomic_load_explicit(&ring->tail, memory_order_relaxed);
+}
+
+/**
+ * @brief Wait until the ring has a message. The consumer spins first, so a
+ * busy peer is served without syscalls, then sleeps on the futex. On a
+ * single CPU spinning only delays the peer, so spins should be 0 there.
+ *
+ * @param ring The ring, read by this thread only.
+ * @param spins Number of polls before sleeping.
+ * @param timeout Longest time to sleep, NULL to wait for a message.
+ * @return SHM_OK if there is a message, SHM_EMPTY after a timeout or signal.
+ */
+int s21_ring_wait(shm_ring *ring, int spins, const struct timespec *timeout) {
+  for (int i = 0; i < spins; i++) {
+    if (s21_ring_ready(ring)) return SHM_OK;
+    s21_cpu_relax();
+  }
+
+  atomic_store(&ring->sleeping, 1);
+  if (!s21_ring_ready(ring)) s21_futex_wait(&ring->sleeping, 1, timeout);
+  atomic_store(&ring->sleeping, 0);
+  return s21_ring_ready(ring) ? SHM_OK : SHM_EMPTY;
+}
+
+/**
+ * @brief Send a request and wait for its response.
+ */
+static int s21_shm_call(shm_channel *channel, shm_message *message) {
+  message->id = channel->next_id++;
+  int res = s21_ring_push(&channel->region->requests, message);
+  while (res == SHM_OK &&
+         s21_ring_pop(&channel->region->responses, message) != SHM_OK) {
+    s21_ring_wait(&channel->region->responses, channel->spins, NULL);
+  }
+  return res;
+}
+
+/**
+ * @brief Compile an expression of x on the server.
+ *
+ * @param channel The channel.
+ * @param expr The expression, shorter than SHM_EXPR_SIZE.
+ * @param id Output for the id to evaluate it with.
+ * @return VALID_OK or a validation error code.
+ */
+int s21_shm_register(shm_channel *channel, const char *expr, uint32_t *id) {
+  if (!channel || !channel->region || !expr || !id) return NULL_PTR;
+  if (strlen(expr) >= SHM_EXPR_SIZE) return STR_OVERFLOW;
+  if (channel->exprs == SHM_MAX_EXPRS) return STR_OVERFLOW;
+
+  strcpy(channel->region->exprs[channel->exprs], expr);
+  shm_message message = {0, SHM_COMPILE, channel->exprs, 0, 0, 0};
+  int res = s21_shm_call(channel, &message) == SHM_OK ? message.status
+                                                      : NULL_PTR;
+  if (res == VALID_OK) *id = channel->exprs++;
+  return res;
+}
+
+/**
+ * @brief Evaluate a registered expression on the server. Neither side makes
+ * a syscall as long as the other one is spinning.
+ *
+ * @param channel The channel.
+ * @param expr Id from s21_shm_register().
+ * @param x Value of the variable.
+ * @param result Output for the result, NAN where it is not defined.
+ * @return VALID_OK or a validation error code.
+ */
+int s21_shm_eval(shm_channel *channel, uint32_t expr, double x,
+                 double *result) {
+  if (!channel || !channel->region || !result) return NULL_PTR;
+  shm_message message = {0, SHM_EVAL, expr, 0, x, 0};
+  int res = s21_shm_call(channel, &message) == SHM_OK ? message.status
+                                                      : NULL_PTR;
+  if (res == VALID_OK) *result = message.result;
+  return res;
+}
+
+/**
+ * @brief Ask the server to return from s21_shm_serve().
+ *
+ * @param channel The channel.
+ * @return SHM_OK on success, SHM_ERROR otherwise.
+ */
+int s21_shm_stop(shm_channel *channel) {
+  if (!channel || !channel->region) return SHM_ERROR;
+  shm_message message = {0, SHM_STOP, 0, 0, 0, 0};
+  return s21_shm_call(channel, &message) == SHM_OK ? SHM_OK : SHM_ERROR;
+}
+
+static void s21_shm_handle(shm_channel *channel, compiled_expr *exprs,
+                           shm_message *message) {
+  message->status = VALID_OK;
+  if (message->type != SHM_STOP && message->expr >= SHM_MAX_EXPRS) {
+    message->status = NULL_PTR;
+  } else if (message->type == SHM_COMPILE) {
+    char expr[SHM_EXPR_SIZE] = {0};
+    memcpy(expr, channel->region->exprs[message->expr], SHM_EXPR_SIZE - 1);
+    s21_clear_compiled(&exprs[message->expr]);
+    message->status = s21_compile_expr(expr, &exprs[message->expr]);
+  } else if (message->type == SHM_EVAL) {
+    if (exprs[message->expr].code) {
+      message->result = s21_eval_compiled(&exprs[message->expr], message->x);
+    } else {
+      message->status = NULL_PTR;
+    }
+  }
+}
+
+/**
+ * @brief Serve requests of the channel until the client sends SHM_STOP or
+ * *stop becomes non-zero. The flag is checked at least every 100 ms.
+ *
+ * @param channel The channel.
+ * @param stop Flag set e.g. by a signal handler, may be NULL.
+ * @return SHM_OK on success, SHM_ERROR otherwise.
+ */
+int s21_shm_serve(shm_channel *channel, const volatile int *stop) {
+  if (!channel || !channel->region) return SHM_ERROR;
+  compiled_expr *exprs = calloc(SHM_MAX_EXPRS, sizeof(compiled_expr));
+  if (!exprs) return SHM_ERROR;
+
+  struct timespec timeout = {0, 100000000};
+  int running = 1;
+  while (running && !(stop && *stop)) {
+    shm_message message;
+    if (s21_ring_pop(&channel->region->requests, &message) != SHM_OK) {
+      s21_ring_wait(&channel->region->requests, channel->spins, &timeout);
+      continue;
+    }
+    s21_shm_handle(channel, exprs, &message);
+    running = message.type != SHM_STOP;
+    while (s21_ring_push(&channel->region->responses, &message) == SHM_FULL) {
+      s21_cpu_relax();
+    }
+  }
+
+  for (int i = 0; i < SHM_MAX_EXPRS; i++) s21_clear_compiled(&exprs[i]);
+  free(exprs);
+  return SHM_OK;
+}
@@ -0,0 +1,89 @@
+#ifndef S21_LIVE_CALC_H
+#define S21_LIVE_CALC_H
+
+#include <stddef.h>
+
+#include "../../translator/include/translator.h"
+
+#define LIVE_MAX_LEN 255
+#define LIVE_LOG_SIZE (8 * (LIVE_MAX_LEN + 1))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum live_token { LIVE_NONE, LIVE_NUMBER, LIVE_FUNC, LIVE_CALL };
+enum live_log_kind {
+  LOG_PUSH_VALUE,
+  LOG_POP_VALUE,
+  LOG_PUSH_OPER,
+  LOG_POP_OPER
+};
+
+typedef struct live_oper {
+  char value;
+  int priority;
+  double (*math_func)(double);
+} live_oper;
+
+/**
+ * @brief Change of the stacks, undone on backspace.
+ */
+typedef struct live_log_entry {
+  int kind;
+  long double value;
+  live_oper oper;
+} live_log_entry;
+
+/**
+ * @brief Parser state before a character was appended.
+ */
+typedef struct live_checkpoint {
+  size_t log_size;
+  int expect_operand;
+  int token;
+  int token_start;
+  int call_depth;
+  int brackets;
+  int error;
+} live_checkpoint;
+
+/**
+ * @brief Expression parsed one character at a time. Operators are reduced as
+ * soon as their priority allows, so the stacks hold only the open part of the
+ * expression and appending a character costs O(1) amortized.
+ *
+ * A call of an aggregate or a solver, e.g. sum(i, 1, 10, i), is a LIVE_CALL
+ * token: its text is only stored until the bracket after its name closes,
+ * and then it is evaluated whole and pushed as a number.
+ */
+typedef struct live_calc {
+  char expr[LIVE_MAX_LEN + 1];
+  int length;
+  long double values[LIVE_MAX_LEN + 1];
+  int values_count;
+  live_oper opers[LIVE_MAX_LEN + 1];
+  int opers_count;
+  live_log_entry log[LIVE_LOG_SIZE];
+  size_t log_size;
+  live_checkpoint checkpoints[LIVE_MAX_LEN + 1];
+  int expect_operand;
+  int token;
+  int token_start;
+  int call_depth;
+  int brackets;
+  int error;
+} live_calc;
+
+live_calc *s21_create_live_calc(void);
+int s21_live_append(live_calc *calc, const char *text);
+int s21_live_backspace(live_calc *calc);
+int s21_live_result(const live_calc *calc, long double *result);
+void s21_live_reset(live_calc *calc);
+void s21_clear_live_calc(live_calc *calc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_LIVE_CALC_H
@@ -0,0 +1,347 @@
+/**
+ * @file
+ * @brief Contains incremental evaluation of an expression while it is typed
+ */
+
+#include "include/s21_live_calc.h"
+
+#include "../compiler/include/s21_aggregate.h"
+#include "../compiler/include/s21_roots.h"
+#include "../s21_calc.h"
+
+#define LIVE_NEG_PRIORITY 4
+
+/*
+ * Every character pushes at most one value and one operator. A single ')' may
+ * reduce many operators, but every operator is popped at most once, with up
+ * to three value changes. Over the whole expression the log thus holds at
+ * most 6 entries per character, and LIVE_LOG_SIZE can not overflow.
+ */
+
+static void s21_live_push_value(live_calc *calc, long double value) {
+  calc->values[calc->values_count++] = value;
+  calc->log[calc->log_size++] = (live_log_entry){LOG_PUSH_VALUE, value, {0}};
+}
+
+static long double s21_live_pop_value(live_calc *calc) {
+  long double value = calc->values[--calc->values_count];
+  calc->log[calc->log_size++] = (live_log_entry){LOG_POP_VALUE, value, {0}};
+  return value;
+}
+
+static void s21_live_push_oper(live_calc *calc, live_oper oper) {
+  calc->opers[calc->opers_count++] = oper;
+  calc->log[calc->log_size++] = (live_log_entry){LOG_PUSH_OPER, 0, oper};
+}
+
+static live_oper s21_live_pop_oper(live_calc *calc) {
+  live_oper oper = calc->opers[--calc->opers_count];
+  calc->log[calc->log_size++] = (live_log_entry){LOG_POP_OPER, 0, oper};
+  return oper;
+}
+
+static int s21_is_unary(live_oper oper) {
+  return oper.value == 'f' || oper.value == '~';
+}
+
+/**
+ * @brief Apply an operator the way s21_calc_eval() does: a binary operator
+ * with a NAN operand gives NAN, even where pow() would not.
+ *
+ * @param oper The operator.
+ * @param b Left operand, ignored by unary operators.
+ * @param a Right operand.
+ * @return The result.
+ */
+static long double s21_live_apply(live_oper oper, long double b,
+                                  long double a) {
+  long double res = NAN;
+  if (oper.value == '~') {
+    res = -a;
+  } else if (oper.value == 'f') {
+    res = oper.math_func(a);
+  } else if (isnan(a) || isnan(b)) {
+    res = NAN;
+  } else if (oper.value == '+') {
+    res = b + a;
+  } else if (oper.value == '-') {
+    res = b - a;
+  } else if (oper.value == '*') {
+    res = b * a;
+  } else if (oper.value == '/') {
+    res = a ? b / a : NAN;
+  } else if (oper.value == '^') {
+    res = pow(b, a);
+  }
+  return res;
+}
+
+static void s21_live_reduce(live_calc *calc, int priority) {
+  while (calc->opers_count &&
+         calc->opers[calc->opers_count - 1].value != '(' &&
+         calc->opers[calc->opers_count - 1].priority >= priority) {
+    live_oper oper = s21_live_pop_oper(calc);
+    long double a = s21_live_pop_value(calc);
+    long double b = s21_is_unary(oper) ? 0 : s21_live_pop_value(calc);
+    s21_live_push_value(calc, s21_live_apply(oper, b, a));
+  }
+}
+
+/**
+ * @brief Parse the number the current token holds.
+ *
+ * @return VALID_OK or INVALID_EXPRESSION.
+ */
+static int s21_live_number(const live_calc *calc, long double *value) {
+  const char *start = calc->expr + calc->token_start;
+  int len = calc->length - calc->token_start;
+  int dots = 0;
+  for (int i = 0; i < len; i++) dots += start[i] == '.';
+
+  int res = VALID_OK;
+  if (dots > 1 || dots == len ||
+      (len > 1 && start[0] == '0' && isdigit(start[1]))) {
+    res = INVALID_EXPRESSION;
+  } else {
+    char buffer[LIVE_MAX_LEN + 1] = {0};
+    memcpy(buffer, start, len);
+    *value = strtold(buffer, NULL);
+  }
+  return res;
+}
+
+/**
+ * @brief Push the number or the function the current token holds.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_live_finish_token(live_calc *calc) {
+  int res = VALID_OK;
+  if (calc->token == LIVE_NUMBER) {
+    long double value = 0;
+    res = s21_live_number(calc, &value);
+    if (res == VALID_OK) {
+      s21_live_push_value(calc, value);
+      calc->expect_operand = 0;
+    }
+  } else if (calc->token == LIVE_FUNC) {
+    char func[LIVE_MAX_LEN + 1] = {0};
+    memcpy(func, calc->expr + calc->token_start,
+           calc->length - calc->token_start);
+    oper_data data = s21_init_functions(func);
+    if (s21_aggregate_kind(func) != AGGREGATE_NONE ||
+        s21_root_kind(func) != ROOT_NONE) {
+      calc->token = LIVE_CALL;
+      calc->call_depth = 0;
+      return VALID_OK;
+    } else if (data.type == NO_TYPE) {
+      res = UNKNOWN_FUNC;
+    } else {
+      s21_live_push_oper(calc, (live_oper){'f', data.priority, data.math_func});
+    }
+  }
+  calc->token = LIVE_NONE;
+  return res;
+}
+
+/**
+ * @brief Store the next character of an aggregate or a solver call. When the
+ * bracket after its name closes, the call is evaluated by s21_calc_eval() and
+ * its result pushed as an operand.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_live_call(live_calc *calc, char c) {
+  int res = VALID_OK;
+  if (!calc->call_depth && c != '(' && c != ' ') {
+    res = INVALID_EXPRESSION;
+  } else if (c == '(' || c == ')') {
+    calc->call_depth += c == '(' ? 1 : -1;
+  }
+  if (res == VALID_OK && c == ')' && !calc->call_depth) {
+    char call[LIVE_MAX_LEN + 1] = {0};
+    int len = calc->length - calc->token_start;
+    memcpy(call, calc->expr + calc->token_start, len);
+    call[len] = c;
+    long double value = 0;
+    res = s21_calc_eval(call, &value);
+    if (res == VALID_OK) {
+      s21_live_push_value(calc, value);
+      calc->expect_operand = 0;
+      calc->token = LIVE_NONE;
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Update the stacks for the next character. Digits and letters extend
+ * the current token, any other character finishes it first.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_live_process(live_calc *calc, char c) {
+  int is_digit = isdigit(c) || c == '.';
+  int is_alpha = c >= 'a' && c <= 'z';
+  if ((calc->token == LIVE_NUMBER && is_digit) ||
+      (calc->token == LIVE_FUNC && is_alpha)) {
+    return VALID_OK;
+  }
+  if (calc->token == LIVE_CALL) return s21_live_call(calc, c);
+
+  int res = s21_live_finish_token(calc);
+  if (calc->token == LIVE_CALL) return s21_live_call(calc, c);
+  if (res != VALID_OK || c == ' ') return res;
+
+  if (calc->expect_operand) {
+    if (is_digit || is_alpha) {
+      calc->token = is_digit ? LIVE_NUMBER : LIVE_FUNC;
+      calc->token_start = calc->length;
+    } else if (c == '(') {
+      s21_live_push_oper(calc, (live_oper){'(', 1, NULL});
+      calc->brackets++;
+    } else if (c == '-') {
+      s21_live_push_oper(calc, (live_oper){'~', LIVE_NEG_PRIORITY, NULL});
+    } else if (c != '+') {
+      res = INVALID_EXPRESSION;
+    }
+  } else if (c == ')') {
+    if (!calc->brackets) {
+      res = BRACKETS_NOT_MATCH;
+    } else {
+      s21_live_reduce(calc, 0);
+      s21_live_pop_oper(calc);
+      calc->brackets--;
+    }
+  } else if (c && strchr("+-*/:^", c)) {
+    oper_data data = s21_init_oper(c);
+    s21_live_reduce(calc, data.priority + (data.assoc == ASSOC_RIGHT));
+    s21_live_push_oper(calc, (live_oper){data.value, data.priority, NULL});
+    calc->expect_operand = 1;
+  } else {
+    res = INVALID_EXPRESSION;
+  }
+  return res;
+}
+
+/**
+ * @brief Create an empty live expression.
+ *
+ * @return The expression, to be freed with s21_clear_live_calc(), or NULL.
+ */
+live_calc *s21_create_live_calc(void) {
+  live_calc *res = malloc(sizeof(live_calc));
+  if (res) s21_live_reset(res);
+  return res;
+}
+
+/**
+ * @brief Append text to the expression, one character at a time. A checkpoint
+ * is saved before every character, and after an error the characters are only
+ * stored until backspace removes the wrong one.
+ *
+ * @param calc The expression.
+ * @param text Text to append, e.g. a digit or "cos(".
+ * @return VALID_OK, the validation error of the expression or STR_OVERFLOW if
+ * the text does not fit.
+ */
+int s21_live_append(live_calc *calc, const char *text) {
+  if (!calc || !text) return NULL_PTR;
+  for (; *text; text++) {
+    if (calc->length == LIVE_MAX_LEN) return STR_OVERFLOW;
+    calc->checkpoints[calc->length] = (live_checkpoint){
+        calc->log_size,   calc->expect_operand, calc->token, calc->token_start,
+        calc->call_depth, calc->brackets,       calc->error};
+    if (!calc->error) calc->error = s21_live_process(calc, *text);
+    calc->expr[calc->length++] = *text;
+  }
+  return calc->error;
+}
+
+/**
+ * @brief Remove the last character, rewinding the stacks to its checkpoint.
+ *
+ * @param calc The expression.
+ * @return VALID_OK or the validation error of the remaining expression.
+ */
+int s21_live_backspace(live_calc *calc) {
+  if (!calc) return NULL_PTR;
+  if (calc->length) {
+    live_checkpoint checkpoint = calc->checkpoints[--calc->length];
+    while (calc->log_size > checkpoint.log_size) {
+      live_log_entry entry = calc->log[--calc->log_size];
+      if (entry.kind == LOG_PUSH_VALUE) {
+        calc->values_count--;
+      } else if (entry.kind == LOG_POP_VALUE) {
+        calc->values[calc->values_count++] = entry.value;
+      } else if (entry.kind == LOG_PUSH_OPER) {
+        calc->opers_count--;
+      } else {
+        calc->opers[calc->opers_count++] = entry.oper;
+      }
+    }
+    calc->expr[calc->length] = '\0';
+    calc->expect_operand = checkpoint.expect_operand;
+    calc->token = checkpoint.token;
+    calc->token_start = checkpoint.token_start;
+    calc->call_depth = checkpoint.call_depth;
+    calc->brackets = checkpoint.brackets;
+    calc->error = checkpoint.error;
+  }
+  return calc->error;
+}
+
+/**
+ * @brief Result of the expression typed so far, as if the open brackets were
+ * closed. The stacks are folded from the top without being changed, so the
+ * cost depends only on the number of open operators.
+ *
+ * @param calc The expression.
+ * @param result Output for the result, left unchanged on error.
+ * @return VALID_OK, the validation error of the expression, or
+ * INVALID_EXPRESSION if it is not complete yet.
+ */
+int s21_live_result(const live_calc *calc, long double *result) {
+  if (!calc || !result) return NULL_PTR;
+  if (calc->error) return calc->error;
+
+  long double res = 0;
+  int next = calc->values_count - 1;
+  if (calc->token == LIVE_NUMBER) {
+    if (s21_live_number(calc, &res) != VALID_OK) return INVALID_EXPRESSION;
+  } else if (calc->token == LIVE_FUNC || calc->token == LIVE_CALL ||
+             calc->expect_operand) {
+    return INVALID_EXPRESSION;
+  } else {
+    res = calc->values[next--];
+  }
+
+  for (int i = calc->opers_count - 1; i >= 0; i--) {
+    live_oper oper = calc->opers[i];
+    if (oper.value != '(') {
+      long double b = s21_is_unary(oper) ? 0 : calc->values[next--];
+      res = s21_live_apply(oper, b, res);
+    }
+  }
+  *result = res;
+  return VALID_OK;
+}
+
+/**
+ * @brief Clear the expression.
+ *
+ * @param calc The expression.
+ */
+void s21_live_reset(live_calc *calc) {
+  if (calc) {
+    memset(calc, 0, sizeof(live_calc));
+    calc->expect_operand = 1;
+  }
+}
+
+/**
+ * @brief Free a live expression.
+ *
+ * @param calc The expression.
+ */
+void s21_clear_live_calc(live_calc *calc) { free(calc); }
@@ -0,0 +1,96 @@
+#ifndef S21_PLOT_H
+#define S21_PLOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../compiler/include/s21_compiler.h"
+
+#define PLOT_INITIAL_STEP 8
+#define PLOT_MIN_STEP 0.25
+#define PLOT_TOLERANCE 0.5
+#define PLOT_MAX_EVALS 4096
+#define PLOT_TILE_SIZE 256
+#define PLOT_TILE_EVALS 1024
+#define PLOT_TILE_CACHE_BYTES (16 << 20)
+#define PLOT_TILE_CACHE_TILES 1024
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum plot_return_codes { PLOT_OK, PLOT_ERROR };
+
+/**
+ * @brief Visible area of the plot and its size in pixels.
+ */
+typedef struct plot_view {
+  double x_min;
+  double x_max;
+  double y_min;
+  double y_max;
+  int width;
+  int height;
+} plot_view;
+
+/**
+ * @brief Points of the curve sorted by x. A NAN in y breaks the curve.
+ */
+typedef struct plot_samples {
+  size_t count;
+  size_t evals;
+  double *x;
+  double *y;
+} plot_samples;
+
+/**
+ * @brief Tile of the x axis at a power-of-two zoom level. The tile covers
+ * [index, index + 1) * s21_tile_width(x_level), one pixel of its level is
+ * 2^x_level units of x and 2^y_level units of y.
+ */
+typedef struct plot_tile_key {
+  int x_level;
+  int y_level;
+  int64_t index;
+} plot_tile_key;
+
+typedef struct plot_tile {
+  plot_tile_key key;
+  uint64_t used;
+  size_t bytes;
+  plot_samples samples;
+} plot_tile;
+
+/**
+ * @brief Cache of sampled tiles, the least recently used tiles are evicted
+ * when it holds more than max_bytes or PLOT_TILE_CACHE_TILES tiles.
+ */
+typedef struct plot_tile_cache {
+  plot_tile *tiles;
+  size_t count;
+  size_t bytes;
+  size_t max_bytes;
+  uint64_t tick;
+} plot_tile_cache;
+
+int s21_plot_sample(const compiled_expr *compiled, plot_view view,
+                    size_t max_evals, plot_samples *samples);
+void s21_clear_plot_samples(plot_samples *samples);
+
+double s21_tile_width(int x_level);
+size_t s21_plot_tile_keys(plot_view view, plot_tile_key *keys, size_t max);
+int s21_plot_tile(const compiled_expr *compiled, plot_tile_key key,
+                  plot_samples *samples);
+int s21_tile_cache_init(plot_tile_cache *cache, size_t max_bytes);
+const plot_samples *s21_tile_cache_get(plot_tile_cache *cache,
+                                       plot_tile_key key);
+int s21_tile_cache_put(plot_tile_cache *cache, plot_tile_key key,
+                       plot_samples *samples);
+void s21_tile_cache_reset(plot_tile_cache *cache);
+void s21_clear_tile_cache(plot_tile_cache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_PLOT_H
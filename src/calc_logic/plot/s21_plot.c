@@ -0,0 +1,318 @@
+/**
+ * @file
+ * @brief Contains adaptive sampling of function graphs
+ */
+
+#include "include/s21_plot.h"
+
+typedef struct plot_candidate {
+  size_t index;
+  double score;
+} plot_candidate;
+
+/**
+ * @brief Pixel scale of the sampled range. Points outside [y_min, y_max] are
+ * not drawn, jumps higher than jump pixels are treated as breaks.
+ */
+typedef struct plot_scale {
+  double x_min;
+  double x_max;
+  double y_min;
+  double y_max;
+  double sx;
+  double sy;
+  double jump;
+} plot_scale;
+
+typedef struct plot_buffers {
+  double *x;
+  double *y;
+  double *next_x;
+  double *next_y;
+  double *mid_x;
+  double *mid_y;
+  plot_candidate *candidates;
+} plot_buffers;
+
+static int s21_by_score(const void *a, const void *b) {
+  double diff = ((const plot_candidate *)b)->score -
+                ((const plot_candidate *)a)->score;
+  return (diff > 0) - (diff < 0);
+}
+
+static int s21_by_index(const void *a, const void *b) {
+  size_t ia = ((const plot_candidate *)a)->index;
+  size_t ib = ((const plot_candidate *)b)->index;
+  return (ia > ib) - (ia < ib);
+}
+
+/**
+ * @brief Distance in pixels between the middle point and the chord of its
+ * neighbours, i.e. the error of drawing the two segments as one.
+ */
+static double s21_chord_error(const double *x, const double *y, size_t l,
+                              size_t m, size_t r, double sy) {
+  double res = 0;
+  if (isfinite(y[l]) && isfinite(y[m]) && isfinite(y[r]) && x[r] > x[l]) {
+    double t = (x[m] - x[l]) / (x[r] - x[l]);
+    res = fabs(y[m] - (y[l] + (y[r] - y[l]) * t)) * sy;
+  }
+  return res;
+}
+
+/**
+ * @brief Check if the interval between points i and i + 1 lies entirely above
+ * or below the view.
+ */
+static int s21_is_hidden(const double *y, size_t i, const plot_scale *scale) {
+  return (y[i] > scale->y_max && y[i + 1] > scale->y_max) ||
+         (y[i] < scale->y_min && y[i + 1] < scale->y_min);
+}
+
+/**
+ * @brief How badly the interval between points i and i + 1 needs another
+ * sample, in pixels. Domain edges and jumps higher than the view always
+ * qualify, so poles of tan and the edge of log are located first.
+ */
+static double s21_interval_score(const double *x, const double *y,
+                                 size_t count, size_t i,
+                                 const plot_scale *scale) {
+  int finite_a = isfinite(y[i]);
+  int finite_b = isfinite(y[i + 1]);
+  if (finite_a != finite_b) return scale->jump;
+  if (!finite_a || s21_is_hidden(y, i, scale)) return 0;
+
+  double sy = scale->sy;
+  double jump = fabs(y[i + 1] - y[i]) * sy;
+  double res = jump > scale->jump ? jump : 0;
+  if (i > 0) res = fmax(res, s21_chord_error(x, y, i - 1, i, i + 1, sy));
+  if (i + 2 < count) {
+    res = fmax(res, s21_chord_error(x, y, i, i + 1, i + 2, sy));
+  }
+  return res;
+}
+
+static int s21_slope_sign(const double *y, size_t a, size_t b) {
+  return (y[b] > y[a]) - (y[b] < y[a]);
+}
+
+/**
+ * @brief Check if the curve jumps between points i and i + 1 instead of
+ * passing through the view, e.g. at a pole of tan. The jump has to be higher
+ * than the view and either be refined down to the minimal step or go against
+ * the slope on both sides.
+ */
+static int s21_is_break(const double *x, const double *y, size_t count,
+                        size_t i, const plot_scale *scale) {
+  if (!isfinite(y[i]) || !isfinite(y[i + 1])) return 0;
+  if (s21_is_hidden(y, i, scale)) return 0;
+  if (fabs(y[i + 1] - y[i]) * scale->sy <= scale->jump) return 0;
+  if ((x[i + 1] - x[i]) * scale->sx < 2 * PLOT_MIN_STEP) return 1;
+
+  int slope = s21_slope_sign(y, i, i + 1);
+  int prev =
+      i > 0 && isfinite(y[i - 1]) ? s21_slope_sign(y, i - 1, i) : -slope;
+  int next = i + 2 < count && isfinite(y[i + 2])
+                 ? s21_slope_sign(y, i + 1, i + 2)
+                 : -slope;
+  return prev != slope && next != slope;
+}
+
+/**
+ * @brief Insert the evaluated midpoints of the chosen intervals into the
+ * sorted points.
+ *
+ * @return New number of points.
+ */
+static size_t s21_merge_points(plot_buffers *buf, size_t count, size_t found) {
+  size_t n = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < count; i++) {
+    buf->next_x[n] = buf->x[i];
+    buf->next_y[n++] = buf->y[i];
+    if (j < found && buf->candidates[j].index == i) {
+      buf->next_x[n] = buf->mid_x[j];
+      buf->next_y[n++] = buf->mid_y[j++];
+    }
+  }
+
+  double *tmp = buf->x;
+  buf->x = buf->next_x;
+  buf->next_x = tmp;
+  tmp = buf->y;
+  buf->y = buf->next_y;
+  buf->next_y = tmp;
+  return n;
+}
+
+/**
+ * @brief Split the interval between the points at the positions the
+ * candidates of the current round point to, evaluating all midpoints in one
+ * batch. When the budget is short, the worst intervals are split first.
+ *
+ * @return Number of evaluated points, 0 if there is nothing to refine.
+ */
+static size_t s21_refine(const compiled_expr *compiled, plot_buffers *buf,
+                         size_t *count, size_t budget,
+                         const plot_scale *scale) {
+  size_t found = 0;
+  for (size_t i = 0; i + 1 < *count; i++) {
+    if ((buf->x[i + 1] - buf->x[i]) * scale->sx >= 2 * PLOT_MIN_STEP) {
+      double score = s21_interval_score(buf->x, buf->y, *count, i, scale);
+      if (score > PLOT_TOLERANCE) {
+        buf->candidates[found++] = (plot_candidate){i, score};
+      }
+    }
+  }
+  if (found > budget) {
+    qsort(buf->candidates, found, sizeof(plot_candidate), s21_by_score);
+    found = budget;
+    qsort(buf->candidates, found, sizeof(plot_candidate), s21_by_index);
+  }
+
+  for (size_t j = 0; j < found; j++) {
+    size_t i = buf->candidates[j].index;
+    buf->mid_x[j] = (buf->x[i] + buf->x[i + 1]) / 2;
+  }
+  if (found) {
+    s21_eval_compiled_batch(compiled, buf->mid_x, buf->mid_y, found);
+    *count = s21_merge_points(buf, *count, found);
+  }
+  return found;
+}
+
+/**
+ * @brief Sample a function over the range of the scale.
+ *
+ * The function is evaluated in batch on a coarse uniform grid, then intervals
+ * that bend by more than PLOT_TOLERANCE pixels, jump over the view or cross
+ * the domain edge are split in rounds until they are PLOT_MIN_STEP pixels
+ * wide. The number of evaluations never exceeds max_evals.
+ */
+static int s21_plot_scaled(const compiled_expr *compiled,
+                           const plot_scale *scale, size_t max_evals,
+                           plot_samples *samples) {
+  memset(samples, 0, sizeof(plot_samples));
+
+  plot_buffers buf = {0};
+  buf.x = malloc(max_evals * (6 * sizeof(double) + sizeof(plot_candidate)));
+  if (!buf.x) return PLOT_ERROR;
+  buf.y = buf.x + max_evals;
+  buf.next_x = buf.y + max_evals;
+  buf.next_y = buf.next_x + max_evals;
+  buf.mid_x = buf.next_y + max_evals;
+  buf.mid_y = buf.mid_x + max_evals;
+  buf.candidates = (plot_candidate *)(buf.mid_y + max_evals);
+  double *block = buf.x;
+
+  double range = scale->x_max - scale->x_min;
+  size_t count = (size_t)(range * scale->sx) / PLOT_INITIAL_STEP + 2;
+  if (count > max_evals) count = max_evals;
+  for (size_t i = 0; i < count; i++) {
+    buf.x[i] = scale->x_min + range * i / (count - 1);
+  }
+
+  int res = s21_eval_compiled_batch(compiled, buf.x, buf.y, count) == VALID_OK
+                ? PLOT_OK
+                : PLOT_ERROR;
+  size_t evals = count;
+  for (size_t found = 1; res == PLOT_OK && found && evals < max_evals;) {
+    found = s21_refine(compiled, &buf, &count, max_evals - evals, scale);
+    evals += found;
+  }
+
+  if (res == PLOT_OK) {
+    samples->x = malloc(2 * count * sizeof(double));
+    samples->y = malloc(2 * count * sizeof(double));
+    if (!samples->x || !samples->y) res = PLOT_ERROR;
+  }
+  if (res == PLOT_OK) {
+    for (size_t i = 0; i < count; i++) {
+      samples->x[samples->count] = buf.x[i];
+      samples->y[samples->count++] = isfinite(buf.y[i]) ? buf.y[i] : NAN;
+      if (i + 1 < count && s21_is_break(buf.x, buf.y, count, i, scale)) {
+        samples->x[samples->count] = (buf.x[i] + buf.x[i + 1]) / 2;
+        samples->y[samples->count++] = NAN;
+      }
+    }
+    double *x = realloc(samples->x, samples->count * sizeof(double));
+    double *y = realloc(samples->y, samples->count * sizeof(double));
+    if (x) samples->x = x;
+    if (y) samples->y = y;
+    samples->evals = evals;
+  } else {
+    s21_clear_plot_samples(samples);
+  }
+  free(block);
+  return res;
+}
+
+/**
+ * @brief Sample a function for drawing in the given view.
+ *
+ * The number of evaluations never exceeds max_evals, whatever the width and
+ * the zoom are.
+ *
+ * @param compiled The function.
+ * @param view Visible area and its size in pixels.
+ * @param max_evals Budget of function evaluations, at least 2.
+ * @param samples Output for the points, to be freed with
+ * s21_clear_plot_samples().
+ * @return PLOT_OK on success, PLOT_ERROR otherwise.
+ */
+int s21_plot_sample(const compiled_expr *compiled, plot_view view,
+                    size_t max_evals, plot_samples *samples) {
+  if (!compiled || !samples || view.width <= 0 || view.height <= 0 ||
+      !(view.x_max > view.x_min) || !(view.y_max > view.y_min) ||
+      max_evals < 2) {
+    return PLOT_ERROR;
+  }
+
+  plot_scale scale = {view.x_min,
+                      view.x_max,
+                      view.y_min,
+                      view.y_max,
+                      view.width / (view.x_max - view.x_min),
+                      view.height / (view.y_max - view.y_min),
+                      view.height};
+  return s21_plot_scaled(compiled, &scale, max_evals, samples);
+}
+
+/**
+ * @brief Sample a function over a tile. A tile is PLOT_TILE_SIZE pixels of
+ * its level wide and does not depend on the vertical position of the view,
+ * so it is reused while the view is panned.
+ *
+ * @param compiled The function.
+ * @param key The tile.
+ * @param samples Output for the points, to be freed with
+ * s21_clear_plot_samples().
+ * @return PLOT_OK on success, PLOT_ERROR otherwise.
+ */
+int s21_plot_tile(const compiled_expr *compiled, plot_tile_key key,
+                  plot_samples *samples) {
+  if (!compiled || !samples) return PLOT_ERROR;
+
+  double width = s21_tile_width(key.x_level);
+  plot_scale scale = {key.index * width,
+                      (key.index + 1) * width,
+                      -INFINITY,
+                      INFINITY,
+                      PLOT_TILE_SIZE / width,
+                      1 / ldexp(1, key.y_level),
+                      PLOT_TILE_SIZE};
+  return s21_plot_scaled(compiled, &scale, PLOT_TILE_EVALS, samples);
+}
+
+/**
+ * @brief Free the points of a sampled plot.
+ *
+ * @param samples The points.
+ */
+void s21_clear_plot_samples(plot_samples *samples) {
+  if (samples) {
+    free(samples->x);
+    free(samples->y);
+    memset(samples, 0, sizeof(plot_samples));
+  }
+}
@@ -0,0 +1,171 @@
+/**
+ * @file
+ * @brief Contains level-of-detail tiles of function graphs and their cache
+ */
+
+#include "include/s21_plot.h"
+
+/**
+ * @brief Width of the tiles of a level in units of x.
+ *
+ * @param x_level The level, one pixel is 2^x_level units of x.
+ * @return The width.
+ */
+double s21_tile_width(int x_level) { return ldexp(PLOT_TILE_SIZE, x_level); }
+
+/**
+ * @brief List the tiles covering the view. The levels are the power-of-two
+ * scales not coarser than the view, so a tile is never blurrier than the
+ * screen and every zoom between two levels reuses the same tiles.
+ *
+ * @param view Visible area and its size in pixels.
+ * @param keys Output for the tiles, from left to right.
+ * @param max Size of keys.
+ * @return Number of tiles written to keys.
+ */
+size_t s21_plot_tile_keys(plot_view view, plot_tile_key *keys, size_t max) {
+  if (!keys || view.width <= 0 || view.height <= 0 ||
+      !(view.x_max > view.x_min) || !(view.y_max > view.y_min)) {
+    return 0;
+  }
+
+  int x_level = (int)floor(log2((view.x_max - view.x_min) / view.width));
+  int y_level = (int)floor(log2((view.y_max - view.y_min) / view.height));
+  double width = s21_tile_width(x_level);
+  double first = floor(view.x_min / width);
+  double last = floor(view.x_max / width);
+  if (!(fabs(first) < 0x1p62 && fabs(last) < 0x1p62)) return 0;
+
+  size_t res = 0;
+  for (int64_t i = (int64_t)first; i <= (int64_t)last && res < max; i++) {
+    keys[res++] = (plot_tile_key){x_level, y_level, i};
+  }
+  return res;
+}
+
+static int s21_same_tile(plot_tile_key a, plot_tile_key b) {
+  return a.x_level == b.x_level && a.y_level == b.y_level &&
+         a.index == b.index;
+}
+
+/**
+ * @brief Find a tile in the cache.
+ *
+ * @return Position of the tile or cache->count if it is not cached.
+ */
+static size_t s21_find_tile(const plot_tile_cache *cache, plot_tile_key key) {
+  size_t i = 0;
+  while (i < cache->count && !s21_same_tile(cache->tiles[i].key, key)) i++;
+  return i;
+}
+
+/**
+ * @brief Free the tile at the given position, the last tile takes its place.
+ */
+static void s21_remove_tile(plot_tile_cache *cache, size_t pos) {
+  cache->bytes -= cache->tiles[pos].bytes;
+  s21_clear_plot_samples(&cache->tiles[pos].samples);
+  cache->tiles[pos] = cache->tiles[--cache->count];
+}
+
+/**
+ * @brief Evict the least recently used tiles until a tile of the given size
+ * fits.
+ */
+static void s21_evict_tiles(plot_tile_cache *cache, size_t bytes) {
+  while (cache->count && (cache->count == PLOT_TILE_CACHE_TILES ||
+                          cache->bytes + bytes > cache->max_bytes)) {
+    size_t oldest = 0;
+    for (size_t i = 1; i < cache->count; i++) {
+      if (cache->tiles[i].used < cache->tiles[oldest].used) oldest = i;
+    }
+    s21_remove_tile(cache, oldest);
+  }
+}
+
+/**
+ * @brief Create an empty tile cache.
+ *
+ * @param cache The cache, to be freed with s21_clear_tile_cache().
+ * @param max_bytes Memory limit of the cached points, 0 for
+ * PLOT_TILE_CACHE_BYTES.
+ * @return PLOT_OK on success, PLOT_ERROR otherwise.
+ */
+int s21_tile_cache_init(plot_tile_cache *cache, size_t max_bytes) {
+  if (!cache) return PLOT_ERROR;
+  memset(cache, 0, sizeof(plot_tile_cache));
+  cache->tiles = calloc(PLOT_TILE_CACHE_TILES, sizeof(plot_tile));
+  cache->max_bytes = max_bytes ? max_bytes : PLOT_TILE_CACHE_BYTES;
+  return cache->tiles ? PLOT_OK : PLOT_ERROR;
+}
+
+/**
+ * @brief Look up a tile and mark it as recently used.
+ *
+ * @param cache The cache.
+ * @param key The tile.
+ * @return Points of the tile, owned by the cache, or NULL if it is not
+ * cached.
+ */
+const plot_samples *s21_tile_cache_get(plot_tile_cache *cache,
+                                       plot_tile_key key) {
+  const plot_samples *res = NULL;
+  if (cache && cache->tiles) {
+    size_t pos = s21_find_tile(cache, key);
+    if (pos < cache->count) {
+      cache->tiles[pos].used = ++cache->tick;
+      res = &cache->tiles[pos].samples;
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Store a sampled tile, evicting the least recently used tiles if the
+ * cache is full.
+ *
+ * @param cache The cache.
+ * @param key The tile.
+ * @param samples Points of the tile, the cache takes them over and samples is
+ * left empty.
+ * @return PLOT_OK on success, PLOT_ERROR otherwise.
+ */
+int s21_tile_cache_put(plot_tile_cache *cache, plot_tile_key key,
+                       plot_samples *samples) {
+  if (!cache || !cache->tiles || !samples) return PLOT_ERROR;
+
+  size_t pos = s21_find_tile(cache, key);
+  if (pos < cache->count) s21_remove_tile(cache, pos);
+
+  size_t bytes = sizeof(plot_tile) + samples->count * 2 * sizeof(double);
+  s21_evict_tiles(cache, bytes);
+  cache->tiles[cache->count++] =
+      (plot_tile){key, ++cache->tick, bytes, *samples};
+  cache->bytes += bytes;
+  memset(samples, 0, sizeof(plot_samples));
+  return PLOT_OK;
+}
+
+/**
+ * @brief Drop all tiles, e.g. when the function changes.
+ *
+ * @param cache The cache.
+ */
+void s21_tile_cache_reset(plot_tile_cache *cache) {
+  if (cache) {
+    while (cache->count) s21_remove_tile(cache, cache->count - 1);
+  }
+}
+
+/**
+ * @brief Free a tile cache.
+ *
+ * @param cache The cache.
+ */
+void s21_clear_tile_cache(plot_tile_cache *cache) {
+  if (cache) {
+    s21_tile_cache_reset(cache);
+    free(cache->tiles);
+    memset(cache, 0, sizeof(plot_tile_cache));
+  }
+}
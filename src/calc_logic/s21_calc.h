@@ -7,15 +7,16 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "stack/include/s21_operators_stack.h"
-#include "stack/include/s21_stack.h"
+#include "translator/include/translator.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+int s21_calc_eval(const char *expr, long double *result);
+int s21_calc_eval_cancel(const char *expr, const calc_cancel_flag *cancel,
+                         long double *result);
 long double s21_smart_calc(const char *expr);
-void s21_exec_calc(Stack *nums, OperStack *oper_stack);
 
 #ifdef __cplusplus
 }
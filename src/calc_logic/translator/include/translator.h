@@ -1,10 +1,20 @@
 #ifndef TRANSLATOR_H
 #define TRANSLATOR_H
 
-#include "../../stack/include/s21_operators_stack.h"
-#include "../../stack/include/s21_stack.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-#define NO_NUM -335
+/* The flag a caller sets to stop a long evaluation from another thread. */
+#ifdef __cplusplus
+#include <atomic>
+typedef std::atomic_bool calc_cancel_flag;
+#else
+#include <stdatomic.h>
+typedef atomic_bool calc_cancel_flag;
+#endif
 
 /* VALIDATION */
 enum validation_error_codes {
@@ -14,36 +24,30 @@ enum validation_error_codes {
   UNKNOWN_FUNC = 1569325043,
   STR_OVERFLOW = 1569325044,
   NULL_PTR = 1569325045,
+  RECURSIVE_FUNC = 1569325046,
+  CANCELLED = 1569325047,
 };
-typedef struct validation_data {
-  int left_brackets;
-  int right_brackets;
-  int opers;
-  int nums;
-  int funcs;
-} validation_data;
-
-int s21_is_oper(const char *expr, int *iter);
-int s21_is_number(const char *expr, int *iter);
-int s21_is_correct_func(const char *expr, int *iter);
-validation_data s21_collect_data(const char *expr);
-int s21_expr_validation(const char *expr);
 
 /* ================================================= */
 /* TRANSLATOR */
+enum oper_type { NO_TYPE, LEFT_BRACKET, RIGHT_BRACKET, OPERAND, FUNC };
+enum oper_assoc { ASSOC_LEFT, ASSOC_RIGHT };
+
+typedef struct oper_data {
+  char value;
+  enum oper_type type;
+  int priority;
+  enum oper_assoc assoc;
+  double (*math_func)(double);
+} oper_data;
+
 oper_data s21_init_oper(char c);
 oper_data s21_init_functions(char func[10]);
-oper_data s21_read_oper(OperStack *opers, const char *expression,
-                        int *exp_iter);
-int s21_read_expression(const char *expr, Stack *nums, OperStack *oper_stack,
-                        int iter);
-
 void s21_read_funcs(const char *expression, int *exp_iter, char *buffer);
-long double s21_read_fraction(const char *expr, int *exp_iter, int int_part,
-                              int unary_minus);
-long s21_num_from_str(const char *format, int *iter);
-int s21_check_unary_oper(const char *expr, int exp_iter, oper_data cur_oper,
-                         int *unary);
-int s21_check_oper_priority(OperStack *oper_stack, oper_data cur_oper);
-int s21_check_iter_offset(oper_data cur_oper);
+
+/* ================================================= */
+/* PARSER */
+int s21_parse_expr(const char *expr, long double *result);
+int s21_parse_expr_cancel(const char *expr, const calc_cancel_flag *cancel,
+                          long double *result);
 #endif  // TRANSLATOR_H
@@ -0,0 +1,323 @@
+/**
+ * @file
+ * @brief Contains the precedence-climbing parser that evaluates an expression
+ * in a single pass
+ */
+
+#include "include/translator.h"
+
+#include "../compiler/include/s21_aggregate.h"
+#include "../compiler/include/s21_roots.h"
+
+#define PARSER_MAX_LEN 255
+#define PARSER_NEG_PRIORITY 4
+#define PARSER_MAX_ARGS 4
+
+typedef struct parser_state {
+  const char *expr;
+  int iter;
+  const calc_cancel_flag *cancel;
+} parser_state;
+
+static int s21_parse_binary(parser_state *state, int min_priority,
+                            long double *value);
+
+static char s21_parser_peek(parser_state *state) {
+  while (state->expr[state->iter] == ' ') state->iter++;
+  return state->expr[state->iter];
+}
+
+/**
+ * @brief Apply a binary operator the way the stack engine did: any NAN
+ * operand and a division by zero give NAN.
+ */
+static long double s21_parser_apply(char oper, long double b, long double a) {
+  long double res = NAN;
+  if (!isnan(a) && !isnan(b)) {
+    if (oper == '+') {
+      res = b + a;
+    } else if (oper == '-') {
+      res = b - a;
+    } else if (oper == '*') {
+      res = b * a;
+    } else if (oper == '/') {
+      res = a ? b / a : NAN;
+    } else if (oper == '^') {
+      res = pow(b, a);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Read a number. Numbers with two dots, a lone dot and leading zeros
+ * are invalid.
+ */
+static int s21_parse_number(parser_state *state, long double *value) {
+  const char *start = state->expr + state->iter;
+  int len = 0;
+  int dots = 0;
+  while (isdigit(start[len]) || start[len] == '.') dots += start[len++] == '.';
+  state->iter += len;
+
+  int res = VALID_OK;
+  if (dots > 1 || dots == len || (start[0] == '0' && isdigit(start[1]))) {
+    res = INVALID_EXPRESSION;
+  } else {
+    char buffer[PARSER_MAX_LEN + 1] = {0};
+    memcpy(buffer, start, len);
+    *value = strtold(buffer, NULL);
+  }
+  return res;
+}
+
+/**
+ * @brief Split the bracketed arguments of an aggregate at the commas that
+ * are not inside nested brackets.
+ *
+ * @return Number of arguments, -1 for too many, -2 for a missing bracket.
+ */
+static int s21_parse_args(parser_state *state,
+                          char args[PARSER_MAX_ARGS][PARSER_MAX_LEN + 1]) {
+  int count = 0;
+  int depth = 0;
+  int start = ++state->iter;
+  for (;; state->iter++) {
+    char c = state->expr[state->iter];
+    if (!c) return -2;
+    if ((c == ',' || c == ')') && !depth) {
+      if (count == PARSER_MAX_ARGS) return -1;
+      memcpy(args[count++], state->expr + start, state->iter - start);
+      start = state->iter + 1;
+      if (c == ')') break;
+    } else if (c == '(' || c == ')') {
+      depth += c == '(' ? 1 : -1;
+    }
+  }
+  state->iter++;
+  return count;
+}
+
+/**
+ * @brief Read the name of the index of a series or of the variable of a
+ * solver, surrounded by spaces.
+ */
+static int s21_parse_index(const char *arg, char *index) {
+  int iter = 0;
+  while (arg[iter] == ' ') iter++;
+  s21_read_funcs(arg, &iter, index);
+  while (arg[iter] == ' ') iter++;
+  return index[0] && !arg[iter] && s21_init_functions(index).type == NO_TYPE &&
+                 s21_aggregate_kind(index) == AGGREGATE_NONE &&
+                 s21_root_kind(index) == ROOT_NONE
+             ? VALID_OK
+             : INVALID_EXPRESSION;
+}
+
+/**
+ * @brief Read sum(i, from, to, expr), prod(i, from, to, expr) or
+ * integral(expr, a, b). The bounds are evaluated by the parser, the body is
+ * compiled and runs on the batch evaluator, so a series costs one short
+ * expression instead of an expanded one.
+ */
+static int s21_parse_aggregate(parser_state *state, int kind,
+                               long double *value) {
+  char args[PARSER_MAX_ARGS][PARSER_MAX_LEN + 1] = {{0}};
+  if (s21_parser_peek(state) != '(') return INVALID_EXPRESSION;
+  int count = s21_parse_args(state, args);
+  if (count == -2) return BRACKETS_NOT_MATCH;
+  if (count != (kind == AGGREGATE_INTEGRAL ? 3 : 4)) {
+    return INVALID_EXPRESSION;
+  }
+
+  long double from = 0;
+  long double to = 0;
+  int res = s21_parse_expr_cancel(args[1], state->cancel, &from);
+  if (res == VALID_OK) res = s21_parse_expr_cancel(args[2], state->cancel, &to);
+
+  compiled_expr body = {0};
+  char index[PARSER_MAX_LEN + 1] = {0};
+  if (res == VALID_OK && kind == AGGREGATE_INTEGRAL) {
+    res = s21_compile_expr(args[0], &body);
+  } else if (res == VALID_OK) {
+    res = s21_parse_index(args[0], index);
+    if (res == VALID_OK) res = s21_compile_series(index, args[3], &body);
+  }
+
+  double result = 0;
+  if (res == VALID_OK && kind == AGGREGATE_INTEGRAL) {
+    res = s21_eval_integral(&body, from, to, state->cancel, &result);
+  } else if (res == VALID_OK) {
+    res = s21_eval_series(&body, kind, from, to, 0, state->cancel, &result);
+  }
+  s21_clear_compiled(&body);
+  *value = result;
+  return res;
+}
+
+/**
+ * @brief Read solve(expr, x, a, b), the smallest root of expr from a to b,
+ * or minimize(expr, x, a, b), the position of its smallest value. Both are
+ * NAN when there is none.
+ */
+static int s21_parse_root(parser_state *state, int kind, long double *value) {
+  char args[PARSER_MAX_ARGS][PARSER_MAX_LEN + 1] = {{0}};
+  if (s21_parser_peek(state) != '(') return INVALID_EXPRESSION;
+  int count = s21_parse_args(state, args);
+  if (count == -2) return BRACKETS_NOT_MATCH;
+  if (count != 4) return INVALID_EXPRESSION;
+
+  long double a = 0;
+  long double b = 0;
+  char var[PARSER_MAX_LEN + 1] = {0};
+  int res = s21_parse_expr_cancel(args[2], state->cancel, &a);
+  if (res == VALID_OK) res = s21_parse_expr_cancel(args[3], state->cancel, &b);
+  if (res == VALID_OK) res = s21_parse_index(args[1], var);
+
+  compiled_expr body = {0};
+  if (res == VALID_OK) res = s21_compile_series(var, args[0], &body);
+  double result = NAN;
+  if (res == VALID_OK && kind == ROOT_SOLVE) {
+    int found = 0;
+    res = s21_solve_expr(&body, a, b, &result, 1, &found);
+    if (!found) result = NAN;
+  } else if (res == VALID_OK) {
+    res = s21_minimize_expr(&body, a, b, &result, NULL);
+  }
+  s21_clear_compiled(&body);
+  *value = result;
+  return res;
+}
+
+/**
+ * @brief Read a function name and apply the function to the operand that
+ * follows it, so sin(x)^2 is (sin x)^2. Aggregates and solvers take their
+ * arguments in brackets instead.
+ */
+static int s21_parse_func(parser_state *state, long double *value) {
+  char func[PARSER_MAX_LEN + 1] = {0};
+  s21_read_funcs(state->expr, &state->iter, func);
+  int kind = s21_aggregate_kind(func);
+  if (kind != AGGREGATE_NONE) return s21_parse_aggregate(state, kind, value);
+  kind = s21_root_kind(func);
+  if (kind != ROOT_NONE) return s21_parse_root(state, kind, value);
+  oper_data data = s21_init_functions(func);
+  if (data.type == NO_TYPE) return UNKNOWN_FUNC;
+
+  int res = s21_parse_binary(state, data.priority, value);
+  if (res == VALID_OK) {
+    if (*value < 0 && data.math_func == sqrt) {
+      *value = NAN;
+    } else {
+      *value = data.math_func(*value);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Read a token at a position where an operand is expected: a number,
+ * a function, a bracket or a prefix operator.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_parse_operand(parser_state *state, long double *value) {
+  int res = VALID_OK;
+  char c = s21_parser_peek(state);
+
+  if (isdigit(c) || c == '.') {
+    res = s21_parse_number(state, value);
+  } else if (c >= 'a' && c <= 'z') {
+    res = s21_parse_func(state, value);
+  } else if (c == '(') {
+    state->iter++;
+    res = s21_parse_binary(state, 0, value);
+    c = res == VALID_OK ? s21_parser_peek(state) : 0;
+    if (c == ')') {
+      state->iter++;
+    } else if (res == VALID_OK) {
+      res = c ? INVALID_EXPRESSION : BRACKETS_NOT_MATCH;
+    }
+  } else if (c == '-' || c == '+') {
+    state->iter++;
+    res = s21_parse_binary(state, PARSER_NEG_PRIORITY, value);
+    if (c == '-') *value = -*value;
+  } else {
+    res = INVALID_EXPRESSION;
+  }
+  return res;
+}
+
+/**
+ * @brief Read an operand and then every binary operator binding at least as
+ * tight as min_priority, with its right operand.
+ *
+ * Every call consumes at least one character before it recurses, so the
+ * depth is bounded by the length of the expression, and every character is
+ * read once, so the whole parse is linear.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_parse_binary(parser_state *state, int min_priority,
+                            long double *value) {
+  int res = s21_parse_operand(state, value);
+  if (res != VALID_OK) return res;
+  char c = s21_parser_peek(state);
+  while (res == VALID_OK && c && strchr("+-*/:^", c)) {
+    oper_data data = s21_init_oper(c);
+    if (data.priority < min_priority) break;
+    state->iter++;
+
+    long double right = 0;
+    int next = data.priority + (data.assoc == ASSOC_LEFT);
+    res = s21_parse_binary(state, next, &right);
+    *value = s21_parser_apply(data.value, *value, right);
+    if (res == VALID_OK) c = s21_parser_peek(state);
+  }
+  return res;
+}
+
+/**
+ * @brief Evaluate an expression in a single pass, without stacks.
+ *
+ * Operators take their priorities and associativity from s21_init_oper(),
+ * so 2^3^2 is 2^9, and a unary minus binds weaker than the power, so -2^2 is
+ * -4.
+ *
+ * @param expr The expression.
+ * @param result Output for the result, left unchanged on error.
+ * @return VALID_OK on success or a validation error code.
+ */
+int s21_parse_expr(const char *expr, long double *result) {
+  return s21_parse_expr_cancel(expr, NULL, result);
+}
+
+/**
+ * @brief Evaluate an expression like s21_parse_expr(), stopping the sums,
+ * products and integrals in it once the flag is set.
+ *
+ * @param expr The expression.
+ * @param cancel Flag set by another thread to stop the evaluation, or NULL.
+ * @param result Output for the result, left unchanged on error.
+ * @return VALID_OK on success, CANCELLED if the flag was set, or a
+ * validation error code.
+ */
+int s21_parse_expr_cancel(const char *expr, const calc_cancel_flag *cancel,
+                          long double *result) {
+  if (!expr || !result) return NULL_PTR;
+  if (strlen(expr) > PARSER_MAX_LEN) return STR_OVERFLOW;
+
+  parser_state state = {expr, 0, cancel};
+  long double value = 0;
+  int res = s21_parse_binary(&state, 0, &value);
+  if (res == VALID_OK) {
+    char c = s21_parser_peek(&state);
+    if (c == ')') {
+      res = BRACKETS_NOT_MATCH;
+    } else if (c) {
+      res = INVALID_EXPRESSION;
+    }
+  }
+  if (res == VALID_OK) *result = value;
+  return res;
+}
@@ -0,0 +1,66 @@
+#ifndef S21_WORKBOOK_H
+#define S21_WORKBOOK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../compiler/include/s21_functions.h"
+
+#define WORKBOOK_MAX_REFS 256
+#define WORKBOOK_PARALLEL_MIN 2048
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A named cell such as payment = annuity(amount, rate, term). refs
+ * are the cells the expression reads, in the order of its parameters,
+ * users are the cells that read this one. A cell that is only referenced
+ * has no expression and reports UNKNOWN_FUNC.
+ */
+typedef struct workbook_cell {
+  char name[FUNC_NAME_SIZE];
+  char *expr;
+  compiled_expr program;
+  int compile_status;
+  int status;
+  double value;
+  int *refs;
+  int refs_count;
+  int *users;
+  int users_count;
+  int users_capacity;
+  int pending;
+  uint8_t dirty;
+} workbook_cell;
+
+/**
+ * @brief Cells that reference each other by name, with a registry of
+ * functions they may call. Changed cells wait in changed until
+ * s21_workbook_recalc().
+ */
+typedef struct workbook {
+  workbook_cell *cells;
+  int count;
+  int capacity;
+  int *index;
+  int index_capacity;
+  int *changed;
+  int changed_count;
+  int changed_capacity;
+  func_registry *registry;
+} workbook;
+
+workbook *s21_create_workbook(void);
+int s21_workbook_func(workbook *book, const char *definition);
+int s21_workbook_set(workbook *book, const char *name, const char *expr);
+size_t s21_workbook_recalc(workbook *book, int threads);
+int s21_workbook_get(const workbook *book, const char *name, double *value);
+void s21_clear_workbook(workbook *book);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // S21_WORKBOOK_H
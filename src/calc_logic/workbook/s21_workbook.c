@@ -0,0 +1,481 @@
+/**
+ * @file
+ * @brief Contains workbooks of named cells: a dependency graph of compiled
+ * expressions that recomputes only the cells downstream of a change
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/s21_workbook.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define WORKBOOK_FNV_OFFSET 2166136261u
+#define WORKBOOK_FNV_PRIME 16777619u
+
+/* The closed forms of s21_calc_annuity(), s21_calc_diff_month() and the
+ * deposit calculation, as functions every workbook can call. Rates are
+ * annual percents, terms are months for credits and years for deposits. */
+static const char *const s21_workbook_funcs[] = {
+    "annuity(amount,rate,term)=amount*rate/1200*(1+rate/1200)^term/"
+    "((1+rate/1200)^term-1)",
+    "overpayment(amount,rate,term)=annuity(amount,rate,term)*term-amount",
+    "diffpayment(amount,rate,term,month)=amount/term+"
+    "(amount-(month-1)*(amount/term))*rate/1200",
+    "capital(amount,rate,frequency,term)="
+    "amount*(1+rate/frequency/1200)^(frequency*term)-amount",
+    "interest(amount,rate,term)=amount*rate*(term*31/365)/100"};
+
+/**
+ * @brief Cells of one level of the graph evaluated by one thread.
+ */
+typedef struct workbook_chunk {
+  workbook *book;
+  const int *cells;
+  int count;
+} workbook_chunk;
+
+static uint32_t s21_workbook_hash(const char *name) {
+  uint32_t res = WORKBOOK_FNV_OFFSET;
+  for (; *name; name++) res = (res ^ (uint8_t)*name) * WORKBOOK_FNV_PRIME;
+  return res;
+}
+
+static int s21_workbook_find(const workbook *book, const char *name) {
+  int res = -1;
+  uint32_t mask = book->index_capacity - 1;
+  for (uint32_t i = s21_workbook_hash(name) & mask;
+       res < 0 && book->index_capacity && book->index[i] >= 0;
+       i = (i + 1) & mask) {
+    if (!strcmp(book->cells[book->index[i]].name, name)) res = book->index[i];
+  }
+  return res;
+}
+
+static void s21_workbook_insert(workbook *book, int cell) {
+  uint32_t mask = book->index_capacity - 1;
+  uint32_t i = s21_workbook_hash(book->cells[cell].name) & mask;
+  while (book->index[i] >= 0) i = (i + 1) & mask;
+  book->index[i] = cell;
+}
+
+static int s21_workbook_push(int **array, int *count, int *capacity,
+                             int value) {
+  if (*count == *capacity) {
+    int grown = *capacity ? 2 * *capacity : 4;
+    int *data = realloc(*array, grown * sizeof(int));
+    if (!data) return NULL_PTR;
+    *array = data;
+    *capacity = grown;
+  }
+  (*array)[(*count)++] = value;
+  return VALID_OK;
+}
+
+/**
+ * @brief Add a cell without an expression. The name index is kept at most
+ * half full.
+ *
+ * @return Index of the cell or -1 if memory can not be allocated.
+ */
+static int s21_workbook_add(workbook *book, const char *name) {
+  if (book->count == book->capacity) {
+    int grown = book->capacity ? 2 * book->capacity : 64;
+    workbook_cell *cells = realloc(book->cells, grown * sizeof(workbook_cell));
+    if (!cells) return -1;
+    book->cells = cells;
+    book->capacity = grown;
+  }
+  if (2 * (book->count + 1) > book->index_capacity) {
+    int grown = book->index_capacity ? 2 * book->index_capacity : 128;
+    int *index = malloc(grown * sizeof(int));
+    if (!index) return -1;
+    free(book->index);
+    book->index = index;
+    book->index_capacity = grown;
+    memset(index, -1, grown * sizeof(int));
+    for (int i = 0; i < book->count; i++) s21_workbook_insert(book, i);
+  }
+
+  workbook_cell *cell = &book->cells[book->count];
+  memset(cell, 0, sizeof(workbook_cell));
+  strcpy(cell->name, name);
+  cell->compile_status = UNKNOWN_FUNC;
+  cell->status = UNKNOWN_FUNC;
+  cell->value = NAN;
+  s21_workbook_insert(book, book->count);
+  return book->count++;
+}
+
+/**
+ * @brief Check that a name may be given to a cell: letters only, and not
+ * the variable, a built-in function or a function of the workbook.
+ */
+static int s21_workbook_name(const workbook *book, const char *name) {
+  char buffer[FUNC_NAME_SIZE] = {0};
+  int iter = 0;
+  if (strlen(name) >= FUNC_NAME_SIZE) return 0;
+  s21_read_funcs(name, &iter, buffer);
+  return buffer[0] && !name[iter] && strcmp(buffer, "x") &&
+         s21_init_functions(buffer).type == NO_TYPE &&
+         s21_find_func(book->registry, buffer) < 0;
+}
+
+/**
+ * @brief Queue a cell for the next recalculation.
+ */
+static int s21_workbook_touch(workbook *book, int cell) {
+  int res = VALID_OK;
+  if (!book->cells[cell].dirty) {
+    res = s21_workbook_push(&book->changed, &book->changed_count,
+                            &book->changed_capacity, cell);
+    if (res == VALID_OK) book->cells[cell].dirty = 1;
+  }
+  return res;
+}
+
+/**
+ * @brief Remove a cell from the users of the cells it reads.
+ */
+static void s21_workbook_unlink(workbook *book, int index) {
+  workbook_cell *cell = &book->cells[index];
+  for (int i = 0; i < cell->refs_count; i++) {
+    workbook_cell *ref = &book->cells[cell->refs[i]];
+    for (int j = 0; j < ref->users_count; j++) {
+      if (ref->users[j] == index) {
+        ref->users[j] = ref->users[--ref->users_count];
+        break;
+      }
+    }
+  }
+  free(cell->refs);
+  cell->refs = NULL;
+  cell->refs_count = 0;
+}
+
+/**
+ * @brief Find the cells an expression reads, creating the ones that are not
+ * defined yet. Every name that is not a function is a cell.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_workbook_scan(workbook *book, const char *expr, int *refs,
+                             char (*params)[FUNC_NAME_SIZE], int *count) {
+  int res = VALID_OK;
+  for (int iter = 0; res == VALID_OK && expr[iter];) {
+    if (expr[iter] < 'a' || expr[iter] > 'z') {
+      iter++;
+      continue;
+    }
+    char name[FUNC_MAX_LEN + 1] = {0};
+    s21_read_funcs(expr, &iter, name);
+    if (s21_init_functions(name).type != NO_TYPE ||
+        s21_find_func(book->registry, name) >= 0) {
+      continue;
+    }
+
+    int ref = -1;
+    if (!strcmp(name, "x") || strlen(name) >= FUNC_NAME_SIZE) {
+      res = INVALID_EXPRESSION;
+    } else {
+      ref = s21_workbook_find(book, name);
+      if (ref < 0) ref = s21_workbook_add(book, name);
+      if (ref < 0) res = NULL_PTR;
+    }
+    int known = 0;
+    for (int i = 0; res == VALID_OK && i < *count; i++) known |= refs[i] == ref;
+    if (res == VALID_OK && !known && *count == WORKBOOK_MAX_REFS) {
+      res = STR_OVERFLOW;
+    } else if (res == VALID_OK && !known) {
+      refs[*count] = ref;
+      strcpy(params[(*count)++], name);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Compile the expression of a cell with the cells it reads as
+ * parameters and link it into the graph.
+ *
+ * @return VALID_OK or a validation error code.
+ */
+static int s21_workbook_compile(workbook *book, int index) {
+  int refs[WORKBOOK_MAX_REFS];
+  char params[WORKBOOK_MAX_REFS][FUNC_NAME_SIZE];
+  int count = 0;
+  int res = s21_workbook_scan(book, book->cells[index].expr, refs, params,
+                              &count);
+
+  s21_workbook_unlink(book, index);
+  workbook_cell *cell = &book->cells[index];
+  s21_clear_compiled(&cell->program);
+  if (res == VALID_OK && count) {
+    cell->refs = malloc(count * sizeof(int));
+    if (!cell->refs) res = NULL_PTR;
+  }
+  for (int i = 0; res == VALID_OK && i < count; i++) {
+    workbook_cell *ref = &book->cells[refs[i]];
+    res = s21_workbook_push(&ref->users, &ref->users_count,
+                            &ref->users_capacity, index);
+    if (res == VALID_OK) cell->refs[cell->refs_count++] = refs[i];
+  }
+  if (res == VALID_OK) {
+    res = s21_compile_body(cell->expr, book->registry,
+                           (const char(*)[FUNC_NAME_SIZE])params, count,
+                           &cell->program);
+  }
+  cell->compile_status = res;
+  return res;
+}
+
+/**
+ * @brief Create a workbook with the credit and deposit functions: annuity,
+ * overpayment, diffpayment, capital and interest.
+ *
+ * @return The workbook, to be freed with s21_clear_workbook(), or NULL.
+ */
+workbook *s21_create_workbook(void) {
+  workbook *book = calloc(1, sizeof(workbook));
+  if (book) book->registry = s21_create_registry();
+  if (book && !book->registry) {
+    free(book);
+    book = NULL;
+  }
+  int count = sizeof(s21_workbook_funcs) / sizeof(s21_workbook_funcs[0]);
+  for (int i = 0; book && i < count; i++) {
+    s21_define_func(book->registry, s21_workbook_funcs[i]);
+  }
+  return book;
+}
+
+/**
+ * @brief Define or redefine a function cells may call, e.g.
+ * "margin(a,b)=(a-b)/a". Every cell is compiled again.
+ *
+ * @param book The workbook.
+ * @param definition The definition, see s21_define_func().
+ * @return Status of the function, or INVALID_EXPRESSION if a cell already
+ * has its name.
+ */
+int s21_workbook_func(workbook *book, const char *definition) {
+  if (!book || !definition) return NULL_PTR;
+  if (strlen(definition) > FUNC_MAX_LEN) return STR_OVERFLOW;
+
+  char name[FUNC_MAX_LEN + 1] = {0};
+  int iter = 0;
+  while (definition[iter] == ' ') iter++;
+  s21_read_funcs(definition, &iter, name);
+  if (s21_workbook_find(book, name) >= 0) return INVALID_EXPRESSION;
+
+  uint32_t generation = book->registry->generation;
+  int res = s21_define_func(book->registry, definition);
+  for (int i = 0; generation != book->registry->generation && i < book->count;
+       i++) {
+    if (book->cells[i].expr) {
+      s21_workbook_compile(book, i);
+      s21_workbook_touch(book, i);
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Set the expression of a cell, e.g. "annuity(amount, rate, term)".
+ * Names of other cells may be used before they are defined. The cell and
+ * everything that reads it are recomputed by the next
+ * s21_workbook_recalc().
+ *
+ * @param book The workbook.
+ * @param name Name of the cell, letters only, shorter than FUNC_NAME_SIZE.
+ * @param expr The expression, at most FUNC_MAX_LEN characters.
+ * @return VALID_OK or the error of the expression, which the cell then
+ * reports; INVALID_EXPRESSION without changes for an invalid name.
+ */
+int s21_workbook_set(workbook *book, const char *name, const char *expr) {
+  if (!book || !name || !expr) return NULL_PTR;
+  if (strlen(expr) > FUNC_MAX_LEN) return STR_OVERFLOW;
+  if (!s21_workbook_name(book, name)) return INVALID_EXPRESSION;
+
+  int index = s21_workbook_find(book, name);
+  if (index < 0) index = s21_workbook_add(book, name);
+  char *copy = malloc(strlen(expr) + 1);
+  if (index < 0 || !copy) {
+    free(copy);
+    return NULL_PTR;
+  }
+  strcpy(copy, expr);
+  free(book->cells[index].expr);
+  book->cells[index].expr = copy;
+
+  int res = s21_workbook_compile(book, index);
+  int touched = s21_workbook_touch(book, index);
+  return res == VALID_OK ? touched : res;
+}
+
+/**
+ * @brief Evaluate a cell whose inputs are up to date. An error of an input
+ * becomes the status of the cell.
+ */
+static void s21_workbook_eval(workbook *book, int index) {
+  workbook_cell *cell = &book->cells[index];
+  double params[cell->refs_count + 1];
+  int status = cell->compile_status;
+  for (int i = 0; status == VALID_OK && i < cell->refs_count; i++) {
+    const workbook_cell *ref = &book->cells[cell->refs[i]];
+    status = ref->status;
+    params[i] = ref->value;
+  }
+  cell->status = status;
+  cell->value = status == VALID_OK
+                    ? s21_eval_compiled_with(&cell->program, 0, params)
+                    : NAN;
+}
+
+static void *s21_workbook_eval_chunk(void *arg) {
+  workbook_chunk *chunk = arg;
+  for (int i = 0; i < chunk->count; i++) {
+    s21_workbook_eval(chunk->book, chunk->cells[i]);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Evaluate cells that do not read each other, split between threads
+ * when there are at least WORKBOOK_PARALLEL_MIN of them per thread.
+ */
+static void s21_workbook_eval_level(workbook *book, const int *cells,
+                                    int count, int threads) {
+  if (threads > count / WORKBOOK_PARALLEL_MIN) {
+    threads = count / WORKBOOK_PARALLEL_MIN;
+  }
+  if (threads < 1) threads = 1;
+
+  workbook_chunk chunks[threads];
+  pthread_t ids[threads];
+  int created[threads];
+  for (int i = 0; i < threads; i++) {
+    int begin = (int)((long)count * i / threads);
+    int end = (int)((long)count * (i + 1) / threads);
+    chunks[i] = (workbook_chunk){book, cells + begin, end - begin};
+  }
+  for (int i = 1; i < threads; i++) {
+    created[i] = !pthread_create(&ids[i], NULL, s21_workbook_eval_chunk,
+                                 &chunks[i]);
+  }
+  s21_workbook_eval_chunk(&chunks[0]);
+  for (int i = 1; i < threads; i++) {
+    if (created[i]) {
+      pthread_join(ids[i], NULL);
+    } else {
+      s21_workbook_eval_chunk(&chunks[i]);
+    }
+  }
+}
+
+/**
+ * @brief Recompute the changed cells and the cells downstream of them, level
+ * by level in topological order. A level holds cells whose inputs are all
+ * computed, so its cells are evaluated in parallel. Cells left over belong
+ * to or read a cycle and get RECURSIVE_FUNC.
+ *
+ * @param book The workbook.
+ * @param threads Maximum number of threads, <= 0 uses all cores.
+ * @return Number of recomputed cells, 0 if nothing changed or memory can
+ * not be allocated, in which case the changes stay queued.
+ */
+size_t s21_workbook_recalc(workbook *book, int threads) {
+  if (!book || !book->changed_count) return 0;
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int *order = malloc(2 * (size_t)book->count * sizeof(int));
+  if (!order) return 0;
+  int *queue = order + book->count;
+  workbook_cell *cells = book->cells;
+
+  int dirty = book->changed_count;
+  memcpy(order, book->changed, dirty * sizeof(int));
+  for (int i = 0; i < dirty; i++) {
+    const workbook_cell *cell = &cells[order[i]];
+    for (int j = 0; j < cell->users_count; j++) {
+      if (!cells[cell->users[j]].dirty) {
+        cells[cell->users[j]].dirty = 1;
+        order[dirty++] = cell->users[j];
+      }
+    }
+  }
+
+  int tail = 0;
+  for (int i = 0; i < dirty; i++) {
+    workbook_cell *cell = &cells[order[i]];
+    for (int j = 0; j < cell->refs_count; j++) {
+      cell->pending += cells[cell->refs[j]].dirty;
+    }
+    if (!cell->pending) queue[tail++] = order[i];
+  }
+  for (int head = 0; head < tail;) {
+    int level_end = tail;
+    s21_workbook_eval_level(book, queue + head, level_end - head, threads);
+    for (; head < level_end; head++) {
+      const workbook_cell *cell = &cells[queue[head]];
+      for (int j = 0; j < cell->users_count; j++) {
+        workbook_cell *user = &cells[cell->users[j]];
+        if (user->dirty && !--user->pending) queue[tail++] = cell->users[j];
+      }
+    }
+  }
+
+  for (int i = 0; i < dirty; i++) {
+    workbook_cell *cell = &cells[order[i]];
+    if (cell->pending) {
+      cell->status = RECURSIVE_FUNC;
+      cell->value = NAN;
+    }
+    cell->pending = 0;
+    cell->dirty = 0;
+  }
+  book->changed_count = 0;
+  free(order);
+  return (size_t)dirty;
+}
+
+/**
+ * @brief Value of a cell as of the last s21_workbook_recalc().
+ *
+ * @param book The workbook.
+ * @param name Name of the cell.
+ * @param value Output for the value, NAN if the cell has an error.
+ * @return VALID_OK, UNKNOWN_FUNC if the cell or a cell it reads is not
+ * defined, RECURSIVE_FUNC if it is part of a cycle, or the error of an
+ * expression.
+ */
+int s21_workbook_get(const workbook *book, const char *name, double *value) {
+  if (!book || !name || !value) return NULL_PTR;
+  int index = s21_workbook_find(book, name);
+  *value = index >= 0 ? book->cells[index].value : NAN;
+  return index >= 0 ? book->cells[index].status : UNKNOWN_FUNC;
+}
+
+/**
+ * @brief Free a workbook.
+ *
+ * @param book The workbook.
+ */
+void s21_clear_workbook(workbook *book) {
+  if (book) {
+    for (int i = 0; i < book->count; i++) {
+      workbook_cell *cell = &book->cells[i];
+      free(cell->expr);
+      s21_clear_compiled(&cell->program);
+      free(cell->refs);
+      free(cell->users);
+    }
+    free(book->cells);
+    free(book->index);
+    free(book->changed);
+    s21_clear_registry(book->registry);
+    free(book);
+  }
+}
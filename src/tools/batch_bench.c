@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @brief Compares evaluating report formulas one by one with evaluating them
+ * as one batch with shared subexpressions
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../calc_logic/compiler/include/s21_expr_batch.h"
+
+#define BENCH_TERMS 4
+#define BENCH_KINDS 3
+
+static const int s21_terms[BENCH_TERMS] = {12, 24, 36, 60};
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Payment, total payment and deposit growth of an amount over a term
+ * as formulas of the rate x, all built around (1+x/1200)^n.
+ */
+static void s21_formula(char *expr, size_t size, int id) {
+  int amount = 10000 * (1 + id / (BENCH_TERMS * BENCH_KINDS));
+  int term = s21_terms[id / BENCH_KINDS % BENCH_TERMS];
+  int kind = id % BENCH_KINDS;
+  if (kind == 0) {
+    snprintf(expr, size, "%d*(x/1200)*(1+x/1200)^%d/((1+x/1200)^%d-1)",
+             amount, term, term);
+  } else if (kind == 1) {
+    snprintf(expr, size, "%d*(x/1200)*(1+x/1200)^%d/((1+x/1200)^%d-1)*%d",
+             amount, term, term, term);
+  } else {
+    snprintf(expr, size, "%d*(1+x/1200)^%d-%d", amount, term, amount);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int count = argc > 1 ? atoi(argv[1]) : 600;
+  size_t rows = argc > 2 ? (size_t)atol(argv[2]) : 10000;
+  if (count < 1 || !rows) {
+    fprintf(stderr, "usage: batch_bench [formulas] [rows]\n");
+    return EXIT_FAILURE;
+  }
+
+  char (*exprs)[128] = malloc(count * sizeof(*exprs));
+  const char **names = malloc(count * sizeof(char *));
+  compiled_expr *programs = calloc(count, sizeof(compiled_expr));
+  double *x = malloc(rows * sizeof(double));
+  double *y = malloc(count * rows * sizeof(double));
+  double *check = malloc(rows * sizeof(double));
+  int res = exprs && names && programs && x && y && check ? EXIT_SUCCESS
+                                                          : EXIT_FAILURE;
+  for (int i = 0; res == EXIT_SUCCESS && i < count; i++) {
+    s21_formula(exprs[i], sizeof(exprs[i]), i);
+    names[i] = exprs[i];
+    if (s21_compile_expr(exprs[i], &programs[i]) != VALID_OK) {
+      res = EXIT_FAILURE;
+    }
+  }
+  for (size_t i = 0; res == EXIT_SUCCESS && i < rows; i++) {
+    x[i] = 1 + 29.0 * i / rows;
+  }
+
+  compiled_batch batch = {0};
+  if (res == EXIT_SUCCESS &&
+      s21_compile_batch(names, count, &batch, NULL) != VALID_OK) {
+    res = EXIT_FAILURE;
+  }
+  if (res == EXIT_SUCCESS) {
+    printf("%d formulas: %ld instructions one by one, %d in the batch "
+           "(%.1f%% deduplicated), %d stack rows\n",
+           count, batch.instructions, batch.nodes_count,
+           100.0 * (1 - (double)batch.nodes_count / batch.instructions),
+           batch.slots);
+
+    double start = s21_now();
+    for (int i = 0; i < count; i++) {
+      s21_eval_compiled_batch(&programs[i], x, y + i * rows, rows);
+    }
+    double separate = s21_now() - start;
+    start = s21_now();
+    s21_eval_batch(&batch, x, y, rows);
+    double shared = s21_now() - start;
+    printf("one by one: %.1f ms, batch: %.1f ms, %.2fx\n", separate * 1e3,
+           shared * 1e3, separate / shared);
+
+    s21_eval_compiled_batch(&programs[count - 1], x, check, rows);
+    for (size_t i = 0; i < rows; i++) {
+      if (check[i] != y[(count - 1) * rows + i]) res = EXIT_FAILURE;
+    }
+  }
+
+  s21_clear_batch(&batch);
+  for (int i = 0; programs && i < count; i++) s21_clear_compiled(&programs[i]);
+  free(exprs);
+  free(names);
+  free(programs);
+  free(x);
+  free(y);
+  free(check);
+  return res;
+}
@@ -0,0 +1,454 @@
+/**
+ * @file
+ * @brief Serves expression, credit and deposit evaluation over a Unix socket
+ *
+ * One epoll thread accepts connections, reads pipelined requests and writes
+ * responses. Complete requests are cut into batches of up to DAEMON_BATCH
+ * frames and evaluated by a worker pool, so responses of one connection come
+ * back out of order and are matched by their ids.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../calc_logic/io/include/s21_protocol.h"
+
+#define DAEMON_BATCH 64
+#define DAEMON_READ 65536
+#define DAEMON_EVENTS 64
+#define DAEMON_MAX_JOBS 256
+
+typedef struct daemon_conn {
+  int fd;
+  uint32_t events;
+  pthread_mutex_t lock;
+  char *in;
+  size_t in_size;
+  size_t in_capacity;
+  char *out;
+  size_t out_size;
+  size_t out_capacity;
+  char *sending;
+  size_t sending_size;
+  size_t sending_capacity;
+  size_t sent;
+  int jobs;
+  int queued;
+  int eof;
+  int failed;
+  int lost;
+  int closed;
+  struct daemon_conn *next;
+} daemon_conn;
+
+typedef struct daemon_job {
+  daemon_conn *conn;
+  size_t size;
+  struct daemon_job *next;
+  char data[];
+} daemon_job;
+
+typedef struct daemon_state {
+  int epoll_fd;
+  int listen_fd;
+  int wake_fd;
+  pthread_mutex_t queue_lock;
+  pthread_cond_t queue_cond;
+  daemon_job *head;
+  daemon_job *tail;
+  int stop;
+  pthread_mutex_t ready_lock;
+  daemon_conn *ready;
+} daemon_state;
+
+static volatile sig_atomic_t s21_interrupted = 0;
+
+static void s21_on_signal(int sig) {
+  (void)sig;
+  s21_interrupted = 1;
+}
+
+/**
+ * @brief Grow a buffer to hold at least the given number of bytes.
+ */
+static int s21_reserve(char **buffer, size_t *capacity, size_t size) {
+  if (size <= *capacity) return 0;
+  size_t next = *capacity ? *capacity : DAEMON_READ;
+  while (next < size) next *= 2;
+  char *grown = realloc(*buffer, next);
+  if (!grown) return -1;
+  *buffer = grown;
+  *capacity = next;
+  return 0;
+}
+
+/**
+ * @brief Hand the results of a job back to the event loop. The connection is
+ * queued once until the loop picks it up, and the loop is the only thread
+ * that writes to sockets or frees connections.
+ */
+static void s21_deliver(daemon_state *state, daemon_conn *conn,
+                        const char *data, size_t size) {
+  int wake = 0;
+  pthread_mutex_lock(&conn->lock);
+  if (!s21_reserve(&conn->out, &conn->out_capacity, conn->out_size + size)) {
+    memcpy(conn->out + conn->out_size, data, size);
+    conn->out_size += size;
+  } else {
+    conn->lost = 1;
+  }
+  conn->jobs--;
+  if (!conn->queued) {
+    conn->queued = 1;
+    pthread_mutex_lock(&state->ready_lock);
+    conn->next = state->ready;
+    state->ready = conn;
+    pthread_mutex_unlock(&state->ready_lock);
+    wake = 1;
+  }
+  pthread_mutex_unlock(&conn->lock);
+
+  uint64_t one = 1;
+  if (wake && write(state->wake_fd, &one, sizeof(one)) < 0) {
+    perror("eventfd");
+  }
+}
+
+static void *s21_worker(void *arg) {
+  daemon_state *state = arg;
+  char *out = malloc(DAEMON_BATCH * PROTO_MAX_FRAME);
+  if (!out) return NULL;
+
+  for (;;) {
+    pthread_mutex_lock(&state->queue_lock);
+    while (!state->head && !state->stop) {
+      pthread_cond_wait(&state->queue_cond, &state->queue_lock);
+    }
+    daemon_job *job = state->head;
+    if (job) {
+      state->head = job->next;
+      if (!state->head) state->tail = NULL;
+    }
+    pthread_mutex_unlock(&state->queue_lock);
+    if (!job) break;
+
+    size_t size = 0;
+    proto_frame frame = {0};
+    for (size_t offset = 0; offset < job->size; offset += frame.size) {
+      s21_proto_next(job->data + offset, job->size - offset, &frame);
+      size += s21_proto_execute(&frame, out + size);
+    }
+    s21_deliver(state, job->conn, out, size);
+    free(job);
+  }
+  free(out);
+  return NULL;
+}
+
+static void s21_push_job(daemon_state *state, daemon_conn *conn,
+                         const char *data, size_t size) {
+  daemon_job *job = malloc(sizeof(daemon_job) + size);
+  if (!job) {
+    conn->failed = 1;
+    return;
+  }
+  job->conn = conn;
+  job->size = size;
+  job->next = NULL;
+  memcpy(job->data, data, size);
+
+  pthread_mutex_lock(&conn->lock);
+  conn->jobs++;
+  pthread_mutex_unlock(&conn->lock);
+
+  pthread_mutex_lock(&state->queue_lock);
+  if (state->tail) {
+    state->tail->next = job;
+  } else {
+    state->head = job;
+  }
+  state->tail = job;
+  pthread_cond_signal(&state->queue_cond);
+  pthread_mutex_unlock(&state->queue_lock);
+}
+
+/**
+ * @brief Cut the complete frames of the input buffer into jobs and keep the
+ * incomplete tail for the next read.
+ */
+static void s21_dispatch(daemon_state *state, daemon_conn *conn) {
+  size_t start = 0;
+  size_t offset = 0;
+  int frames = 0;
+  proto_frame frame = {0};
+  int res = PROTO_OK;
+  while (res == PROTO_OK && !conn->failed) {
+    res = s21_proto_next(conn->in + offset, conn->in_size - offset, &frame);
+    if (res == PROTO_OK) {
+      offset += frame.size;
+      if (++frames == DAEMON_BATCH) {
+        s21_push_job(state, conn, conn->in + start, offset - start);
+        start = offset;
+        frames = 0;
+      }
+    } else if (res == PROTO_ERROR) {
+      conn->failed = 1;
+    }
+  }
+  if (frames && !conn->failed) {
+    s21_push_job(state, conn, conn->in + start, offset - start);
+  }
+  memmove(conn->in, conn->in + offset, conn->in_size - offset);
+  conn->in_size -= offset;
+}
+
+static void s21_read_conn(daemon_state *state, daemon_conn *conn) {
+  for (;;) {
+    if (s21_reserve(&conn->in, &conn->in_capacity,
+                    conn->in_size + DAEMON_READ)) {
+      conn->failed = 1;
+      break;
+    }
+    ssize_t done = read(conn->fd, conn->in + conn->in_size, DAEMON_READ);
+    if (done > 0) {
+      conn->in_size += done;
+    } else if (done < 0 && errno == EINTR) {
+      continue;
+    } else {
+      if (!done) {
+        conn->eof = 1;
+      } else if (errno != EAGAIN) {
+        conn->failed = 1;
+      }
+      break;
+    }
+  }
+  s21_dispatch(state, conn);
+}
+
+/**
+ * @brief Move the results the workers delivered to the sending buffer.
+ */
+static void s21_collect(daemon_conn *conn) {
+  pthread_mutex_lock(&conn->lock);
+  conn->queued = 0;
+  if (conn->lost) conn->failed = 1;
+  if (!s21_reserve(&conn->sending, &conn->sending_capacity,
+                   conn->sending_size + conn->out_size)) {
+    memcpy(conn->sending + conn->sending_size, conn->out, conn->out_size);
+    conn->sending_size += conn->out_size;
+  } else {
+    conn->failed = 1;
+  }
+  conn->out_size = 0;
+  pthread_mutex_unlock(&conn->lock);
+}
+
+static void s21_flush(daemon_conn *conn) {
+  while (conn->sent < conn->sending_size && !conn->failed) {
+    ssize_t done = send(conn->fd, conn->sending + conn->sent,
+                        conn->sending_size - conn->sent, MSG_NOSIGNAL);
+    if (done > 0) {
+      conn->sent += done;
+    } else if (errno == EAGAIN) {
+      break;
+    } else if (errno != EINTR) {
+      conn->failed = 1;
+    }
+  }
+  if (conn->sent == conn->sending_size) {
+    conn->sent = 0;
+    conn->sending_size = 0;
+  }
+}
+
+/**
+ * @brief Update the events the loop waits for and close the connection once
+ * the client is gone and no job refers to it. Closed connections are freed
+ * after the current batch of events.
+ */
+static void s21_update_conn(daemon_state *state, daemon_conn *conn,
+                            daemon_conn **closed) {
+  pthread_mutex_lock(&conn->lock);
+  int jobs = conn->jobs;
+  int queued = conn->queued;
+  pthread_mutex_unlock(&conn->lock);
+
+  int pending = conn->sending_size > 0 && !conn->failed;
+  if ((conn->eof || conn->failed) && !jobs && !queued && !pending) {
+    epoll_ctl(state->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->closed = 1;
+    conn->next = *closed;
+    *closed = conn;
+  } else {
+    uint32_t events = 0;
+    if (!conn->eof && !conn->failed && jobs < DAEMON_MAX_JOBS) {
+      events |= EPOLLIN;
+    }
+    if (pending) events |= EPOLLOUT;
+    if (events != conn->events) {
+      struct epoll_event event = {events, {.ptr = conn}};
+      epoll_ctl(state->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+      conn->events = events;
+    }
+  }
+}
+
+static void s21_accept(daemon_state *state) {
+  int fd = -1;
+  while ((fd = accept4(state->listen_fd, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+    daemon_conn *conn = calloc(1, sizeof(daemon_conn));
+    struct epoll_event event = {EPOLLIN, {.ptr = conn}};
+    if (!conn || epoll_ctl(state->epoll_fd, EPOLL_CTL_ADD, fd, &event)) {
+      free(conn);
+      close(fd);
+    } else {
+      conn->fd = fd;
+      conn->events = EPOLLIN;
+      pthread_mutex_init(&conn->lock, NULL);
+    }
+  }
+}
+
+static void s21_free_conn(daemon_conn *conn) {
+  pthread_mutex_destroy(&conn->lock);
+  free(conn->in);
+  free(conn->out);
+  free(conn->sending);
+  free(conn);
+}
+
+static void s21_run_loop(daemon_state *state) {
+  struct epoll_event events[DAEMON_EVENTS];
+  while (!s21_interrupted) {
+    int count = epoll_wait(state->epoll_fd, events, DAEMON_EVENTS, -1);
+    daemon_conn *closed = NULL;
+    for (int i = 0; i < count; i++) {
+      if (events[i].data.ptr == &state->listen_fd) {
+        s21_accept(state);
+      } else if (events[i].data.ptr == &state->wake_fd) {
+        uint64_t value = 0;
+        if (read(state->wake_fd, &value, sizeof(value)) < 0) continue;
+        pthread_mutex_lock(&state->ready_lock);
+        daemon_conn *ready = state->ready;
+        state->ready = NULL;
+        pthread_mutex_unlock(&state->ready_lock);
+        while (ready) {
+          daemon_conn *conn = ready;
+          ready = conn->next;
+          s21_collect(conn);
+          s21_flush(conn);
+          s21_update_conn(state, conn, &closed);
+        }
+      } else {
+        daemon_conn *conn = events[i].data.ptr;
+        if (conn->closed) continue;
+        if (!conn->eof && !conn->failed &&
+            events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+          s21_read_conn(state, conn);
+        }
+        if (events[i].events & EPOLLOUT) s21_flush(conn);
+        s21_update_conn(state, conn, &closed);
+      }
+    }
+    while (closed) {
+      daemon_conn *conn = closed;
+      closed = conn->next;
+      s21_free_conn(conn);
+    }
+  }
+}
+
+static int s21_listen(const char *path) {
+  struct sockaddr_un addr = {0};
+  if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  unlink(path);
+  if (fd >= 0 && (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+                  listen(fd, SOMAXCONN))) {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <socket> [workers]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  long workers = argc > 2 ? atol(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  if (workers < 1) workers = 1;
+
+  struct sigaction action = {0};
+  action.sa_handler = s21_on_signal;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  daemon_state state = {0};
+  pthread_mutex_init(&state.queue_lock, NULL);
+  pthread_cond_init(&state.queue_cond, NULL);
+  pthread_mutex_init(&state.ready_lock, NULL);
+  state.listen_fd = s21_listen(argv[1]);
+  state.wake_fd = eventfd(0, EFD_NONBLOCK);
+  state.epoll_fd = epoll_create1(0);
+  struct epoll_event listen_event = {EPOLLIN, {.ptr = &state.listen_fd}};
+  struct epoll_event wake_event = {EPOLLIN, {.ptr = &state.wake_fd}};
+  if (state.listen_fd < 0 || state.wake_fd < 0 || state.epoll_fd < 0 ||
+      epoll_ctl(state.epoll_fd, EPOLL_CTL_ADD, state.listen_fd,
+                &listen_event) ||
+      epoll_ctl(state.epoll_fd, EPOLL_CTL_ADD, state.wake_fd, &wake_event)) {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  pthread_t *threads = calloc(workers, sizeof(pthread_t));
+  if (!threads) return EXIT_FAILURE;
+  for (long i = 0; i < workers; i++) {
+    pthread_create(&threads[i], NULL, s21_worker, &state);
+  }
+  printf("listening on %s with %ld workers\n", argv[1], workers);
+  fflush(stdout);
+
+  s21_run_loop(&state);
+
+  pthread_mutex_lock(&state.queue_lock);
+  state.stop = 1;
+  pthread_cond_broadcast(&state.queue_cond);
+  pthread_mutex_unlock(&state.queue_lock);
+  for (long i = 0; i < workers; i++) pthread_join(threads[i], NULL);
+  free(threads);
+  close(state.epoll_fd);
+  close(state.wake_fd);
+  close(state.listen_fd);
+  unlink(argv[1]);
+  return EXIT_SUCCESS;
+}
+
+#else
+
+int main(void) {
+  fprintf(stderr, "calc_daemon needs epoll and runs on Linux only\n");
+  return EXIT_FAILURE;
+}
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @brief Load generator for calc_daemon: pipelines batches of requests over
+ * several connections and reports throughput and latency percentiles
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../calc_logic/io/include/s21_protocol.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct load_client {
+  const char *path;
+  int depth;
+  long rounds;
+  double *latency;
+  long received;
+  long reordered;
+  long bad;
+} load_client;
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int s21_by_value(const void *a, const void *b) {
+  double diff = *(const double *)a - *(const double *)b;
+  return (diff > 0) - (diff < 0);
+}
+
+static int s21_connect(const char *path) {
+  struct sockaddr_un addr = {0};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+/**
+ * @brief Encode a request of the mix: mostly expressions, every eighth
+ * request is a credit and every eighth a deposit.
+ */
+static size_t s21_encode_request(char *buffer, uint32_t id) {
+  size_t res = 0;
+  if (id % 8 == 0) {
+    proto_credit credit = {100000 + id % 1000, 12 + id % 100, 7, id % 2, 0};
+    res = s21_proto_credit(buffer, PROTO_MAX_FRAME, id, credit);
+  } else if (id % 8 == 1) {
+    proto_deposit deposit = {100000, 12, 8, 13, 1, id % 500, 0, 1, 0};
+    res = s21_proto_deposit(buffer, PROTO_MAX_FRAME, id, deposit);
+  } else {
+    char expr[PROTO_MAX_EXPR + 1];
+    snprintf(expr, sizeof(expr), "sin(%u)*2^(1/3)+sqrt(%u.5)/(1+cos(%u))",
+             id % 360, id % 1000, id % 90);
+    res = s21_proto_expr(buffer, PROTO_MAX_FRAME, id, expr);
+  }
+  return res;
+}
+
+static int s21_write_all(int fd, const char *data, size_t size) {
+  while (size) {
+    ssize_t done = send(fd, data, size, MSG_NOSIGNAL);
+    if (done <= 0) return -1;
+    data += done;
+    size -= done;
+  }
+  return 0;
+}
+
+/**
+ * @brief Send a batch of depth requests and wait for all of its responses.
+ * Latency of a request is the time from sending its batch to receiving its
+ * response.
+ */
+static int s21_round(load_client *client, int fd, char *out, char *in,
+                     uint32_t first) {
+  size_t size = 0;
+  for (int i = 0; i < client->depth; i++) {
+    size += s21_encode_request(out + size, first + i);
+  }
+  double start = s21_now();
+  if (s21_write_all(fd, out, size)) return -1;
+
+  size_t filled = 0;
+  uint32_t expected = first;
+  for (int left = client->depth; left > 0;) {
+    ssize_t done = read(fd, in + filled, PROTO_MAX_FRAME * client->depth);
+    if (done <= 0) return -1;
+    filled += done;
+
+    size_t offset = 0;
+    proto_frame frame = {0};
+    while (s21_proto_next(in + offset, filled - offset, &frame) == PROTO_OK) {
+      double now = s21_now();
+      client->latency[client->received++] = now - start;
+      if (frame.header.id != expected++) client->reordered++;
+      if (frame.header.status != PROTO_STATUS_OK) client->bad++;
+      offset += frame.size;
+      left--;
+    }
+    memmove(in, in + offset, filled - offset);
+    filled -= offset;
+  }
+  return 0;
+}
+
+static void *s21_client(void *arg) {
+  load_client *client = arg;
+  int fd = s21_connect(client->path);
+  char *out = malloc(PROTO_MAX_FRAME * client->depth);
+  char *in = malloc(2 * PROTO_MAX_FRAME * client->depth);
+  int res = fd >= 0 && out && in ? 0 : -1;
+  for (long i = 0; i < client->rounds && !res; i++) {
+    res = s21_round(client, fd, out, in, (uint32_t)(i * client->depth));
+  }
+  if (res) fprintf(stderr, "connection to %s failed\n", client->path);
+  if (fd >= 0) close(fd);
+  free(out);
+  free(in);
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <socket> [connections] [depth] [requests]\n",
+            argv[0]);
+    return EXIT_FAILURE;
+  }
+  int connections = argc > 2 ? atoi(argv[2]) : 4;
+  int depth = argc > 3 ? atoi(argv[3]) : 64;
+  long requests = argc > 4 ? atol(argv[4]) : 1000000;
+  if (connections < 1 || depth < 1) return EXIT_FAILURE;
+  long rounds = requests / connections / depth;
+  if (rounds < 1) rounds = 1;
+
+  load_client *clients = calloc(connections, sizeof(load_client));
+  pthread_t *threads = calloc(connections, sizeof(pthread_t));
+  double *latency = malloc(connections * rounds * depth * sizeof(double));
+  if (!clients || !threads || !latency) return EXIT_FAILURE;
+
+  double start = s21_now();
+  for (int i = 0; i < connections; i++) {
+    clients[i] = (load_client){argv[1], depth, rounds,
+                               latency + i * rounds * depth, 0, 0, 0};
+    pthread_create(&threads[i], NULL, s21_client, &clients[i]);
+  }
+  long received = 0;
+  long reordered = 0;
+  long bad = 0;
+  for (int i = 0; i < connections; i++) {
+    pthread_join(threads[i], NULL);
+    memmove(latency + received, clients[i].latency,
+            clients[i].received * sizeof(double));
+    received += clients[i].received;
+    reordered += clients[i].reordered;
+    bad += clients[i].bad;
+  }
+  double elapsed = s21_now() - start;
+
+  qsort(latency, received, sizeof(double), s21_by_value);
+  printf("requests: %ld in %.3f s, %.0f req/s\n", received, elapsed,
+         received / elapsed);
+  if (received) {
+    printf("latency ms: p50 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+           latency[received / 2] * 1e3, latency[received * 99 / 100] * 1e3,
+           latency[received * 999 / 1000] * 1e3, latency[received - 1] * 1e3);
+  }
+  printf("out of order: %ld, bad requests: %ld\n", reordered, bad);
+
+  free(latency);
+  free(threads);
+  free(clients);
+  return received == connections * rounds * depth ? EXIT_SUCCESS
+                                                   : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Runs s21_calc_eval() on all cores and checks every result against a
+ * single-threaded reference, then compares throughput with s21_smart_calc()
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../calc_logic/s21_calc.h"
+
+#define STRESS_EXPRS 8
+
+static const char *const s21_exprs[STRESS_EXPRS] = {
+    "2+2*2",
+    "3*(3*(4-2*5/3)+2*3/4)*cos(5)/3",
+    "sin(1)^2+cos(1)^2",
+    "sqrt(16)+ln(100)*log(2.718281828)",
+    "(2+3))",
+    "privet(33)",
+    "1569325041+0",
+    "atan(1)*4-acos(-1)+asin(0.5)*tan(0.3)",
+};
+
+typedef struct stress_worker {
+  long rounds;
+  const long double *expected;
+  const int *status;
+  long mismatches;
+} stress_worker;
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *s21_stress(void *arg) {
+  stress_worker *worker = arg;
+  for (long i = 0; i < worker->rounds; i++) {
+    int e = i % STRESS_EXPRS;
+    long double res = 0;
+    int status = s21_calc_eval(s21_exprs[e], &res);
+    if (status != worker->status[e] ||
+        (status == VALID_OK && res != worker->expected[e])) {
+      worker->mismatches++;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Evaluate the corpus in a loop through the in-band API, the way
+ * callers did before s21_calc_eval().
+ *
+ * @return Number of results that look like errors.
+ */
+static long s21_legacy(long rounds) {
+  long errors = 0;
+  for (long i = 0; i < rounds; i++) {
+    long double res = s21_smart_calc(s21_exprs[i % STRESS_EXPRS]);
+    errors += res == BRACKETS_NOT_MATCH || res == INVALID_EXPRESSION ||
+              res == UNKNOWN_FUNC;
+  }
+  return errors;
+}
+
+/**
+ * @return Number of failed evaluations.
+ */
+static long s21_explicit(long rounds) {
+  long errors = 0;
+  for (long i = 0; i < rounds; i++) {
+    long double res = 0;
+    errors += s21_calc_eval(s21_exprs[i % STRESS_EXPRS], &res) != VALID_OK;
+  }
+  return errors;
+}
+
+int main(int argc, char *argv[]) {
+  long threads = argc > 1 ? atol(argv[1]) : 0;
+  long rounds = argc > 2 ? atol(argv[2]) : 200000;
+  if (threads < 1) threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (rounds < 1) return EXIT_FAILURE;
+
+  long double expected[STRESS_EXPRS] = {0};
+  int status[STRESS_EXPRS] = {0};
+  for (int e = 0; e < STRESS_EXPRS; e++) {
+    status[e] = s21_calc_eval(s21_exprs[e], &expected[e]);
+  }
+
+  stress_worker *workers = calloc(threads, sizeof(stress_worker));
+  pthread_t *ids = calloc(threads, sizeof(pthread_t));
+  if (!workers || !ids) return EXIT_FAILURE;
+  double start = s21_now();
+  for (long i = 0; i < threads; i++) {
+    workers[i] = (stress_worker){rounds, expected, status, 0};
+    pthread_create(&ids[i], NULL, s21_stress, &workers[i]);
+  }
+  long mismatches = 0;
+  for (long i = 0; i < threads; i++) {
+    pthread_join(ids[i], NULL);
+    mismatches += workers[i].mismatches;
+  }
+  double parallel = s21_now() - start;
+
+  start = s21_now();
+  long legacy_errors = s21_legacy(rounds);
+  double legacy = s21_now() - start;
+  start = s21_now();
+  long explicit_errors = s21_explicit(rounds);
+  double explicit = s21_now() - start;
+
+  printf("threads: %ld, evaluations: %ld, mismatches: %ld\n", threads,
+         threads * rounds, mismatches);
+  printf("parallel: %.0f eval/s\n", threads * rounds / parallel);
+  printf("single thread: s21_smart_calc %.0f eval/s, s21_calc_eval %.0f "
+         "eval/s\n",
+         rounds / legacy, rounds / explicit);
+  printf("errors seen: in-band %ld, explicit %ld\n", legacy_errors,
+         explicit_errors);
+
+  free(ids);
+  free(workers);
+  return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
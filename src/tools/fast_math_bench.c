@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Measures the fast-math approximations against libm called through
+ * the function table, and a compiled program with and without them
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../calc_logic/compiler/include/s21_compiler.h"
+#include "../calc_logic/compiler/include/s21_fast_math.h"
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Arguments inside the domain of each function of the function table, in
+ * a scrambled order as Monte Carlo draws them. */
+static double s21_bench_arg(int func, size_t i, size_t count) {
+  double t = (i * 2654435761u % count + 0.5) / count;
+  const char *name = s21_compiled_func_name(func);
+  double res = 1e3 * (2 * t - 1);
+  if (!strcmp(name, "acos") || !strcmp(name, "asin")) {
+    res = 2 * t - 1;
+  } else if (!strcmp(name, "sqrt") || !strcmp(name, "ln") ||
+             !strcmp(name, "log")) {
+    res = 1e6 * t;
+  }
+  return res;
+}
+
+/* Largest error of the approximations in ulps of the libm result. */
+static double s21_bench_ulps(const double *fast, const double *libm,
+                             size_t count) {
+  double res = 0;
+  for (size_t i = 0; i < count; i++) {
+    double ulp = nextafter(fabs(libm[i]), INFINITY) - fabs(libm[i]);
+    double err = fabs(fast[i] - libm[i]) / ulp;
+    if (err > res) res = err;
+  }
+  return res;
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+  int rounds = argc > 2 ? atoi(argv[2]) : 10;
+  double *x = malloc(3 * (count ? count : 1) * sizeof(double));
+  if (!count || rounds < 1 || !x) {
+    fprintf(stderr, "usage: fast_math_bench [values] [rounds]\n");
+    return EXIT_FAILURE;
+  }
+  double *libm = x + count;
+  double *fast = libm + count;
+
+  printf("%-6s %10s %10s %8s %10s\n", "func", "libm ns", "fast ns", "speedup",
+         "max ulps");
+  for (int func = 0; func < EXPR_FUNC_COUNT; func++) {
+    for (size_t i = 0; i < count; i++) x[i] = s21_bench_arg(func, i, count);
+    math_func_ptr math_func = s21_compiled_func(func);
+    double start = s21_now();
+    for (int r = 0; r < rounds; r++) {
+      for (size_t i = 0; i < count; i++) libm[i] = math_func(x[i]);
+    }
+    double slow = (s21_now() - start) / rounds;
+    start = s21_now();
+    for (int r = 0; r < rounds; r++) {
+      memcpy(fast, x, count * sizeof(double));
+      s21_fast_math_block(func, fast, count);
+    }
+    double quick = (s21_now() - start) / rounds;
+    printf("%-6s %10.2f %10.2f %8.2f %10.2f\n", s21_compiled_func_name(func),
+           slow * 1e9 / count, quick * 1e9 / count, slow / quick,
+           s21_bench_ulps(fast, libm, count));
+  }
+
+  compiled_expr compiled;
+  int res = s21_compile_expr("sin(x)*cos(x)+atan(x)/sqrt(log(x^2+1)+1)",
+                             &compiled);
+  for (size_t i = 0; res == VALID_OK && i < count; i++) {
+    x[i] = s21_bench_arg(0, i, count);
+  }
+  double seconds[2] = {0};
+  for (int mode = 0; res == VALID_OK && mode < 2; mode++) {
+    compiled.fast_math_ulps = mode ? FAST_MATH_ULPS_TAN : 0;
+    double start = s21_now();
+    for (int r = 0; res == VALID_OK && r < rounds; r++) {
+      res = s21_eval_compiled_batch(&compiled, x, mode ? fast : libm, count);
+    }
+    seconds[mode] = (s21_now() - start) / rounds;
+  }
+  double diff = 0;
+  for (size_t i = 0; res == VALID_OK && i < count; i++) {
+    double d = fabs(fast[i] - libm[i]) / fmax(1, fabs(libm[i]));
+    if (!(d <= diff)) diff = d;
+  }
+  if (res == VALID_OK) {
+    printf("program: libm %.1f ms, fast %.1f ms, largest difference %.3g\n",
+           seconds[0] * 1e3, seconds[1] * 1e3, diff);
+    s21_clear_compiled(&compiled);
+  }
+  free(x);
+  return res == VALID_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file
+ * @brief Precompiles a file of formulas, one per line, into the mapped
+ * format and measures how fast it loads compared to parsing the text
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../calc_logic/io/include/s21_formula_file.h"
+
+static const char *const s21_parts[] = {
+    "sin(x)", "cos(x/2)", "x^2", "sqrt(x+4)", "ln(x+10)", "atan(x)*3",
+    "2.5",    "(x-1)",    "7",   "log(x*x+1)"};
+static const char s21_opers[] = "+-*/";
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int s21_usage(void) {
+  fprintf(stderr,
+          "usage: formula_pack gen <count> <formulas.txt>\n"
+          "       formula_pack compile <formulas.txt> <out.s21f>\n"
+          "       formula_pack load <file.s21f> [x]\n");
+  return EXIT_FAILURE;
+}
+
+static int s21_gen(long count, const char *path) {
+  FILE *out = fopen(path, "w");
+  if (!out || count < 1) return EXIT_FAILURE;
+  srand(42);
+  for (long i = 0; i < count; i++) {
+    int terms = 3 + rand() % 6;
+    for (int t = 0; t < terms; t++) {
+      if (t) fputc(s21_opers[rand() % 4], out);
+      fputs(s21_parts[rand() % 10], out);
+    }
+    fputc('\n', out);
+  }
+  return fclose(out) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int s21_compile_file(const char *in_path, const char *out_path) {
+  FILE *in = fopen(in_path, "r");
+  if (!in) return EXIT_FAILURE;
+
+  size_t count = 0;
+  size_t capacity = 1024;
+  compiled_expr *programs = malloc(capacity * sizeof(compiled_expr));
+  char *line = NULL;
+  size_t line_size = 0;
+  int res = programs ? EXIT_SUCCESS : EXIT_FAILURE;
+  double start = s21_now();
+  while (res == EXIT_SUCCESS && getline(&line, &line_size, in) > 0) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (count == capacity) {
+      compiled_expr *grown =
+          realloc(programs, 2 * capacity * sizeof(compiled_expr));
+      if (grown) {
+        programs = grown;
+        capacity *= 2;
+      } else {
+        res = EXIT_FAILURE;
+      }
+    }
+    int status = res == EXIT_SUCCESS
+                     ? s21_compile_expr(line, &programs[count])
+                     : NULL_PTR;
+    if (status == VALID_OK) {
+      count++;
+    } else {
+      fprintf(stderr, "line %zu: error %d\n", count + 1, status);
+      res = EXIT_FAILURE;
+    }
+  }
+  double parsed = s21_now() - start;
+  free(line);
+  fclose(in);
+
+  if (res == EXIT_SUCCESS) {
+    start = s21_now();
+    if (s21_formula_write(out_path, programs, (uint32_t)count) != FORMULA_OK) {
+      fprintf(stderr, "failed to write %s\n", out_path);
+      res = EXIT_FAILURE;
+    }
+    printf("parsed %zu formulas in %.1f ms, wrote them in %.1f ms\n", count,
+           parsed * 1e3, (s21_now() - start) * 1e3);
+  }
+  for (size_t i = 0; i < count; i++) s21_clear_compiled(&programs[i]);
+  free(programs);
+  return res;
+}
+
+static int s21_load_file(const char *path, double x) {
+  double start = s21_now();
+  formula_file file;
+  if (s21_formula_open(path, &file) != FORMULA_OK) {
+    fprintf(stderr, "failed to open %s\n", path);
+    return EXIT_FAILURE;
+  }
+  double opened = s21_now() - start;
+
+  start = s21_now();
+  double sum = 0;
+  uint32_t failed = 0;
+  for (uint32_t i = 0; i < file.count; i++) {
+    compiled_expr program;
+    if (s21_formula_get(&file, i, &program) == FORMULA_OK) {
+      double y = s21_eval_compiled(&program, x);
+      if (!isnan(y)) sum += y;
+    } else {
+      failed++;
+    }
+  }
+  double evaluated = s21_now() - start;
+  printf("opened %u formulas in %.1f ms, evaluated them in %.1f ms\n",
+         file.count, opened * 1e3, evaluated * 1e3);
+  printf("sum at x = %g: %.6g, invalid formulas: %u\n", x, sum, failed);
+  s21_formula_close(&file);
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  int res = EXIT_FAILURE;
+  if (argc == 4 && !strcmp(argv[1], "gen")) {
+    res = s21_gen(atol(argv[2]), argv[3]);
+  } else if (argc == 4 && !strcmp(argv[1], "compile")) {
+    res = s21_compile_file(argv[2], argv[3]);
+  } else if ((argc == 3 || argc == 4) && !strcmp(argv[1], "load")) {
+    res = s21_load_file(argv[2], argc == 4 ? atof(argv[3]) : 0.5);
+  } else {
+    res = s21_usage();
+  }
+  return res;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Loads a loan book CSV and runs batch credit calculation over it
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../calc_logic/bank_calc/include/s21_credit_calc.h"
+#include "../calc_logic/io/include/s21_columnar.h"
+#include "../calc_logic/io/include/s21_loan_book.h"
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Write a random loan book of the given size.
+ */
+static int s21_generate(const char *path, long rows) {
+  FILE *file = fopen(path, "w");
+  if (!file) return EXIT_FAILURE;
+
+  fputs("amount,term,rate,type\n", file);
+  srand(42);
+  for (long i = 0; i < rows; i++) {
+    fprintf(file, "%d.%02d,%d,%d.%d,%d\n", 10000 + rand() % 5000000,
+            rand() % 100, 1 + rand() % 119, 1 + rand() % 30, rand() % 10,
+            rand() % 2);
+  }
+  fclose(file);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 3 && !strcmp(argv[1], "generate")) {
+    return s21_generate(argv[2], strtol(argv[3], NULL, 10));
+  }
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <book.csv> [threads] [out.s21c]\n", argv[0]);
+    fprintf(stderr, "       %s generate <book.csv> <rows>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  loan_book book = {0};
+  double start = s21_now();
+  if (s21_load_loan_book(argv[1], threads, &book) != LOAN_BOOK_OK) {
+    fprintf(stderr, "failed to load %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  double loaded = s21_now();
+
+  double *out = malloc(3 * (book.count ? book.count : 1) * sizeof(double));
+  if (!out) return EXIT_FAILURE;
+  credit_batch batch = {book.count, book.amount,  book.term,
+                        book.rate,  book.type,    out,
+                        out + book.count, out + 2 * book.count};
+  s21_credit_calc_batch(batch);
+  double calculated = s21_now();
+
+  double overpayment = 0;
+  size_t errors = 0;
+  for (size_t i = 0; i < book.count; i++) {
+    if (batch.total_payment[i] == CREDIT_ERROR) {
+      errors++;
+    } else {
+      overpayment += batch.overpayment[i];
+    }
+  }
+
+  FILE *file = fopen(argv[1], "r");
+  long bytes = 0;
+  if (file && !fseek(file, 0, SEEK_END)) bytes = ftell(file);
+  if (file) fclose(file);
+
+  printf("rows: %zu, bad rows: %zu, invalid credits: %zu\n", book.count,
+         book.bad_rows, errors);
+  printf("load: %.3f s (%.1f MB/s), calc: %.3f s\n", loaded - start,
+         bytes / 1e6 / (loaded - start), calculated - loaded);
+  printf("total overpayment: %.2f\n", overpayment);
+
+  if (argc > 3) {
+    columnar_file saved = {0};
+    double write_start = s21_now();
+    int res = s21_columnar_write_credit_batch(argv[3], batch);
+    double written = s21_now();
+    if (res == COLUMNAR_OK) res = s21_columnar_open(argv[3], &saved);
+    if (res == COLUMNAR_OK) {
+      const double *col = s21_columnar_data(
+          &saved, s21_columnar_find(&saved, "overpayment"));
+      double check = 0;
+      for (size_t i = 0; i < saved.rows; i++) {
+        if (batch.total_payment[i] != CREDIT_ERROR) check += col[i];
+      }
+      printf("columnar write: %.3f s, reload and scan: %.3f s (%.2f)\n",
+             written - write_start, s21_now() - written, check);
+      s21_columnar_close(&saved);
+    } else {
+      fprintf(stderr, "failed to write %s\n", argv[3]);
+    }
+  }
+
+  free(out);
+  s21_clear_loan_book(&book);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief Measures Monte Carlo throughput scaling across cores
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../calc_logic/bank_calc/include/s21_monte_carlo.h"
+
+int main(int argc, char *argv[]) {
+  size_t paths = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+  int fast_math_ulps = argc > 2 ? atoi(argv[2]) : 0;
+  int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  mc_params params = {MC_CREDIT, 1000000, 120, {12, 9, 0.5, 2},
+                      42,        paths,   1,   fast_math_ulps};
+  double base = 0;
+
+  printf("%8s %10s %10s %14s %8s %12s %12s %12s\n", "threads", "paths",
+         "seconds", "paths/sec", "speedup", "P5", "P50", "P95");
+  for (int threads = 1; threads <= cores;) {
+    mc_result res = {0};
+    params.threads = threads;
+    if (s21_monte_carlo(params, &res) != MC_OK) return EXIT_FAILURE;
+    if (threads == 1) base = res.paths_per_sec;
+    printf("%8d %10zu %10.3f %14.0f %8.2f %12.2Lf %12.2Lf %12.2Lf\n",
+           res.threads, res.paths, res.seconds, res.paths_per_sec,
+           res.paths_per_sec / base, res.p5, res.p50, res.p95);
+    if (res.clamped) {
+      printf("%zu outcomes outside the sketch range\n", res.clamped);
+    }
+    threads = threads < cores && threads * 2 > cores ? cores : threads * 2;
+  }
+  return EXIT_SUCCESS;
+}
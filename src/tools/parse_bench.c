@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Times s21_calc_eval() on adversarial expression families of growing
+ * length and reports the cost per character, which stays flat for a linear
+ * parser
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../calc_logic/s21_calc.h"
+
+#define BENCH_MAX_LEN 255
+
+typedef struct bench_family {
+  const char *name;
+  const char *prefix;
+  const char *repeat;
+  const char *middle;
+  const char *closing;
+} bench_family;
+
+static const bench_family s21_families[] = {
+    {"sum chain", "1", "+1", "", ""},
+    {"mixed priority", "1", "+2*3^1", "", ""},
+    {"power chain", "1", "^1", "", ""},
+    {"nested brackets", "", "(", "1+1", ")"},
+    {"nested functions", "", "sin(", "1", ")"},
+    {"unary minus", "1", "-(-1)", "", ""},
+};
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Build an expression of the family not longer than max_len:
+ * prefix, n repeats, the middle and n closings.
+ */
+static size_t s21_build(const bench_family *family, size_t max_len,
+                        char *expr) {
+  size_t fixed = strlen(family->prefix) + strlen(family->middle);
+  size_t step = strlen(family->repeat) + strlen(family->closing);
+  size_t n = (max_len - fixed) / step;
+  strcpy(expr, family->prefix);
+  for (size_t i = 0; i < n; i++) strcat(expr, family->repeat);
+  strcat(expr, family->middle);
+  for (size_t i = 0; i < n; i++) strcat(expr, family->closing);
+  return strlen(expr);
+}
+
+int main(int argc, char *argv[]) {
+  long rounds = argc > 1 ? atol(argv[1]) : 20000;
+  if (rounds < 1) return EXIT_FAILURE;
+  const size_t lengths[] = {32, 64, 128, BENCH_MAX_LEN};
+  size_t families = sizeof(s21_families) / sizeof(s21_families[0]);
+
+  printf("%-18s", "ns per char");
+  for (size_t l = 0; l < 4; l++) printf("%8zu", lengths[l]);
+  printf("\n");
+  for (size_t f = 0; f < families; f++) {
+    printf("%-18s", s21_families[f].name);
+    for (size_t l = 0; l < 4; l++) {
+      char expr[BENCH_MAX_LEN + 1] = {0};
+      size_t len = s21_build(&s21_families[f], lengths[l], expr);
+      long double res = 0;
+      int status = VALID_OK;
+      double start = s21_now();
+      for (long i = 0; i < rounds; i++) status |= s21_calc_eval(expr, &res);
+      double elapsed = s21_now() - start;
+      if (status != VALID_OK) {
+        printf("%8s", "error");
+      } else {
+        printf("%8.1f", elapsed / rounds / len * 1e9);
+      }
+    }
+    printf("\n");
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @brief Measures batches of root finding against plain bisection
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../calc_logic/compiler/include/s21_roots.h"
+
+#define BENCH_BISECTIONS 64
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* The loop users drive by hand: halve the bracket until it stops shrinking. */
+static double s21_bisect(const compiled_expr *compiled, double a, double b) {
+  double fa = s21_eval_compiled(compiled, a);
+  for (int i = 0; i < BENCH_BISECTIONS; i++) {
+    double m = 0.5 * (a + b);
+    double fm = s21_eval_compiled(compiled, m);
+    if ((fm < 0) == (fa < 0)) {
+      a = m;
+      fa = fm;
+    } else {
+      b = m;
+    }
+  }
+  return 0.5 * (a + b);
+}
+
+int main(int argc, char *argv[]) {
+  int count = argc > 1 ? atoi(argv[1]) : 10000;
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  compiled_expr *programs = calloc(count > 0 ? count : 1, sizeof(*programs));
+  double *a = malloc((count > 0 ? count : 1) * 4 * sizeof(double));
+  if (count < 1 || !programs || !a) {
+    fprintf(stderr, "usage: roots_bench [problems] [threads]\n");
+    return EXIT_FAILURE;
+  }
+  double *b = a + count;
+  double *roots = b + count;
+  double *plain = roots + count;
+  int res = VALID_OK;
+  for (int i = 0; res == VALID_OK && i < count; i++) {
+    char expr[64] = {0};
+    snprintf(expr, sizeof(expr), "x^3-x*cos(x)-%d.5", i % 1000);
+    res = s21_compile_expr(expr, &programs[i]);
+    a[i] = 0;
+    b[i] = 20;
+  }
+
+  double start = s21_now();
+  if (res == VALID_OK) {
+    res = s21_solve_batch(programs, a, b, roots, count, threads);
+  }
+  double solve = s21_now() - start;
+
+  start = s21_now();
+  for (int i = 0; res == VALID_OK && i < count; i++) {
+    plain[i] = s21_bisect(&programs[i], a[i], b[i]);
+  }
+  double bisect = s21_now() - start;
+
+  double diff = 0;
+  for (int i = 0; res == VALID_OK && i < count; i++) {
+    double d = fabs(roots[i] - plain[i]) / fmax(1, fabs(plain[i]));
+    if (!(d <= diff)) diff = d;
+  }
+  printf("%d roots of x^3-x*cos(x)-c on [0, 20]\n", count);
+  printf("s21_solve_batch(): %.1f ms\n", solve * 1e3);
+  printf("bisection:         %.1f ms, largest difference %.3g\n",
+         bisect * 1e3, diff);
+  for (int i = 0; i < count; i++) s21_clear_compiled(&programs[i]);
+  free(programs);
+  free(a);
+  return res == VALID_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Measures sums of long series and their error against a plain loop
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../calc_logic/compiler/include/s21_aggregate.h"
+
+#define BENCH_ZETA2 1.6449340668482264365
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+  double terms = argc > 1 ? atof(argv[1]) : 1e8;
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  compiled_expr body;
+  if (terms < 1 || s21_compile_series("i", "1/i^2", &body) != VALID_OK) {
+    fprintf(stderr, "usage: series_bench [terms] [threads]\n");
+    return EXIT_FAILURE;
+  }
+
+  /* The exact tail of the series is close to 1/(terms + 1/2). */
+  double expected = BENCH_ZETA2 - 1 / (terms + 0.5);
+  double start = s21_now();
+  double sum = 0;
+  int res = s21_eval_series(&body, AGGREGATE_SUM, 1, terms, threads, NULL,
+                            &sum);
+  double series = s21_now() - start;
+
+  start = s21_now();
+  double plain = 0;
+  for (double i = 1; i <= terms; i++) plain += 1 / (i * i);
+  double loop = s21_now() - start;
+
+  printf("sum of 1/i^2 over %.0f terms\n", terms);
+  printf("sum():      %.17g, error %.3g, %.1f ms\n", sum, sum - expected,
+         series * 1e3);
+  printf("plain loop: %.17g, error %.3g, %.1f ms\n", plain, plain - expected,
+         loop * 1e3);
+  s21_clear_compiled(&body);
+  return res == VALID_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief Measures round trips of the shared-memory transport between two
+ * processes and reports latency percentiles
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../calc_logic/io/include/s21_shm_ring.h"
+#include "../calc_logic/translator/include/translator.h"
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int s21_by_value(const void *a, const void *b) {
+  double diff = *(const double *)a - *(const double *)b;
+  return (diff > 0) - (diff < 0);
+}
+
+int main(int argc, char *argv[]) {
+  const char *path = argc > 1 ? argv[1] : "/dev/shm/s21_shm_bench";
+  long count = argc > 2 ? atol(argv[2]) : 1000000;
+  const char *expr = argc > 3 ? argv[3] : "sin(x)*2^(1/3)+sqrt(x)/(1+cos(x))";
+  if (count < 1) return EXIT_FAILURE;
+
+  shm_channel server;
+  if (s21_shm_create(path, &server) != SHM_OK) {
+    fprintf(stderr, "failed to create %s\n", path);
+    return EXIT_FAILURE;
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    s21_shm_serve(&server, NULL);
+    s21_shm_detach(&server);
+    _exit(EXIT_SUCCESS);
+  }
+  s21_shm_detach(&server);
+
+  shm_channel client;
+  uint32_t id = 0;
+  double *latency = malloc(count * sizeof(double));
+  int res = latency && s21_shm_attach(path, &client) == SHM_OK ? VALID_OK
+                                                               : NULL_PTR;
+  if (res == VALID_OK) res = s21_shm_register(&client, expr, &id);
+  if (res != VALID_OK) {
+    fprintf(stderr, "failed to register %s\n", expr);
+    if (pid > 0) kill(pid, SIGTERM);
+    return EXIT_FAILURE;
+  }
+
+  double y = 0;
+  double sum = 0;
+  for (long i = 0; i < count / 10; i++) s21_shm_eval(&client, id, i, &y);
+  double start = s21_now();
+  for (long i = 0; i < count; i++) {
+    double before = s21_now();
+    s21_shm_eval(&client, id, i % 1000, &y);
+    latency[i] = s21_now() - before;
+    sum += y;
+  }
+  double elapsed = s21_now() - start;
+  s21_shm_stop(&client);
+  s21_shm_detach(&client);
+  waitpid(pid, NULL, 0);
+  unlink(path);
+
+  qsort(latency, count, sizeof(double), s21_by_value);
+  printf("round trips: %ld in %.3f s, %.0f per second (%.2f)\n", count,
+         elapsed, count / elapsed, sum);
+  printf("latency us: p50 %.2f, p99 %.2f, p99.9 %.2f, max %.2f\n",
+         latency[count / 2] * 1e6, latency[count * 99 / 100] * 1e6,
+         latency[count * 999 / 1000] * 1e6, latency[count - 1] * 1e6);
+  free(latency);
+  return EXIT_SUCCESS;
+}
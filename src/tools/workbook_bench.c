@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Builds a workbook of credits chained into deposit projections and
+ * measures full and incremental recomputation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../calc_logic/workbook/include/s21_workbook.h"
+
+#define BENCH_CELLS_PER_LOAN 4
+
+static double s21_now(void) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Cell names are letters only, so loans are numbered in base 26.
+ */
+static void s21_cell_name(char *name, char prefix, int loan) {
+  int len = 0;
+  name[len++] = prefix;
+  for (int i = 0; i < 4; i++, loan /= 26) name[len++] = 'a' + loan % 26;
+  name[len] = '\0';
+}
+
+static int s21_build(workbook *book, int loans) {
+  int res = s21_workbook_set(book, "rate", "12");
+  if (res == VALID_OK) res = s21_workbook_set(book, "term", "24");
+  char amount[8], payment[8], over[8], deposit[8];
+  char expr[FUNC_MAX_LEN + 1];
+  for (int i = 0; res == VALID_OK && i < loans; i++) {
+    s21_cell_name(amount, 'a', i);
+    s21_cell_name(payment, 'p', i);
+    s21_cell_name(over, 'o', i);
+    s21_cell_name(deposit, 'd', i);
+    snprintf(expr, sizeof(expr), "%d", 100000 + i % 1000 * 100);
+    res = s21_workbook_set(book, amount, expr);
+    snprintf(expr, sizeof(expr), "annuity(%s,rate,term)", amount);
+    if (res == VALID_OK) res = s21_workbook_set(book, payment, expr);
+    snprintf(expr, sizeof(expr), "%s*term-%s", payment, amount);
+    if (res == VALID_OK) res = s21_workbook_set(book, over, expr);
+    snprintf(expr, sizeof(expr), "capital(%s,rate,12,term/12)", over);
+    if (res == VALID_OK) res = s21_workbook_set(book, deposit, expr);
+  }
+  return res;
+}
+
+static void s21_measure(workbook *book, const char *what, int threads) {
+  double start = s21_now();
+  size_t cells = s21_workbook_recalc(book, threads);
+  printf("%-24s %7zu cells %9.3f ms\n", what, cells,
+         (s21_now() - start) * 1e3);
+}
+
+int main(int argc, char *argv[]) {
+  int count = argc > 1 ? atoi(argv[1]) : 100000;
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  if (count < BENCH_CELLS_PER_LOAN) {
+    fprintf(stderr, "usage: workbook_bench [cells] [threads]\n");
+    return EXIT_FAILURE;
+  }
+
+  workbook *book = s21_create_workbook();
+  double start = s21_now();
+  if (!book || s21_build(book, count / BENCH_CELLS_PER_LOAN) != VALID_OK) {
+    fprintf(stderr, "failed to build the workbook\n");
+    s21_clear_workbook(book);
+    return EXIT_FAILURE;
+  }
+  printf("built %d cells in %.1f ms\n", book->count,
+         (s21_now() - start) * 1e3);
+
+  s21_measure(book, "first calculation", threads);
+  s21_workbook_set(book, "rate", "13.5");
+  s21_measure(book, "rate changed", threads);
+  s21_workbook_set(book, "rate", "13.5");
+  s21_measure(book, "rate, one thread", 1);
+  s21_workbook_set(book, "aaaaa", "250000");
+  s21_measure(book, "one amount changed", threads);
+
+  double value = 0;
+  int status = s21_workbook_get(book, "daaaa", &value);
+  printf("first deposit projection: %.2f (status %d)\n", value, status);
+  s21_clear_workbook(book);
+  return status == VALID_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,14 +1,36 @@
 #include <check.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define EPSILON 1e-7
 typedef long double ld;
 
 #include "../src/calc_logic/bank_calc/include/s21_credit_calc.h"
+#include "../src/calc_logic/bank_calc/include/s21_credit_schedule.h"
+#include "../src/calc_logic/bank_calc/include/s21_credit_solver.h"
 #include "../src/calc_logic/bank_calc/include/s21_deposit_calc.h"
+#include "../src/calc_logic/bank_calc/include/s21_monte_carlo.h"
+#include "../src/calc_logic/compiler/include/s21_aggregate.h"
+#include "../src/calc_logic/compiler/include/s21_compiler.h"
+#include "../src/calc_logic/compiler/include/s21_expr_batch.h"
+#include "../src/calc_logic/compiler/include/s21_fast_math.h"
+#include "../src/calc_logic/compiler/include/s21_functions.h"
+#include "../src/calc_logic/compiler/include/s21_gradient.h"
+#include "../src/calc_logic/compiler/include/s21_roots.h"
+#include "../src/calc_logic/io/include/s21_columnar.h"
+#include "../src/calc_logic/io/include/s21_formula_file.h"
+#include "../src/calc_logic/io/include/s21_history.h"
+#include "../src/calc_logic/io/include/s21_loan_book.h"
+#include "../src/calc_logic/io/include/s21_protocol.h"
+#include "../src/calc_logic/io/include/s21_shm_ring.h"
+#include "../src/calc_logic/live/include/s21_live_calc.h"
+#include "../src/calc_logic/plot/include/s21_plot.h"
 #include "../src/calc_logic/s21_calc.h"
 #include "../src/calc_logic/translator/include/translator.h"
+#include "../src/calc_logic/workbook/include/s21_workbook.h"
 
 START_TEST(test_ok1) {
   const char *expr = "2+2*3/4^5";
@@ -85,6 +107,52 @@ START_TEST(test_invalid_expr4) {
 }
 END_TEST
 
+START_TEST(test_calc_eval) {
+  ld result = 0;
+  ck_assert_int_eq(s21_calc_eval("2+2*2", &result), VALID_OK);
+  ck_assert_double_eq(result, 6);
+  ck_assert_int_eq(s21_calc_eval("1569325041+0", &result), VALID_OK);
+  ck_assert_double_eq(result, BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_calc_eval("1569325040+2", &result), VALID_OK);
+  ck_assert_double_eq(result, INVALID_EXPRESSION);
+
+  result = 7;
+  ck_assert_int_eq(s21_calc_eval("(2+3))", &result), BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_calc_eval("33++++", &result), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_calc_eval("privet(33)", &result), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_calc_eval(NULL, &result), NULL_PTR);
+  ck_assert_int_eq(s21_calc_eval("1", NULL), NULL_PTR);
+  ck_assert_double_eq(result, 7);
+}
+END_TEST
+
+START_TEST(test_parser) {
+  ld result = 0;
+  ck_assert_int_eq(s21_calc_eval("2^3^2", &result), VALID_OK);
+  ck_assert_double_eq(result, 512);
+  ck_assert_int_eq(s21_calc_eval("-2^2+(-cos(0))", &result), VALID_OK);
+  ck_assert_double_eq(result, -5);
+  ck_assert_int_eq(s21_calc_eval("((((5))))", &result), VALID_OK);
+  ck_assert_double_eq(result, 5);
+  ck_assert_int_eq(s21_calc_eval("sqrt(16)^2 - 8:2", &result), VALID_OK);
+  ck_assert_double_eq(result, 12);
+  ck_assert_int_eq(s21_calc_eval("sin(sin(0))", &result), VALID_OK);
+  ck_assert_double_eq(result, 0);
+  ck_assert_int_eq(s21_calc_eval("(1+2", &result), BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_calc_eval("(1+2 3)", &result), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_calc_eval("1..2", &result), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_calc_eval("()", &result), INVALID_EXPRESSION);
+
+  const char *broken[] = {"(1+2", "((1", "sin(", "(", "2*(3-"};
+  for (int i = 0; i < 5; i++) {
+    char *exact = malloc(strlen(broken[i]) + 1);
+    strcpy(exact, broken[i]);
+    ck_assert_int_ne(s21_calc_eval(exact, &result), VALID_OK);
+    free(exact);
+  }
+}
+END_TEST
+
 START_TEST(test_credit_calc_annuint) {
   credit_data result = {0};
   credit_data expected = {8560.7481788, 2728.9781461, 102728.9781461, {0}};
@@ -149,6 +217,1321 @@ START_TEST(test_deposit_calc_cap) {
 }
 END_TEST
 
+START_TEST(test_credit_solve_rate) {
+  ld rate = 0;
+  credit_data data = s21_calc_annuity(100000, 7.35, 36);
+
+  int status = s21_solve_rate(100000, 36, data.monthly_payment, &rate);
+
+  ck_assert_int_eq(status, SOLVER_OK);
+  ck_assert_double_eq_tol(rate, 7.35, EPSILON);
+  ck_assert_int_eq(s21_solve_rate(100000, 36, 2000, &rate),
+                   SOLVER_NO_SOLUTION);
+}
+END_TEST
+
+START_TEST(test_credit_solve_term_amount) {
+  ld term = 0;
+  ld amount = 0;
+  credit_data data = s21_calc_annuity(100000, 5, 12);
+
+  ck_assert_int_eq(s21_solve_term(100000, 5, data.monthly_payment, &term),
+                   SOLVER_OK);
+  ck_assert_double_eq_tol(term, 12, EPSILON);
+  ck_assert_int_eq(s21_solve_amount(12, 5, data.monthly_payment, &amount),
+                   SOLVER_OK);
+  ck_assert_double_eq_tol(amount, 100000, EPSILON);
+  ck_assert_int_eq(s21_solve_term(100000, 12, 1000, &term), SOLVER_NO_SOLUTION);
+}
+END_TEST
+
+START_TEST(test_credit_effective_apr) {
+  ld apr = 0;
+  credit_data data = s21_credit_calc(100000, 12, 5, 1);
+
+  int status = s21_effective_apr(100000, data.diff_mouths_payment, 12, &apr);
+
+  ck_assert_int_eq(status, SOLVER_OK);
+  ck_assert_double_eq_tol(apr, (powl(1 + 5.0L / 1200, 12) - 1) * 100, EPSILON);
+}
+END_TEST
+
+START_TEST(test_credit_solve_rate_batch) {
+  ld amounts[3] = {100000, 250000, 50000};
+  ld terms[3] = {12, 60, 24};
+  ld rates[3] = {5, 11.5, 19.9};
+  ld payments[3] = {0};
+  ld solved[3] = {0};
+  int status[3] = {0};
+
+  for (int i = 0; i < 3; i++) {
+    credit_data cur = s21_calc_annuity(amounts[i], rates[i], terms[i]);
+    payments[i] = cur.monthly_payment;
+  }
+  solver_batch_data data = {amounts, terms, payments, solved, status};
+
+  ck_assert_int_eq(s21_solve_rate_batch(data, 3), SOLVER_OK);
+  for (int i = 0; i < 3; i++) {
+    ck_assert_int_eq(status[i], SOLVER_OK);
+    ck_assert_double_eq_tol(solved[i], rates[i], EPSILON);
+  }
+}
+END_TEST
+
+START_TEST(test_credit_schedule_plain) {
+  credit_data annuity = s21_credit_calc(100000, 12, 5, 0);
+  credit_data diff = s21_credit_calc(100000, 12, 5, 1);
+  credit_schedule *first = s21_create_schedule(100000, 12, 5, 0);
+  credit_schedule *second = s21_create_schedule(100000, 12, 5, 1);
+  schedule_row row = {0};
+
+  schedule_totals totals = s21_schedule_totals(first);
+  ck_assert_int_eq(totals.term, 12);
+  ck_assert_double_eq_tol(totals.total_payment, annuity.total_payment, EPSILON);
+  ck_assert_double_eq_tol(totals.overpayment, annuity.overpayment, EPSILON);
+  ck_assert_int_eq(s21_schedule_row(first, 12, &row), SCHEDULE_OK);
+  ck_assert_double_eq_tol(row.payment, annuity.monthly_payment, EPSILON);
+  ck_assert_double_eq_tol(row.balance, 0, EPSILON);
+
+  totals = s21_schedule_totals(second);
+  ck_assert_double_eq_tol(totals.total_payment, diff.total_payment, EPSILON);
+  for (int i = 0; i < 12; i++) {
+    s21_schedule_row(second, i + 1, &row);
+    ck_assert_double_eq_tol(row.payment, diff.diff_mouths_payment[i], EPSILON);
+  }
+  ck_assert_int_eq(s21_schedule_row(second, 13, &row), SCHEDULE_ERROR);
+  ck_assert_ptr_null(s21_create_schedule(100000, 12, 0, 0));
+
+  s21_clear_schedule(first);
+  s21_clear_schedule(second);
+}
+END_TEST
+
+START_TEST(test_credit_schedule_prepay) {
+  credit_schedule *schedule = s21_create_schedule(100000, 24, 12, 0);
+  schedule_totals plain = s21_schedule_totals(schedule);
+  schedule_row rows[24] = {0};
+
+  ck_assert_int_eq(
+      s21_schedule_prepay(schedule, 6, 30000, PREPAY_REDUCE_TERM),
+      SCHEDULE_OK);
+  schedule_totals shorter = s21_schedule_totals(schedule);
+  ck_assert_int_lt(shorter.term, 24);
+  ck_assert_double_lt(shorter.overpayment, plain.overpayment);
+
+  int filled = s21_schedule_fill(schedule, 1, rows, 24);
+  ld principal = 0;
+  ck_assert_int_eq(filled, shorter.term);
+  for (int i = 0; i < filled; i++) {
+    principal += rows[i].principal + rows[i].prepayment;
+  }
+  ck_assert_double_eq_tol(principal, 100000, EPSILON);
+  ck_assert_double_eq_tol(rows[5].prepayment, 30000, EPSILON);
+  ck_assert_double_eq_tol(rows[6].payment, rows[0].payment, EPSILON);
+  ck_assert_double_eq_tol(rows[filled - 1].balance, 0, EPSILON);
+
+  ck_assert_int_eq(s21_schedule_undo(schedule), SCHEDULE_OK);
+  ck_assert_int_eq(
+      s21_schedule_prepay(schedule, 6, 30000, PREPAY_REDUCE_PAYMENT),
+      SCHEDULE_OK);
+  schedule_totals lower = s21_schedule_totals(schedule);
+  s21_schedule_fill(schedule, 1, rows, 24);
+  ck_assert_int_eq(lower.term, 24);
+  ck_assert_double_lt(rows[6].payment, rows[0].payment);
+  ck_assert_double_eq_tol(rows[23].balance, 0, EPSILON);
+  ck_assert_double_lt(shorter.overpayment, lower.overpayment);
+
+  s21_clear_schedule(schedule);
+}
+END_TEST
+
+START_TEST(test_credit_schedule_undo_redo) {
+  credit_schedule *schedule = s21_create_schedule(100000, 36, 9, 1);
+  schedule_totals plain = s21_schedule_totals(schedule);
+
+  s21_schedule_prepay(schedule, 3, 10000, PREPAY_REDUCE_PAYMENT);
+  s21_schedule_prepay(schedule, 10, 20000, PREPAY_REDUCE_TERM);
+  schedule_totals both = s21_schedule_totals(schedule);
+  s21_schedule_prepay(schedule, 20, 1e9, PREPAY_REDUCE_TERM);
+  ck_assert_int_eq(s21_schedule_term(schedule), 20);
+
+  ck_assert_int_eq(s21_schedule_undo(schedule), SCHEDULE_OK);
+  schedule_totals restored = s21_schedule_totals(schedule);
+  ck_assert_int_eq(restored.term, both.term);
+  ck_assert_double_eq_tol(restored.total_payment, both.total_payment, EPSILON);
+
+  s21_schedule_undo(schedule);
+  s21_schedule_undo(schedule);
+  ck_assert_int_eq(s21_schedule_undo(schedule), SCHEDULE_ERROR);
+  restored = s21_schedule_totals(schedule);
+  ck_assert_double_eq_tol(restored.total_payment, plain.total_payment, EPSILON);
+
+  ck_assert_int_eq(s21_schedule_redo(schedule), SCHEDULE_OK);
+  ck_assert_int_eq(s21_schedule_redo(schedule), SCHEDULE_OK);
+  restored = s21_schedule_totals(schedule);
+  ck_assert_double_eq_tol(restored.total_payment, both.total_payment, EPSILON);
+
+  s21_clear_schedule(schedule);
+}
+END_TEST
+
+START_TEST(test_philox_known_answer) {
+  uint32_t counter[4] = {0};
+  uint32_t key[2] = {0};
+  uint32_t out[4] = {0};
+  uint32_t expected[4] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+
+  s21_philox4x32(counter, key, out);
+
+  for (int i = 0; i < 4; i++) ck_assert_uint_eq(out[i], expected[i]);
+}
+END_TEST
+
+START_TEST(test_quantile_sketch) {
+  quantile_sketch *first = calloc(1, sizeof(quantile_sketch));
+  quantile_sketch *second = calloc(1, sizeof(quantile_sketch));
+
+  for (int i = 1; i <= 1000; i++) {
+    s21_sketch_add(i % 2 ? first : second, i);
+  }
+  s21_sketch_merge(first, second);
+
+  ck_assert_uint_eq(first->count, 1000);
+  ck_assert_double_eq_tol(s21_sketch_quantile(first, 0.5), 500, 500 * 0.02);
+  ck_assert_double_eq_tol(s21_sketch_quantile(first, 0.95), 950, 950 * 0.02);
+  ck_assert_double_nan(s21_sketch_quantile(first, 2));
+  ck_assert_uint_eq(first->clamped, 0);
+  s21_sketch_add(first, 1e12);
+  s21_sketch_add(first, -1e-12);
+  s21_sketch_add(first, INFINITY);
+  ck_assert_uint_eq(first->clamped, 3);
+  s21_sketch_merge(second, first);
+  ck_assert_uint_eq(second->clamped, 3);
+
+  free(first);
+  free(second);
+}
+END_TEST
+
+START_TEST(test_monte_carlo) {
+  mc_params params = {MC_CREDIT, 100000, 12, {5, 5, 0, 0}, 7, 1000, 1, 0};
+  mc_result single = {0};
+  mc_result multi = {0};
+  credit_data fixed = s21_calc_annuity(100000, 5, 12);
+
+  ck_assert_int_eq(s21_monte_carlo(params, &single), MC_OK);
+  ck_assert_double_eq_tol(single.p50, fixed.overpayment,
+                          fixed.overpayment * 0.02);
+
+  params.model.volatility = 2;
+  params.threads = 1;
+  s21_monte_carlo(params, &single);
+  params.threads = 4;
+  s21_monte_carlo(params, &multi);
+  ck_assert_uint_eq(multi.paths, 1000);
+  ck_assert_double_eq(single.p5, multi.p5);
+  ck_assert_double_eq(single.p95, multi.p95);
+  ck_assert_double_lt(single.p5, single.p95);
+
+  ck_assert_uint_eq(multi.clamped, 0);
+
+  params.paths = 40000;
+  params.threads = 1;
+  s21_monte_carlo(params, &single);
+  params.threads = 3;
+  s21_monte_carlo(params, &multi);
+  ck_assert_double_eq(single.mean, multi.mean);
+
+  params.product = MC_DEPOSIT;
+  ck_assert_int_eq(s21_monte_carlo(params, &multi), MC_OK);
+  ck_assert_double_gt(multi.p50, 0);
+  params.amount = 1e12;
+  ck_assert_int_eq(s21_monte_carlo(params, &multi), MC_OK);
+  ck_assert_uint_eq(multi.clamped, multi.paths);
+  params.paths = 0;
+  ck_assert_int_eq(s21_monte_carlo(params, &multi), MC_ERROR);
+}
+END_TEST
+
+START_TEST(test_credit_calc_batch) {
+  double amount[4] = {100000, 100000, 50000, -1};
+  double term[4] = {12, 12, 36.5, 12};
+  double rate[4] = {5, 5, 7.8, 5};
+  int type[4] = {0, 1, 1, 0};
+  double monthly[4] = {0};
+  double overpayment[4] = {0};
+  double total[4] = {0};
+  credit_batch batch = {4,       amount,      term, rate, type,
+                        monthly, overpayment, total};
+
+  s21_credit_calc_batch(batch);
+
+  for (int i = 0; i < 4; i++) {
+    credit_data expected =
+        s21_credit_calc(amount[i], term[i], rate[i], type[i]);
+    ck_assert_double_eq_tol(monthly[i], expected.monthly_payment, EPSILON);
+    ck_assert_double_eq_tol(overpayment[i], expected.overpayment, EPSILON);
+    ck_assert_double_eq_tol(total[i], expected.total_payment, EPSILON);
+  }
+}
+END_TEST
+
+START_TEST(test_loan_book_load) {
+  const char *csv =
+      "amount,term,rate,type\r\n"
+      "100000,12,5,0\r\n"
+      "\n"
+      "2.5e5, 60 ,11.5,1\n"
+      "oops,12,5,0\n"
+      "50000,24,19.9,0";
+  FILE *file = fopen("test_loans.csv", "w");
+  fputs(csv, file);
+  fclose(file);
+
+  for (int threads = 1; threads <= 3; threads++) {
+    loan_book book = {0};
+    ck_assert_int_eq(s21_load_loan_book("test_loans.csv", threads, &book),
+                     LOAN_BOOK_OK);
+    ck_assert_uint_eq(book.count, 3);
+    ck_assert_uint_eq(book.bad_rows, 1);
+    ck_assert_double_eq(book.amount[1], 250000);
+    ck_assert_double_eq(book.term[1], 60);
+    ck_assert_double_eq(book.rate[2], 19.9);
+    ck_assert_int_eq(book.type[1], 1);
+    s21_clear_loan_book(&book);
+  }
+  remove("test_loans.csv");
+
+  loan_book book = {0};
+  ck_assert_int_eq(s21_parse_loan_book(csv + 23, 15, 2, &book), LOAN_BOOK_OK);
+  ck_assert_uint_eq(book.count, 1);
+  ck_assert_double_eq(book.amount[0], 100000);
+  s21_clear_loan_book(&book);
+  ck_assert_int_eq(s21_load_loan_book("no_such_file.csv", 1, &book),
+                   LOAN_BOOK_ERROR);
+}
+END_TEST
+
+START_TEST(test_columnar_schedule) {
+  credit_schedule *schedule = s21_create_schedule(100000, 24, 12, 0);
+  s21_schedule_prepay(schedule, 6, 30000, PREPAY_REDUCE_TERM);
+  int term = s21_schedule_term(schedule);
+  columnar_file file = {0};
+  schedule_row row = {0};
+  int32_t months[24] = {0};
+
+  ck_assert_int_eq(s21_columnar_write_schedule("test_schedule.s21c", schedule),
+                   COLUMNAR_OK);
+  ck_assert_int_eq(s21_columnar_open("test_schedule.s21c", &file), COLUMNAR_OK);
+  ck_assert_uint_eq(file.rows, term);
+  ck_assert_int_eq(file.columns, 6);
+
+  int month = s21_columnar_find(&file, "month");
+  int balance = s21_columnar_find(&file, "balance");
+  ck_assert_int_ge(balance, 0);
+  ck_assert_int_eq(s21_columnar_find(&file, "nothing"), -1);
+  ck_assert_ptr_null(s21_columnar_data(&file, month));
+  ck_assert_int_eq(s21_columnar_read(&file, month, months), COLUMNAR_OK);
+
+  const double *balances = s21_columnar_data(&file, balance);
+  ck_assert_ptr_nonnull(balances);
+  for (int i = 0; i < term; i++) {
+    s21_schedule_row(schedule, i + 1, &row);
+    ck_assert_int_eq(months[i], i + 1);
+    ck_assert_double_eq(balances[i], (double)row.balance);
+  }
+
+  s21_columnar_close(&file);
+  s21_clear_schedule(schedule);
+  remove("test_schedule.s21c");
+}
+END_TEST
+
+START_TEST(test_columnar_batch) {
+  double amount[3] = {100000, 200000, 300000};
+  double term[3] = {12, 24, 36};
+  double rate[3] = {5, 6, 7};
+  int type[3] = {0, 1, 0};
+  double out[9] = {0};
+  double read[3] = {0};
+  credit_batch batch = {3, amount, term, rate, type, out, out + 3, out + 6};
+  columnar_spec delta = {"amount", COL_F64, COL_DELTA, amount};
+  columnar_file file = {0};
+
+  s21_credit_calc_batch(batch);
+  ck_assert_int_eq(s21_columnar_write_credit_batch("test_batch.s21c", batch),
+                   COLUMNAR_OK);
+  ck_assert_int_eq(s21_columnar_open("test_batch.s21c", &file), COLUMNAR_OK);
+  const double *total =
+      s21_columnar_data(&file, s21_columnar_find(&file, "total_payment"));
+  const int *types = s21_columnar_data(&file, s21_columnar_find(&file, "type"));
+  for (int i = 0; i < 3; i++) {
+    ck_assert_double_eq(total[i], batch.total_payment[i]);
+    ck_assert_int_eq(types[i], type[i]);
+  }
+  s21_columnar_close(&file);
+
+  ck_assert_int_eq(s21_columnar_write("test_batch.s21c", &delta, 1, 3),
+                   COLUMNAR_OK);
+  ck_assert_int_eq(s21_columnar_open("test_batch.s21c", &file), COLUMNAR_OK);
+  ck_assert_int_eq(s21_columnar_read(&file, 0, read), COLUMNAR_OK);
+  for (int i = 0; i < 3; i++) ck_assert_double_eq(read[i], amount[i]);
+  s21_columnar_close(&file);
+
+  columnar_header forged = {0};
+  FILE *patch = fopen("test_batch.s21c", "r+b");
+  ck_assert_uint_eq(fread(&forged, sizeof(forged), 1, patch), 1);
+  forged.rows = 3 + (UINT64_C(1) << 61);
+  rewind(patch);
+  fwrite(&forged, sizeof(forged), 1, patch);
+  fclose(patch);
+  ck_assert_int_eq(s21_columnar_open("test_batch.s21c", &file),
+                   COLUMNAR_ERROR);
+  patch = fopen("test_batch.s21c", "r+b");
+  forged.rows = 3;
+  forged.columns = 0;
+  fwrite(&forged, sizeof(forged), 1, patch);
+  fclose(patch);
+  ck_assert_int_eq(s21_columnar_open("test_batch.s21c", &file),
+                   COLUMNAR_ERROR);
+
+  FILE *broken = fopen("test_batch.s21c", "w");
+  fputs("S21X", broken);
+  fclose(broken);
+  ck_assert_int_eq(s21_columnar_open("test_batch.s21c", &file),
+                   COLUMNAR_ERROR);
+  remove("test_batch.s21c");
+}
+END_TEST
+
+START_TEST(test_compiled_expr) {
+  compiled_expr compiled = {0};
+  const char *expr = "sin(-1.5)*(2+(2*3/4))*cos(1)/tan(0.5)+sqrt(144)-2^3^2";
+  ck_assert_int_eq(s21_compile_expr(expr, &compiled), VALID_OK);
+  ck_assert_double_eq_tol(s21_eval_compiled(&compiled, 0),
+                          s21_smart_calc(expr), EPSILON);
+  ck_assert_int_eq(compiled.count, 1);
+  ck_assert_int_eq(compiled.literals_count, 1);
+  ck_assert_ptr_eq(compiled.literals, compiled.code + compiled.count);
+  s21_clear_compiled(&compiled);
+
+  double x[600] = {0};
+  double y[600] = {0};
+  for (int i = 0; i < 600; i++) x[i] = (i - 300) / 10.0;
+  ck_assert_int_eq(s21_compile_expr("-x^2+sin(x)/x", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_eval_compiled_batch(&compiled, x, y, 600), VALID_OK);
+  for (int i = 0; i < 600; i++) {
+    if (x[i]) {
+      ck_assert_double_eq_tol(y[i], -x[i] * x[i] + sin(x[i]) / x[i], EPSILON);
+    } else {
+      ck_assert(isnan(y[i]));
+    }
+  }
+  s21_clear_compiled(&compiled);
+
+  ck_assert_int_eq(s21_compile_expr("(x+1", &compiled), BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_compile_expr("x+1)", &compiled), BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_compile_expr("x*", &compiled), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_compile_expr("2x", &compiled), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_compile_expr("sinx", &compiled), UNKNOWN_FUNC);
+  ck_assert_ptr_null(compiled.code);
+}
+END_TEST
+
+START_TEST(test_user_functions) {
+  func_registry *registry = s21_create_registry();
+  compiled_expr compiled = {0};
+  ck_assert_ptr_nonnull(registry);
+
+  ck_assert_int_eq(s21_define_func(registry, "f(x)=x^2+3*x"), VALID_OK);
+  ck_assert_int_eq(s21_define_func(registry, "g(a, b)=f(a)*b-a"), VALID_OK);
+  ck_assert_int_eq(s21_define_func(registry, "h(t)=g(f(t),2)/g(t,1)"),
+                   VALID_OK);
+  ck_assert_int_eq(s21_compile_expr_with("h(2)", registry, &compiled),
+                   VALID_OK);
+  ck_assert_int_eq(compiled.count, 1);
+  ck_assert_double_eq_tol(s21_eval_compiled(&compiled, 0), 250.0 / 8,
+                          EPSILON);
+  s21_clear_compiled(&compiled);
+  ck_assert_int_eq(s21_compile_expr_with("g(x,2)+g(1,x)", registry, &compiled),
+                   VALID_OK);
+  ck_assert_double_eq_tol(s21_eval_compiled(&compiled, 3), 44, EPSILON);
+  s21_clear_compiled(&compiled);
+  ck_assert_int_eq(s21_compile_expr_with("f(1,2)", registry, &compiled),
+                   INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_compile_expr("f(2)", &compiled), UNKNOWN_FUNC);
+
+  uint32_t generation = registry->generation;
+  ck_assert_int_eq(s21_define_func(registry, "f(x)=x"), VALID_OK);
+  ck_assert(registry->generation != generation);
+  ck_assert_int_eq(s21_compile_expr_with("g(2,3)", registry, &compiled),
+                   VALID_OK);
+  ck_assert_double_eq_tol(s21_eval_compiled(&compiled, 0), 4, EPSILON);
+  s21_clear_compiled(&compiled);
+
+  ck_assert_int_eq(s21_define_func(registry, "p(x)=q(x)+1"), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_define_func(registry, "q(x)=p(x)*2"), RECURSIVE_FUNC);
+  ck_assert_int_eq(s21_func_status(registry, "p"), RECURSIVE_FUNC);
+  ck_assert_int_eq(s21_define_func(registry, "q(x)=x"), VALID_OK);
+  ck_assert_int_eq(s21_func_status(registry, "p"), VALID_OK);
+  ck_assert_int_eq(s21_define_func(registry, "r(x)=r(x-1)"), RECURSIVE_FUNC);
+
+  ck_assert_int_eq(s21_undefine_func(registry, "f"), VALID_OK);
+  ck_assert_int_eq(s21_func_status(registry, "g"), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_func_status(registry, "h"), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_define_func(registry, "sin(x)=x"), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_define_func(registry, "k(a,a)=a"), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_define_func(registry, "k(a)"), INVALID_EXPRESSION);
+  s21_clear_registry(registry);
+
+  const char params[1][FUNC_NAME_SIZE] = {"a"};
+  double x[3] = {1, 2, 3};
+  double y[3] = {0};
+  ck_assert_int_eq(s21_compile_body("a*x+1", NULL, params, 1, &compiled),
+                   VALID_OK);
+  ck_assert_int_eq(s21_eval_compiled_batch(&compiled, x, y, 3), VALID_OK);
+  for (int i = 0; i < 3; i++) ck_assert(isnan(y[i]));
+  ck_assert(isnan(s21_eval_compiled(&compiled, 1)));
+  s21_clear_compiled(&compiled);
+}
+END_TEST
+
+START_TEST(test_workbook) {
+  workbook *book = s21_create_workbook();
+  double value = 0;
+  ck_assert_ptr_nonnull(book);
+
+  ck_assert_int_eq(s21_workbook_set(book, "payment", "annuity(amount,rate,n)"),
+                   VALID_OK);
+  ck_assert_int_eq(s21_workbook_set(book, "over", "payment*n-amount"),
+                   VALID_OK);
+  ck_assert_int_eq(
+      s21_workbook_set(book, "dep", "capital(over, rate, 12, n / 12)"),
+      VALID_OK);
+  ck_assert_uint_eq(s21_workbook_recalc(book, 1), 3);
+  ck_assert_int_eq(s21_workbook_get(book, "dep", &value), UNKNOWN_FUNC);
+  ck_assert(isnan(value));
+
+  ck_assert_int_eq(s21_workbook_set(book, "amount", "100000"), VALID_OK);
+  ck_assert_int_eq(s21_workbook_set(book, "rate", "12"), VALID_OK);
+  ck_assert_int_eq(s21_workbook_set(book, "n", "24"), VALID_OK);
+  ck_assert_uint_eq(s21_workbook_recalc(book, 1), 6);
+  credit_data credit = s21_calc_annuity(100000, 12, 24);
+  ck_assert_int_eq(s21_workbook_get(book, "payment", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, credit.monthly_payment, EPSILON);
+  ck_assert_int_eq(s21_workbook_get(book, "over", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, credit.overpayment, EPSILON);
+  deposit_data deposit =
+      s21_deposit_calc(credit.overpayment, 2, 12, 0, 12, 0, 0, 1);
+  ck_assert_int_eq(s21_workbook_get(book, "dep", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, deposit.acc_interest, EPSILON);
+
+  ck_assert_int_eq(s21_workbook_set(book, "amount", "200000"), VALID_OK);
+  ck_assert_uint_eq(s21_workbook_recalc(book, 1), 4);
+  ck_assert_uint_eq(s21_workbook_recalc(book, 1), 0);
+  ck_assert_int_eq(s21_workbook_get(book, "over", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, 2 * credit.overpayment, EPSILON);
+
+  ck_assert_int_eq(s21_workbook_set(book, "rate", "dep/1000"), VALID_OK);
+  s21_workbook_recalc(book, 1);
+  ck_assert_int_eq(s21_workbook_get(book, "over", &value), RECURSIVE_FUNC);
+  ck_assert_int_eq(s21_workbook_set(book, "rate", "12"), VALID_OK);
+  s21_workbook_recalc(book, 1);
+  ck_assert_int_eq(s21_workbook_get(book, "dep", &value), VALID_OK);
+
+  ck_assert_int_eq(s21_workbook_func(book, "twice(a)=2*a"), VALID_OK);
+  ck_assert_int_eq(s21_workbook_set(book, "big", "twice(amount)"), VALID_OK);
+  ck_assert_int_eq(s21_workbook_set(book, "sin", "1"), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_workbook_set(book, "twice", "1"), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_workbook_set(book, "bad", "amount+"),
+                   INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_workbook_func(book, "amount(a)=a"),
+                   INVALID_EXPRESSION);
+  s21_workbook_recalc(book, 1);
+  ck_assert_int_eq(s21_workbook_get(book, "big", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, 400000, EPSILON);
+  ck_assert_int_eq(s21_workbook_get(book, "bad", &value), INVALID_EXPRESSION);
+  s21_clear_workbook(book);
+}
+END_TEST
+
+START_TEST(test_workbook_parallel) {
+  workbook *book = s21_create_workbook();
+  char name[FUNC_NAME_SIZE] = {0};
+  char expr[FUNC_MAX_LEN + 1] = {0};
+  ck_assert_int_eq(s21_workbook_set(book, "base", "1"), VALID_OK);
+  for (int i = 0; i < 3 * WORKBOOK_PARALLEL_MIN; i++) {
+    snprintf(name, sizeof(name), "c%c%c%c", 'a' + i / 676, 'a' + i / 26 % 26,
+             'a' + i % 26);
+    snprintf(expr, sizeof(expr), "base*%d", i);
+    ck_assert_int_eq(s21_workbook_set(book, name, expr), VALID_OK);
+  }
+  ck_assert_int_eq(s21_workbook_set(book, "total", "caaa+cbbb+cdzz"),
+                   VALID_OK);
+  ck_assert_uint_eq(s21_workbook_recalc(book, 4),
+                    3 * WORKBOOK_PARALLEL_MIN + 2);
+  ck_assert_int_eq(s21_workbook_set(book, "base", "2"), VALID_OK);
+  ck_assert_uint_eq(s21_workbook_recalc(book, 4),
+                    3 * WORKBOOK_PARALLEL_MIN + 2);
+
+  double value = 0;
+  ck_assert_int_eq(s21_workbook_get(book, "cfff", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, 2 * (5 * 676 + 5 * 26 + 5), EPSILON);
+  ck_assert_int_eq(s21_workbook_get(book, "total", &value), VALID_OK);
+  ck_assert_double_eq_tol(value, 2 * (0 + 703 + 2703), EPSILON);
+  s21_clear_workbook(book);
+}
+END_TEST
+
+START_TEST(test_expr_batch) {
+  const char *exprs[] = {"(1+x/12)^24", "2*(1+x/12)^24", "(1+x/12)^24*2",
+                         "sqrt(x)*sqrt(x)-1/x"};
+  compiled_batch batch;
+  int failed = -1;
+  ck_assert_int_eq(s21_compile_batch(exprs, 4, &batch, &failed), VALID_OK);
+  ck_assert_int_eq(batch.instructions, 7 + 9 + 9 + 9);
+  ck_assert_int_eq(batch.nodes_count, 9 + 4);
+  ck_assert_int_le(batch.slots, 4);
+
+  double x[300];
+  double y[4 * 300];
+  for (int i = 0; i < 300; i++) x[i] = i * 0.1;
+  ck_assert_int_eq(s21_eval_batch(&batch, x, y, 300), VALID_OK);
+  for (int e = 0; e < 4; e++) {
+    compiled_expr program;
+    ck_assert_int_eq(s21_compile_expr(exprs[e], &program), VALID_OK);
+    for (int i = 1; i < 300; i++) {
+      ck_assert_double_eq_tol(y[e * 300 + i], s21_eval_compiled(&program, x[i]),
+                              EPSILON);
+    }
+    s21_clear_compiled(&program);
+  }
+  ck_assert(isnan(y[3 * 300]));
+  s21_clear_batch(&batch);
+
+  const char *bad[] = {"x+1", "x+"};
+  ck_assert_int_eq(s21_compile_batch(bad, 2, &batch, &failed),
+                   INVALID_EXPRESSION);
+  ck_assert_int_eq(failed, 1);
+  ck_assert_ptr_null(batch.nodes);
+}
+END_TEST
+
+START_TEST(test_aggregates) {
+  long double result = 0;
+  ck_assert_int_eq(s21_calc_eval("sum(i, 1, 100, i)", &result), VALID_OK);
+  ck_assert_double_eq_tol(result, 5050, EPSILON);
+  ck_assert_int_eq(s21_calc_eval("2*sum(k,1,10,k^2)+1", &result), VALID_OK);
+  ck_assert_double_eq_tol(result, 771, EPSILON);
+  ck_assert_int_eq(s21_calc_eval("prod(n, 1, 2+3, n)", &result), VALID_OK);
+  ck_assert_double_eq_tol(result, 120, EPSILON);
+  ck_assert_int_eq(s21_calc_eval("sum(i, 3, 1, i)", &result), VALID_OK);
+  ck_assert_double_eq_tol(result, 0, EPSILON);
+  ck_assert_int_eq(s21_calc_eval("integral(x^2, 0, 3)", &result), VALID_OK);
+  ck_assert_double_eq_tol(result, 9, EPSILON);
+  ck_assert_int_eq(s21_calc_eval("integral(sin(x)*(1+x), 0, 2)", &result),
+                   VALID_OK);
+  ck_assert_double_eq_tol(result, 1 - 3 * cos(2) + sin(2), EPSILON);
+  ck_assert_int_eq(s21_calc_eval("sum(i, 1, 3)", &result),
+                   INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_calc_eval("sum(i, 1, 3, x)", &result), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_calc_eval("sum(sin, 1, 3, 1)", &result),
+                   INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_calc_eval("sum(i, 1, 3, (i)", &result),
+                   BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_calc_eval("sum(i, 1, 10^12, i)", &result),
+                   STR_OVERFLOW);
+
+  compiled_expr body;
+  double one = 0;
+  double four = 0;
+  ck_assert_int_eq(s21_compile_series("i", "1/i^2", &body), VALID_OK);
+  ck_assert_int_eq(
+      s21_eval_series(&body, AGGREGATE_SUM, 1, 3000000, 1, NULL, &one),
+      VALID_OK);
+  ck_assert_int_eq(
+      s21_eval_series(&body, AGGREGATE_SUM, 1, 3000000, 4, NULL, &four),
+      VALID_OK);
+  ck_assert(one == four);
+  ck_assert_double_eq_tol(one, 1.6449340668482264 - 1 / 3000000.5, 1e-14);
+  ck_assert_int_eq(
+      s21_eval_series(&body, AGGREGATE_SUM, 1, 2e10, 1, NULL, &one),
+      STR_OVERFLOW);
+
+  calc_cancel_flag cancel = 1;
+  ck_assert_int_eq(
+      s21_eval_series(&body, AGGREGATE_SUM, 1, 3000000, 4, &cancel, &one),
+      CANCELLED);
+  s21_clear_compiled(&body);
+  ck_assert_int_eq(s21_compile_expr("x^2", &body), VALID_OK);
+  ck_assert_int_eq(s21_eval_integral(&body, 0, 1, &cancel, &one), CANCELLED);
+  s21_clear_compiled(&body);
+}
+END_TEST
+
+typedef struct s21_test_cancel {
+  calc_cancel_flag cancel;
+  long double result;
+  int status;
+} s21_test_cancel;
+
+static void *s21_test_cancel_eval(void *arg) {
+  s21_test_cancel *data = arg;
+  data->status = s21_calc_eval_cancel("sum(i, 1, 10^10, i)", &data->cancel,
+                                      &data->result);
+  return NULL;
+}
+
+START_TEST(test_series_cancel) {
+  s21_test_cancel data = {0, 0, VALID_OK};
+  pthread_t thread;
+  pthread_create(&thread, NULL, s21_test_cancel_eval, &data);
+  atomic_store(&data.cancel, 1);
+  pthread_join(thread, NULL);
+  ck_assert_int_eq(data.status, CANCELLED);
+
+  long double result = 0;
+  calc_cancel_flag cancel = 0;
+  ck_assert_int_eq(
+      s21_calc_eval_cancel("2*sum(i, 1, 4, i)", &cancel, &result), VALID_OK);
+  ck_assert_double_eq_tol(result, 20, EPSILON);
+}
+END_TEST
+
+START_TEST(test_gradient) {
+  compiled_expr compiled;
+  double value = 0;
+  double gradient[3] = {0};
+  ck_assert_int_eq(s21_compile_expr("x^2*sin(x)+2^x-ln(x)", &compiled),
+                   VALID_OK);
+  ck_assert_int_eq(s21_eval_gradient(&compiled, 1.3, NULL, 0, &value, gradient),
+                   VALID_OK);
+  ck_assert_double_eq_tol(value, s21_eval_compiled(&compiled, 1.3), EPSILON);
+  ck_assert_double_eq_tol(gradient[0],
+                          2 * 1.3 * sin(1.3) + 1.69 * cos(1.3) +
+                              pow(2, 1.3) * log(2) - 1 / (1.3 * log(10)),
+                          EPSILON);
+
+  double x[300];
+  double y[300];
+  double dy[300];
+  for (int i = 0; i < 300; i++) x[i] = 0.1 + i * 0.01;
+  ck_assert_int_eq(
+      s21_eval_gradient_batch(&compiled, x, NULL, 0, y, dy, 300), VALID_OK);
+  for (int i = 0; i < 300; i++) {
+    s21_eval_gradient(&compiled, x[i], NULL, 0, &value, gradient);
+    ck_assert_double_eq_tol(y[i], value, EPSILON);
+    ck_assert_double_eq_tol(dy[i], gradient[0], EPSILON);
+  }
+  s21_clear_compiled(&compiled);
+
+  const char params[2][FUNC_NAME_SIZE] = {"a", "b"};
+  double values[2] = {3, 5};
+  ck_assert_int_eq(
+      s21_compile_body("a*x^3+log(b)/a", NULL, params, 2, &compiled),
+      VALID_OK);
+  ck_assert_int_eq(
+      s21_eval_gradient(&compiled, -2, values, 2, &value, gradient), VALID_OK);
+  ck_assert_double_eq_tol(gradient[0], 3 * 3 * 4, EPSILON);
+  ck_assert_double_eq_tol(gradient[1], -8 - log(5) / 9, EPSILON);
+  ck_assert_double_eq_tol(gradient[2], 1.0 / 15, EPSILON);
+  double grid[2] = {-2, 0};
+  double batch[3 * 2] = {0};
+  ck_assert_int_eq(
+      s21_eval_gradient_batch(&compiled, grid, values, 2, y, batch, 2),
+      VALID_OK);
+  ck_assert_double_eq_tol(batch[0], gradient[0], EPSILON);
+  ck_assert_double_eq_tol(batch[1], 0, EPSILON);
+  ck_assert_double_eq_tol(batch[2], gradient[1], EPSILON);
+  ck_assert_double_eq_tol(batch[4], gradient[2], EPSILON);
+  ck_assert_int_eq(
+      s21_eval_gradient(&compiled, -2, values, 1, &value, gradient), NULL_PTR);
+  double scratch[64] = {0};
+  ck_assert_uint_le(s21_gradient_scratch(&compiled, 2), 64);
+  double into[3] = {0};
+  ck_assert_int_eq(s21_eval_gradient_into(&compiled, -2, values, 2, &value,
+                                          into, scratch),
+                   VALID_OK);
+  for (int i = 0; i < 3; i++) ck_assert_double_eq(into[i], gradient[i]);
+  s21_clear_compiled(&compiled);
+}
+END_TEST
+
+START_TEST(test_roots) {
+  compiled_expr compiled;
+  double roots[8] = {0};
+  int count = 0;
+  ck_assert_int_eq(s21_compile_expr("sin(x)", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_solve_expr(&compiled, -1, 10, roots, 8, &count),
+                   VALID_OK);
+  ck_assert_int_eq(count, 4);
+  for (int i = 0; i < count; i++) {
+    ck_assert_double_eq_tol(roots[i], i * 3.14159265358979324, 1e-15);
+  }
+  s21_clear_compiled(&compiled);
+
+  ck_assert_int_eq(s21_compile_expr("tan(x)", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_solve_expr(&compiled, 1, 2, roots, 8, &count),
+                   VALID_OK);
+  ck_assert_int_eq(count, 0);
+  s21_clear_compiled(&compiled);
+
+  double x = 0;
+  double y = 0;
+  ck_assert_int_eq(s21_compile_expr("x^3-3*x", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_minimize_expr(&compiled, -1.5, 3, &x, &y), VALID_OK);
+  ck_assert_double_eq_tol(x, 1, 1e-7);
+  ck_assert_double_eq_tol(y, -2, EPSILON);
+  ck_assert_int_eq(s21_minimize_expr(&compiled, -3, 3, &x, &y), VALID_OK);
+  ck_assert_double_eq_tol(x, -3, 1e-7);
+  ck_assert_double_eq_tol(y, -18, 1e-6);
+  s21_clear_compiled(&compiled);
+
+  long double result = 0;
+  ck_assert_int_eq(s21_calc_eval("solve(t^2-2, t, 0, 2)", &result), VALID_OK);
+  ck_assert_double_eq_tol(result, sqrt(2), 1e-15);
+  ck_assert_int_eq(s21_calc_eval("solve(cos(t)-t, t, 0, 1)", &result),
+                   VALID_OK);
+  ck_assert_double_eq_tol(result, 0.7390851332151607, 1e-15);
+  ck_assert_int_eq(s21_calc_eval("2*minimize((t-1.5)^2+2, t, -5, 5)", &result),
+                   VALID_OK);
+  ck_assert_double_eq_tol(result, 3, 1e-7);
+  ck_assert_int_eq(s21_calc_eval("solve(t^2+1, t, -5, 5)", &result),
+                   VALID_OK);
+  ck_assert(isnan(result));
+  ck_assert_int_eq(s21_calc_eval("solve(t-1, t, 0)", &result),
+                   INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_calc_eval("solve(x-1, t, 0, 2)", &result),
+                   UNKNOWN_FUNC);
+
+  compiled_expr programs[100];
+  double a[100];
+  double b[100];
+  double found[100];
+  for (int i = 0; i < 100; i++) {
+    char expr[32] = {0};
+    sprintf(expr, "x^2-%d", i + 1);
+    ck_assert_int_eq(s21_compile_expr(expr, &programs[i]), VALID_OK);
+    a[i] = 0;
+    b[i] = 10 + (i == 99);
+  }
+  ck_assert_int_eq(s21_solve_batch(programs, a, b, found, 100, 4), VALID_OK);
+  for (int i = 0; i < 100; i++) {
+    ck_assert_double_eq_tol(found[i], sqrt(i + 1), 1e-14);
+    s21_clear_compiled(&programs[i]);
+  }
+}
+END_TEST
+
+/* Error of an approximation in ulps of the rounded exact result. */
+static double s21_test_ulps(double fast, ld exact) {
+  double rounded = (double)exact;
+  double ulp = nextafter(fabs(rounded), INFINITY) - fabs(rounded);
+  return (double)(fabsl(fast - exact) / ulp);
+}
+
+START_TEST(test_fast_math) {
+  struct {
+    double (*fast)(double);
+    ld (*exact)(ld);
+    int ulps;
+  } funcs[] = {{s21_fast_sin, sinl, FAST_MATH_ULPS_SIN},
+               {s21_fast_cos, cosl, FAST_MATH_ULPS_COS},
+               {s21_fast_tan, tanl, FAST_MATH_ULPS_TAN},
+               {s21_fast_atan, atanl, FAST_MATH_ULPS_ATAN},
+               {s21_fast_asin, asinl, FAST_MATH_ULPS_ASIN},
+               {s21_fast_acos, acosl, FAST_MATH_ULPS_ACOS},
+               {s21_fast_sqrt, sqrtl, FAST_MATH_ULPS_SQRT},
+               {s21_fast_log, logl, FAST_MATH_ULPS_LOG},
+               {s21_fast_log10, log10l, FAST_MATH_ULPS_LOG10}};
+  uint64_t state = 42;
+  for (int f = 0; f < 9; f++) {
+    double worst = 0;
+    for (int i = 0; i < 100000; i++) {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      double u = (state >> 11) * 0x1p-53;
+      double x = ldexp(2 * u - 1, i % 80 - 40);
+      if (f < 3) {
+        x = (2 * u - 1) * (i % 2 ? FAST_MATH_TRIG_MAX : 10);
+      } else if (f == 4 || f == 5) {
+        x = 2 * u - 1;
+      } else if (f > 5) {
+        x = ldexp(u + 0.5, i % 2098 - 1074);
+      }
+      double err = s21_test_ulps(funcs[f].fast(x), funcs[f].exact(x));
+      if (err > worst) worst = err;
+    }
+    ck_assert_double_le(worst, funcs[f].ulps);
+  }
+
+  ck_assert(isnan(s21_fast_sin(NAN)));
+  ck_assert(isnan(s21_fast_cos(INFINITY)));
+  ck_assert_double_eq(s21_fast_tan(1e300), tan(1e300));
+  ck_assert_double_eq(s21_fast_atan(-INFINITY), atan(-INFINITY));
+  ck_assert_double_eq(s21_fast_asin(-1), asin(-1));
+  ck_assert_double_eq(s21_fast_acos(1), 0);
+  ck_assert(isnan(s21_fast_acos(1.5)));
+  ck_assert_double_eq(s21_fast_log(0), -INFINITY);
+  ck_assert(isnan(s21_fast_log10(-1)));
+  ck_assert_double_eq(s21_fast_log(1), 0);
+  ck_assert_double_eq(s21_fast_log10(INFINITY), INFINITY);
+
+  compiled_expr compiled;
+  double x[1000];
+  double libm[1000];
+  double fast[1000];
+  for (int i = 0; i < 1000; i++) x[i] = (i - 500) * 0.37;
+  ck_assert_int_eq(s21_compile_expr("sin(x)*cos(x)+atan(x)", &compiled),
+                   VALID_OK);
+  ck_assert_int_eq(compiled.fast_math_ulps, 0);
+  ck_assert_int_eq(s21_eval_compiled_batch(&compiled, x, libm, 1000),
+                   VALID_OK);
+  compiled.fast_math_ulps = FAST_MATH_ULPS_TAN;
+  ck_assert_int_eq(s21_eval_compiled_batch(&compiled, x, fast, 1000),
+                   VALID_OK);
+  for (int i = 0; i < 1000; i++) {
+    ck_assert_double_eq_tol(fast[i], libm[i], 1e-14);
+    ck_assert_double_eq(s21_eval_compiled(&compiled, x[i]), fast[i]);
+  }
+  s21_clear_compiled(&compiled);
+
+  ck_assert_int_eq(s21_compile_expr("sin(x)", &compiled), VALID_OK);
+  compiled.fast_math_ulps = FAST_MATH_ULPS_SIN - 1;
+  s21_eval_compiled_batch(&compiled, x, fast, 1000);
+  for (int i = 0; i < 1000; i++) ck_assert_double_eq(fast[i], sin(x[i]));
+  compiled.fast_math_ulps = FAST_MATH_ULPS_SIN;
+  s21_eval_compiled_batch(&compiled, x, fast, 1000);
+  for (int i = 0; i < 1000; i++) {
+    ck_assert_double_eq(fast[i], s21_fast_sin(x[i]));
+  }
+  s21_clear_compiled(&compiled);
+
+  ck_assert_int_eq(s21_compile_expr("atan(x)+log(x^2+1)", &compiled),
+                   VALID_OK);
+  compiled.fast_math_ulps = FAST_MATH_ULPS_TAN;
+  s21_eval_compiled_batch(&compiled, x, fast, 1000);
+  for (int i = 0; i < 1000; i++) {
+    ck_assert_double_eq(fast[i], atan(x[i]) + log(x[i] * x[i] + 1));
+  }
+  s21_clear_compiled(&compiled);
+
+  mc_params params = {MC_CREDIT, 100000, 12, {5, 2, 0.5, 2}, 7, 1000, 1, 0};
+  mc_result exact = {0};
+  mc_result approx = {0};
+  ck_assert_int_eq(s21_monte_carlo(params, &exact), MC_OK);
+  params.fast_math_ulps = FAST_MATH_ULPS_COS;
+  ck_assert_int_eq(s21_monte_carlo(params, &approx), MC_OK);
+  ck_assert_double_eq_tol(approx.p50, exact.p50, fabsl(exact.p50) * 0.01);
+  ck_assert_double_eq_tol(approx.mean, exact.mean, fabsl(exact.mean) * 1e-9);
+}
+END_TEST
+
+START_TEST(test_formula_file) {
+  const char *exprs[] = {"sin(x)/x", "2^x-1", "-x^2+3.5*x"};
+  compiled_expr programs[3] = {0};
+  for (int i = 0; i < 3; i++) {
+    ck_assert_int_eq(s21_compile_expr(exprs[i], &programs[i]), VALID_OK);
+  }
+  ck_assert_int_eq(s21_formula_write("test_formulas.s21f", programs, 3),
+                   FORMULA_OK);
+
+  formula_file file;
+  compiled_expr program;
+  ck_assert_int_eq(s21_formula_open("test_formulas.s21f", &file), FORMULA_OK);
+  ck_assert_uint_eq(file.count, 3);
+  for (int i = 0; i < 3; i++) {
+    ck_assert_int_eq(s21_formula_get(&file, i, &program), FORMULA_OK);
+    ck_assert_double_eq(s21_eval_compiled(&program, 1.5),
+                        s21_eval_compiled(&programs[i], 1.5));
+    s21_clear_compiled(&programs[i]);
+  }
+  ck_assert_int_eq(s21_formula_get(&file, 3, &program), FORMULA_ERROR);
+  s21_formula_close(&file);
+
+  FILE *f = fopen("test_formulas.s21f", "r+b");
+  ck_assert_ptr_nonnull(f);
+  fseek(f, -8, SEEK_END);
+  fputc(0x7f, f);
+  fclose(f);
+  ck_assert_int_eq(s21_formula_open("test_formulas.s21f", &file),
+                   FORMULA_ERROR);
+  ck_assert_ptr_null(file.map);
+  remove("test_formulas.s21f");
+}
+END_TEST
+
+START_TEST(test_plot_sample) {
+  compiled_expr compiled = {0};
+  plot_samples samples = {0};
+  plot_view view = {-5, 5, -10, 10, 3840, 2160};
+  int breaks = 0;
+
+  ck_assert_int_eq(s21_compile_expr("tan(x)", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_plot_sample(&compiled, view, 2000, &samples), PLOT_OK);
+  ck_assert_uint_le(samples.evals, 2000);
+  for (size_t i = 0; i < samples.count; i++) {
+    if (isnan(samples.y[i])) {
+      breaks++;
+      double pi = acos(-1);
+      ck_assert_double_lt(fabs(fmod(fabs(samples.x[i]), pi) - pi / 2), 0.01);
+    } else if (i) {
+      ck_assert_double_gt(samples.x[i], samples.x[i - 1]);
+    }
+  }
+  ck_assert_int_eq(breaks, 4);
+  s21_clear_plot_samples(&samples);
+  s21_clear_compiled(&compiled);
+
+  view = (plot_view){-1, 1, -5, 1, 800, 600};
+  ck_assert_int_eq(s21_compile_expr("log(x)", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_plot_sample(&compiled, view, PLOT_MAX_EVALS, &samples),
+                   PLOT_OK);
+  double first = INFINITY;
+  for (size_t i = 0; i < samples.count; i++) {
+    if (!isnan(samples.y[i]) && samples.x[i] < first) first = samples.x[i];
+  }
+  ck_assert_double_lt(first, 2.0 / 800);
+  s21_clear_plot_samples(&samples);
+  s21_clear_compiled(&compiled);
+}
+END_TEST
+
+START_TEST(test_plot_tiles) {
+  compiled_expr compiled = {0};
+  plot_tile_cache cache = {0};
+  plot_tile_key keys[16] = {0};
+  plot_tile_key panned[16] = {0};
+  plot_view view = {-3, 3, -2, 2, 600, 400};
+
+  ck_assert_int_eq(s21_compile_expr("sin(x)*x", &compiled), VALID_OK);
+  ck_assert_int_eq(s21_tile_cache_init(&cache, 0), PLOT_OK);
+  size_t count = s21_plot_tile_keys(view, keys, 16);
+  ck_assert_uint_ge(count, 3);
+  ck_assert_int_eq(keys[0].x_level, -7);
+  ck_assert_double_le(keys[0].index * s21_tile_width(keys[0].x_level), -3);
+
+  for (size_t i = 0; i < count; i++) {
+    plot_samples samples = {0};
+    ck_assert_int_eq(s21_plot_tile(&compiled, keys[i], &samples), PLOT_OK);
+    ck_assert_uint_le(samples.evals, PLOT_TILE_EVALS);
+    ck_assert_int_eq(s21_tile_cache_put(&cache, keys[i], &samples), PLOT_OK);
+    ck_assert_ptr_null(samples.x);
+  }
+  const plot_samples *first = s21_tile_cache_get(&cache, keys[0]);
+  const plot_samples *second = s21_tile_cache_get(&cache, keys[1]);
+  ck_assert_ptr_nonnull(first);
+  ck_assert_double_eq(first->x[first->count - 1], second->x[0]);
+  for (size_t i = 0; i < first->count; i++) {
+    ck_assert_double_eq_tol(first->y[i], sin(first->x[i]) * first->x[i],
+                            EPSILON);
+  }
+
+  view.x_min += 0.5;
+  view.x_max += 0.5;
+  view.y_min += 10;
+  view.y_max += 10;
+  size_t reused = 0;
+  size_t panned_count = s21_plot_tile_keys(view, panned, 16);
+  for (size_t i = 0; i < panned_count; i++) {
+    reused += s21_tile_cache_get(&cache, panned[i]) != NULL;
+  }
+  ck_assert_uint_ge(reused, panned_count - 1);
+
+  size_t limit = cache.bytes - 1;
+  s21_clear_tile_cache(&cache);
+  ck_assert_int_eq(s21_tile_cache_init(&cache, limit), PLOT_OK);
+  for (size_t i = 0; i < count; i++) {
+    plot_samples samples = {0};
+    s21_plot_tile(&compiled, keys[i], &samples);
+    s21_tile_cache_put(&cache, keys[i], &samples);
+    ck_assert_uint_le(cache.bytes, limit);
+  }
+  ck_assert_ptr_null(s21_tile_cache_get(&cache, keys[0]));
+  ck_assert_ptr_nonnull(s21_tile_cache_get(&cache, keys[count - 1]));
+  s21_clear_tile_cache(&cache);
+  s21_clear_compiled(&compiled);
+}
+END_TEST
+
+START_TEST(test_live_calc) {
+  const char *exprs[] = {"2+2*3/4^5", "2+(2*3/4)*cos(5)",
+                         "sin(-1)*(2+(2*3/4))*cos(5)/tan(0.5)",
+                         "3*(3*(4-2*5/3)+2*3/4)*(3*(3*(4-2*5/3)+2*3/4))"};
+  live_calc *calc = s21_create_live_calc();
+  ld res = 0;
+  ck_assert_ptr_nonnull(calc);
+
+  for (int i = 0; i < 4; i++) {
+    char text[2] = {0};
+    for (const char *c = exprs[i]; *c; c++) {
+      text[0] = *c;
+      ck_assert_int_eq(s21_live_append(calc, text), VALID_OK);
+    }
+    ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+    ck_assert_double_eq_tol(res, s21_smart_calc(exprs[i]), EPSILON);
+    s21_live_reset(calc);
+  }
+
+  s21_live_append(calc, "2*(3+4");
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 14, EPSILON);
+  s21_live_append(calc, ")^2");
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 98, EPSILON);
+  s21_live_append(calc, "*");
+  ck_assert_int_eq(s21_live_result(calc, &res), INVALID_EXPRESSION);
+  ck_assert_double_eq_tol(res, 98, EPSILON);
+  s21_live_append(calc, ")");
+  ck_assert_int_eq(s21_live_result(calc, &res), INVALID_EXPRESSION);
+  s21_live_backspace(calc);
+  s21_live_backspace(calc);
+  s21_live_backspace(calc);
+  s21_live_backspace(calc);
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 14, EPSILON);
+  s21_live_backspace(calc);
+  s21_live_backspace(calc);
+  ck_assert_int_eq(s21_live_result(calc, &res), INVALID_EXPRESSION);
+  s21_live_backspace(calc);
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 2 * 3, EPSILON);
+  ck_assert_str_eq(calc->expr, "2*(3");
+
+  s21_live_reset(calc);
+  s21_live_append(calc, "1569325041");
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq(res, BRACKETS_NOT_MATCH);
+  ck_assert_int_eq(s21_live_result(calc, NULL), NULL_PTR);
+
+  s21_live_reset(calc);
+  s21_live_append(calc, "sqrt(0-1)^0+1^log(0-1)");
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert(isnan(res));
+  ck_assert(isnan(s21_smart_calc("sqrt(0-1)^0+1^log(0-1)")));
+
+  s21_live_reset(calc);
+  const char *call = "2*sum(i, 1, 4, i*(1+0))";
+  for (const char *c = call; *c; c++) {
+    char text[2] = {*c, 0};
+    ck_assert_int_eq(s21_live_append(calc, text), VALID_OK);
+    if (c > call && c[1]) {
+      ck_assert_int_eq(s21_live_result(calc, &res), INVALID_EXPRESSION);
+    }
+  }
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 20, EPSILON);
+  ck_assert_int_eq(s21_live_append(calc, "+solve(t-3, t, 0, 5)"), VALID_OK);
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 23, EPSILON);
+  s21_live_backspace(calc);
+  ck_assert_int_eq(s21_live_result(calc, &res), INVALID_EXPRESSION);
+  ck_assert_int_eq(s21_live_append(calc, ")"), VALID_OK);
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 23, EPSILON);
+  ck_assert_int_eq(s21_live_append(calc, "-sum+1"), INVALID_EXPRESSION);
+  s21_live_reset(calc);
+  ck_assert_int_eq(s21_live_append(calc, "sum(i, 1, 2)"), INVALID_EXPRESSION);
+
+  s21_live_reset(calc);
+  ck_assert_int_eq(s21_live_append(calc, "sim("), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_live_append(calc, "1)"), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_live_result(calc, &res), UNKNOWN_FUNC);
+  for (int i = 0; i < 4; i++) s21_live_backspace(calc);
+  ck_assert_int_eq(s21_live_append(calc, "n(0)+1"), VALID_OK);
+  ck_assert_int_eq(s21_live_result(calc, &res), VALID_OK);
+  ck_assert_double_eq_tol(res, 1, EPSILON);
+  s21_clear_live_calc(calc);
+}
+END_TEST
+
+START_TEST(test_history) {
+  calc_history history;
+  history_entry entry = {0};
+  size_t ids[8] = {0};
+  remove("test_history.s21h");
+
+  ck_assert_int_eq(s21_history_open("test_history.s21h", &history),
+                   HISTORY_OK);
+  ck_assert_int_eq(s21_history_append(&history, "2+2", 4, 100), HISTORY_OK);
+  ck_assert_int_eq(s21_history_append(&history, "cos(1)*2", 1.0806, 101),
+                   HISTORY_OK);
+  ck_assert_int_eq(s21_history_append(&history, "3*cos(0)", 3, 102),
+                   HISTORY_OK);
+  ck_assert_uint_eq(s21_history_search(&history, "cos(", HISTORY_SUBSTRING,
+                                       ids, 8),
+                    2);
+  ck_assert_uint_eq(ids[0], 2);
+  ck_assert_uint_eq(ids[1], 1);
+  s21_history_close(&history);
+
+  ck_assert_int_eq(s21_history_open("test_history.s21h", &history),
+                   HISTORY_OK);
+  ck_assert_uint_eq(s21_history_count(&history), 3);
+  ck_assert_int_eq(s21_history_get(&history, 1, &entry), HISTORY_OK);
+  ck_assert_str_eq(entry.expr, "cos(1)*2");
+  ck_assert_double_eq(entry.result, 1.0806);
+  ck_assert_int_eq(entry.timestamp, 101);
+  ck_assert_uint_eq(s21_history_search(&history, "cos(", HISTORY_PREFIX, ids,
+                                       8),
+                    1);
+  ck_assert_uint_eq(ids[0], 1);
+  ck_assert_uint_eq(s21_history_search(&history, "2", HISTORY_SUBSTRING, ids,
+                                       8),
+                    2);
+  ck_assert_uint_eq(s21_history_search(&history, "", HISTORY_PREFIX, ids, 2),
+                    2);
+  ck_assert_uint_eq(ids[0], 2);
+
+  ck_assert_int_eq(s21_history_append(&history, "sin(cos(1))", 0.51, 103),
+                   HISTORY_OK);
+  ck_assert_uint_eq(s21_history_search(&history, "cos(1", HISTORY_SUBSTRING,
+                                       ids, 8),
+                    2);
+  ck_assert_uint_eq(ids[0], 3);
+  ck_assert_uint_eq(s21_history_search(&history, "tan(", HISTORY_SUBSTRING,
+                                       ids, 8),
+                    0);
+  s21_history_close(&history);
+
+  FILE *torn = fopen("test_history.s21h", "a");
+  fputs("torn", torn);
+  fclose(torn);
+  ck_assert_int_eq(s21_history_open("test_history.s21h", &history),
+                   HISTORY_OK);
+  ck_assert_uint_eq(s21_history_count(&history), 4);
+  ck_assert_int_eq(s21_history_append(&history, "5-1", 4, 104), HISTORY_OK);
+  ck_assert_int_eq(s21_history_append(&history, "6-1", 5, 105), HISTORY_OK);
+  ck_assert_uint_eq(s21_history_count(&history), 6);
+  s21_history_close(&history);
+
+  calc_history other;
+  ck_assert_int_eq(s21_history_open("test_history.s21h", &history),
+                   HISTORY_OK);
+  ck_assert_int_eq(s21_history_open("test_history.s21h", &other), HISTORY_OK);
+  ck_assert_uint_eq(s21_history_count(&history), 6);
+  ck_assert_int_eq(s21_history_append(&other, "7-1", 6, 106), HISTORY_OK);
+  ck_assert_int_eq(s21_history_append(&history, "8-1", 7, 107), HISTORY_OK);
+  ck_assert_uint_eq(s21_history_count(&history), 8);
+  ck_assert_uint_eq(s21_history_count(&other), 8);
+  ck_assert_int_eq(s21_history_get(&history, 6, &entry), HISTORY_OK);
+  ck_assert_str_eq(entry.expr, "7-1");
+  s21_history_close(&other);
+  s21_history_close(&history);
+
+  torn = fopen("test_history.s21h", "w");
+  fputs("S21X", torn);
+  fclose(torn);
+  ck_assert_int_eq(s21_history_open("test_history.s21h", &history),
+                   HISTORY_ERROR);
+  remove("test_history.s21h");
+}
+END_TEST
+
+START_TEST(test_protocol) {
+  char requests[3 * PROTO_MAX_FRAME] = {0};
+  char response[PROTO_MAX_FRAME] = {0};
+  double values[PROTO_MAX_VALUES] = {0};
+  proto_credit credit = {100000, 12, 10, 0, 0};
+  proto_deposit deposit = {100000, 12, 8, 13, 1, 0, 0, 1, 0};
+  size_t size = s21_proto_expr(requests, sizeof(requests), 7, "2+2*2");
+  size += s21_proto_credit(requests + size, sizeof(requests) - size, 8, credit);
+  size += s21_proto_deposit(requests + size, sizeof(requests) - size, 9,
+                            deposit);
+
+  proto_frame frame = {0};
+  ck_assert_int_eq(s21_proto_next(requests, 5, &frame), PROTO_INCOMPLETE);
+  ck_assert_int_eq(s21_proto_next(requests, size, &frame), PROTO_OK);
+  ck_assert_int_eq(frame.header.id, 7);
+  proto_frame reply = {0};
+  ck_assert_int_eq(s21_proto_next(response, s21_proto_execute(&frame, response),
+                                  &reply),
+                   PROTO_OK);
+  ck_assert_int_eq(reply.header.id, 7);
+  ck_assert_uint_eq(s21_proto_values(&reply, values), 1);
+  ck_assert_double_eq(values[0], 6);
+  ck_assert_int_eq(reply.header.status, PROTO_STATUS_OK);
+
+  char invalid[PROTO_MAX_FRAME] = {0};
+  s21_proto_expr(invalid, sizeof(invalid), 10, "2+(2");
+  s21_proto_next(invalid, sizeof(invalid), &frame);
+  s21_proto_next(response, s21_proto_execute(&frame, response), &reply);
+  ck_assert_int_eq(reply.header.status, PROTO_STATUS_INVALID_EXPR);
+  ck_assert_uint_eq(s21_proto_values(&reply, values), 1);
+  ck_assert_double_eq(values[0], BRACKETS_NOT_MATCH);
+  s21_proto_expr(invalid, sizeof(invalid), 11, "1569325041");
+  s21_proto_next(invalid, sizeof(invalid), &frame);
+  s21_proto_next(response, s21_proto_execute(&frame, response), &reply);
+  ck_assert_int_eq(reply.header.status, PROTO_STATUS_OK);
+  s21_proto_values(&reply, values);
+  ck_assert_double_eq(values[0], BRACKETS_NOT_MATCH);
+  s21_proto_next(requests, size, &frame);
+
+  size_t offset = frame.size;
+  ck_assert_int_eq(s21_proto_next(requests + offset, size - offset, &frame),
+                   PROTO_OK);
+  s21_proto_next(response, s21_proto_execute(&frame, response), &reply);
+  credit_data credit_res = s21_credit_calc(100000, 12, 10, 0);
+  ck_assert_uint_eq(s21_proto_values(&reply, values), 3);
+  ck_assert_double_eq(values[2], (double)credit_res.total_payment);
+
+  offset += frame.size;
+  ck_assert_int_eq(s21_proto_next(requests + offset, size - offset, &frame),
+                   PROTO_OK);
+  ck_assert_uint_eq(offset + frame.size, size);
+  s21_proto_next(response, s21_proto_execute(&frame, response), &reply);
+  deposit_data deposit_res = s21_deposit_calc(100000, 12, 8, 13, 1, 0, 0, 1);
+  ck_assert_uint_eq(s21_proto_values(&reply, values), 3);
+  ck_assert_double_eq(values[2], (double)deposit_res.dep_total);
+
+  proto_header header = {0};
+  memcpy(&header, requests, sizeof(header));
+  header.type = 42;
+  memcpy(requests, &header, sizeof(header));
+  s21_proto_next(requests, size, &frame);
+  s21_proto_next(response, s21_proto_execute(&frame, response), &reply);
+  ck_assert_int_eq(reply.header.status, PROTO_STATUS_BAD_REQUEST);
+  header.length = PROTO_MAX_BODY + 1;
+  memcpy(requests, &header, sizeof(header));
+  ck_assert_int_eq(s21_proto_next(requests, size, &frame), PROTO_ERROR);
+}
+END_TEST
+
+static void *s21_test_shm_server(void *channel) {
+  s21_shm_serve(channel, NULL);
+  return NULL;
+}
+
+START_TEST(test_shm_ring) {
+  shm_channel server;
+  shm_channel client;
+  pthread_t thread;
+  uint32_t square = 0;
+  uint32_t id = 0;
+  double res = 0;
+  ck_assert_int_eq(s21_shm_create("test_shm.s21r", &server), SHM_OK);
+  ck_assert_int_eq(s21_shm_attach("test_shm.s21r", &client), SHM_OK);
+  pthread_create(&thread, NULL, s21_test_shm_server, &server);
+
+  ck_assert_int_eq(s21_shm_register(&client, "x^2+1", &square), VALID_OK);
+  ck_assert_int_eq(s21_shm_register(&client, "foo(x)", &id), UNKNOWN_FUNC);
+  ck_assert_int_eq(s21_shm_register(&client, "1/x", &id), VALID_OK);
+  ck_assert_uint_eq(id, square + 1);
+  for (int i = 0; i < 3 * SHM_RING_SIZE; i++) {
+    ck_assert_int_eq(s21_shm_eval(&client, square, i, &res), VALID_OK);
+    ck_assert_double_eq(res, (double)i * i + 1);
+  }
+  ck_assert_int_eq(s21_shm_eval(&client, id, 0, &res), VALID_OK);
+  ck_assert(isnan(res));
+  ck_assert_int_eq(s21_shm_eval(&client, id + 1, 0, &res), NULL_PTR);
+
+  ck_assert_int_eq(s21_shm_stop(&client), SHM_OK);
+  pthread_join(thread, NULL);
+  s21_shm_detach(&client);
+  s21_shm_detach(&server);
+  remove("test_shm.s21r");
+}
+END_TEST
+
 Suite *s21_smart_calc_suite(void) {
   Suite *s;
   TCase *tc_core;
@@ -166,13 +1549,48 @@ Suite *s21_smart_calc_suite(void) {
   tcase_add_test(tc_core, test_invalid_expr2);
   tcase_add_test(tc_core, test_invalid_expr3);
   tcase_add_test(tc_core, test_invalid_expr4);
+  tcase_add_test(tc_core, test_calc_eval);
+  tcase_add_test(tc_core, test_parser);
+
+  tcase_add_test(tc_core, test_live_calc);
+  tcase_add_test(tc_core, test_compiled_expr);
+  tcase_add_test(tc_core, test_user_functions);
+  tcase_add_test(tc_core, test_expr_batch);
+  tcase_add_test(tc_core, test_aggregates);
+  tcase_add_test(tc_core, test_series_cancel);
+  tcase_add_test(tc_core, test_gradient);
+  tcase_add_test(tc_core, test_roots);
+  tcase_add_test(tc_core, test_fast_math);
+  tcase_add_test(tc_core, test_workbook);
+  tcase_add_test(tc_core, test_workbook_parallel);
+  tcase_add_test(tc_core, test_formula_file);
+  tcase_add_test(tc_core, test_plot_sample);
+  tcase_add_test(tc_core, test_plot_tiles);
 
   tcase_add_test(tc_core, test_credit_calc_annuint);
   tcase_add_test(tc_core, test_credit_calc_diff);
+  tcase_add_test(tc_core, test_credit_solve_rate);
+  tcase_add_test(tc_core, test_credit_solve_term_amount);
+  tcase_add_test(tc_core, test_credit_effective_apr);
+  tcase_add_test(tc_core, test_credit_solve_rate_batch);
+  tcase_add_test(tc_core, test_credit_schedule_plain);
+  tcase_add_test(tc_core, test_credit_schedule_prepay);
+  tcase_add_test(tc_core, test_credit_schedule_undo_redo);
+  tcase_add_test(tc_core, test_credit_calc_batch);
+  tcase_add_test(tc_core, test_loan_book_load);
+  tcase_add_test(tc_core, test_columnar_schedule);
+  tcase_add_test(tc_core, test_columnar_batch);
+  tcase_add_test(tc_core, test_history);
+  tcase_add_test(tc_core, test_protocol);
+  tcase_add_test(tc_core, test_shm_ring);
 
   tcase_add_test(tc_core, test_deposit_calc_no_cap);
   tcase_add_test(tc_core, test_deposit_calc_cap);
 
+  tcase_add_test(tc_core, test_philox_known_answer);
+  tcase_add_test(tc_core, test_quantile_sketch);
+  tcase_add_test(tc_core, test_monte_carlo);
+
   suite_add_tcase(s, tc_core);
 
   return s;